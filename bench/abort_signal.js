@@ -0,0 +1,83 @@
+const COUNT = 1000000;
+const DELAY = 50;
+const SPREAD = 1000;
+
+function waitAbort(signal) {
+    return new Promise((resolve) => {
+        signal.addEventListener('abort', () => resolve());
+    });
+}
+
+function pad(value, width) {
+    return String(value).padStart(width);
+}
+
+function report(name, createMs, totalMs) {
+    const perSec = createMs > 0 ? (COUNT * 1000 / createMs).toFixed(0) : 'inf';
+    console.log(`${name.padEnd(34)}${pad(perSec, 12)}${pad(createMs, 10)}${pad(totalMs, 10)}`);
+}
+
+async function timeoutSameDelay() {
+    const start = Date.now();
+    let last = null;
+    for (let i = 0; i < COUNT; i++) {
+        last = AbortSignal.timeout(DELAY);
+    }
+    const created = Date.now();
+    await waitAbort(last);
+    report('AbortSignal.timeout, same delay', created - start, Date.now() - start);
+}
+
+async function timeoutSpreadDelay() {
+    const start = Date.now();
+    for (let i = 0; i < COUNT; i++) {
+        AbortSignal.timeout(DELAY + i % SPREAD);
+    }
+    const created = Date.now();
+    await waitAbort(AbortSignal.timeout(DELAY + SPREAD));
+    report(`AbortSignal.timeout, ${SPREAD} delays`, created - start, Date.now() - start);
+}
+
+async function setTimeoutAbort() {
+    const start = Date.now();
+    let last = null;
+    for (let i = 0; i < COUNT; i++) {
+        const controller = new AbortController();
+        setTimeout(() => controller.abort(), DELAY);
+        last = controller.signal;
+    }
+    const created = Date.now();
+    await waitAbort(last);
+    report('setTimeout + AbortController', created - start, Date.now() - start);
+}
+
+function controllerAbort() {
+    const start = Date.now();
+    for (let i = 0; i < COUNT; i++) {
+        new AbortController().abort();
+    }
+    const elapsed = Date.now() - start;
+    report('AbortController create + abort', elapsed, elapsed);
+}
+
+function anyAbort() {
+    const start = Date.now();
+    const shared = new AbortController();
+    for (let i = 0; i < COUNT; i++) {
+        const controller = new AbortController();
+        AbortSignal.any([controller.signal, shared.signal]);
+        controller.abort();
+    }
+    const elapsed = Date.now() - start;
+    report('AbortSignal.any + abort source', elapsed, elapsed);
+}
+
+(async () => {
+    console.log(`${COUNT} signals per case`);
+    console.log(`${'case'.padEnd(34)}${pad('created/s', 12)}${pad('create ms', 10)}${pad('total ms', 10)}`);
+    await timeoutSameDelay();
+    await timeoutSpreadDelay();
+    await setTimeoutAbort();
+    controllerAbort();
+    anyAbort();
+})();
@@ -0,0 +1,42 @@
+const MODULE_COUNT = 300;
+
+function moduleSource(index) {
+    const children = [2 * index + 1, 2 * index + 2].filter((child) => child < MODULE_COUNT);
+    let source = '';
+    for (const child of children) {
+        source += `import { value as value${child} } from './m${child}.js';\n`;
+    }
+    if (index === 0) {
+        source += `import config from './config.json' with { type: 'json' };\n`;
+    }
+    source += `function compute${index}(x) {\n`;
+    source += `    let total = x;\n`;
+    source += `    for (let i = 0; i < ${index % 7 + 1}; i++) {\n`;
+    source += `        total = (total * 31 + i) % 1000003;\n`;
+    source += `    }\n`;
+    source += `    return total;\n`;
+    source += `}\n`;
+    const sum = children.map((child) => `value${child}`).concat([`compute${index}(${index})`]);
+    source += `export const value = ${sum.join(' + ')};\n`;
+    if (index === 0) {
+        source += `console.log(config.name, value);\n`;
+    }
+    return source;
+}
+
+(async () => {
+    const url = await import.meta.resolve('./app/main.js');
+    const mainPath = url.slice('file://'.length);
+    const dir = mainPath.slice(0, mainPath.lastIndexOf('/'));
+    await Kun.fs.mkdir(dir).catch(() => {});
+    const config = { name: 'cold-start', routes: [] };
+    for (let i = 0; i < 200; i++) {
+        config.routes.push({ path: `/api/v1/items/${i}`, method: i % 2 ? 'GET' : 'POST' });
+    }
+    await Kun.fs.writeFile(`${dir}/config.json`, JSON.stringify(config));
+    for (let i = 1; i < MODULE_COUNT; i++) {
+        await Kun.fs.writeFile(`${dir}/m${i}.js`, moduleSource(i));
+    }
+    await Kun.fs.writeFile(mainPath, moduleSource(0));
+    console.log(`Generated ${MODULE_COUNT} modules in '${dir}'`);
+})();
@@ -0,0 +1,25 @@
+const LINES = 200000;
+
+const cases = [
+    ['short string', () => console.log('GET /index.html 200')],
+    ['three arguments', (i) => console.log('request', i, 'done')],
+    ['object', (i) => console.log({ id: i, path: '/api/items', ok: true })]
+];
+
+function runCase(index) {
+    if (index === cases.length) {
+        return;
+    }
+    const [name, log] = cases[index];
+    const start = Date.now();
+    for (let i = 0; i < LINES; i++) {
+        log(i);
+    }
+    setTimeout(() => {
+        const elapsed = Math.max(Date.now() - start, 1);
+        console.error(`${name.padEnd(18)}${String((LINES * 1000 / elapsed).toFixed(0)).padStart(12)} lines/s`);
+        runCase(index + 1);
+    }, 0);
+}
+
+runCase(0);
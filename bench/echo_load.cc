@@ -0,0 +1,363 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+class Options {
+public:
+    std::string host{"127.0.0.1"};
+    std::string port{"9000"};
+    int connections{64};
+    int threads{2};
+    int seconds{10};
+    int size{64};
+};
+
+class Stats {
+public:
+    uint64_t messages{0};
+    uint64_t errors{0};
+    std::vector<uint32_t> latencies;
+};
+
+class Connection {
+public:
+    int fd{-1};
+    bool connecting{false};
+    size_t written{0};
+    size_t received{0};
+    Clock::time_point sendTime;
+};
+
+uint64_t toMicroseconds(Clock::duration duration) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count()
+    );
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        int* target = nullptr;
+        if (arg == "-c") {
+            target = &options.connections;
+        } else if (arg == "-t") {
+            target = &options.threads;
+        } else if (arg == "-d") {
+            target = &options.seconds;
+        } else if (arg == "-s") {
+            target = &options.size;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            auto colon = arg.rfind(':');
+            if (colon == std::string::npos || colon == 0 || colon + 1 == arg.size()) {
+                return false;
+            }
+            options.host = arg.substr(0, colon);
+            options.port = arg.substr(colon + 1);
+            continue;
+        }
+        if (++i >= argc) {
+            return false;
+        }
+        *target = atoi(argv[i]);
+        if (*target <= 0) {
+            return false;
+        }
+    }
+    if (options.threads > options.connections) {
+        options.threads = options.connections;
+    }
+    return true;
+}
+
+class Worker {
+public:
+    Worker(const Worker&) = delete;
+
+    Worker& operator=(const Worker&) = delete;
+
+    Worker(Worker&&) = delete;
+
+    Worker& operator=(Worker&&) = delete;
+
+    Worker(const Options& options, const struct addrinfo* addr, int connCount) :
+        options(options),
+        addr(addr),
+        conns(connCount),
+        message(static_cast<size_t>(options.size), 'x'),
+        readBuffer(static_cast<size_t>(options.size))
+    {
+
+    }
+
+    ~Worker() {
+        for (auto& conn : conns) {
+            closeConn(conn);
+        }
+    }
+
+    void run(Clock::time_point deadline);
+
+    Stats stats;
+
+private:
+    void openConn(Connection& conn);
+
+    void closeConn(Connection& conn);
+
+    bool writeConn(Connection& conn);
+
+    bool readConn(Connection& conn);
+
+    const Options& options;
+    const struct addrinfo* addr;
+    std::vector<Connection> conns;
+    std::string message;
+    std::vector<char> readBuffer;
+};
+
+void Worker::openConn(Connection& conn) {
+    conn.written = 0;
+    conn.received = 0;
+    conn.fd = ::socket(addr->ai_family, SOCK_STREAM, 0);
+    if (conn.fd == -1) {
+        stats.errors++;
+        return;
+    }
+    auto flags = ::fcntl(conn.fd, F_GETFL, 0);
+    ::fcntl(conn.fd, F_SETFL, flags | O_NONBLOCK);
+    int one = 1;
+    ::setsockopt(conn.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (::connect(conn.fd, addr->ai_addr, addr->ai_addrlen) == -1 && errno != EINPROGRESS) {
+        stats.errors++;
+        closeConn(conn);
+        return;
+    }
+    conn.connecting = true;
+    conn.sendTime = Clock::now();
+}
+
+void Worker::closeConn(Connection& conn) {
+    if (conn.fd != -1) {
+        ::close(conn.fd);
+        conn.fd = -1;
+    }
+    conn.connecting = false;
+}
+
+bool Worker::writeConn(Connection& conn) {
+    while (conn.written < message.size()) {
+        auto rc = ::send(
+            conn.fd,
+            message.data() + conn.written,
+            message.size() - conn.written,
+            SEND_FLAGS
+        );
+        if (rc > 0) {
+            conn.written += static_cast<size_t>(rc);
+            continue;
+        }
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        return rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    return true;
+}
+
+bool Worker::readConn(Connection& conn) {
+    while (true) {
+        auto rc = ::read(conn.fd, readBuffer.data(), readBuffer.size() - conn.received);
+        if (rc > 0) {
+            conn.received += static_cast<size_t>(rc);
+            if (conn.received < message.size()) {
+                continue;
+            }
+            if (conn.written < message.size()) {
+                return false;
+            }
+            auto now = Clock::now();
+            stats.messages++;
+            stats.latencies.push_back(static_cast<uint32_t>(toMicroseconds(now - conn.sendTime)));
+            conn.written = 0;
+            conn.received = 0;
+            conn.sendTime = now;
+            if (!writeConn(conn)) {
+                return false;
+            }
+            continue;
+        }
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        return rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+void Worker::run(Clock::time_point deadline) {
+    for (auto& conn : conns) {
+        openConn(conn);
+    }
+    std::vector<struct pollfd> pollfds(conns.size());
+    while (Clock::now() < deadline) {
+        for (size_t i = 0; i < conns.size(); i++) {
+            auto& conn = conns[i];
+            if (conn.fd == -1) {
+                openConn(conn);
+            }
+            pollfds[i].fd = conn.fd;
+            pollfds[i].events = POLLIN;
+            if (conn.connecting || conn.written < message.size()) {
+                pollfds[i].events |= POLLOUT;
+            }
+            pollfds[i].revents = 0;
+        }
+        auto rc = ::poll(pollfds.data(), static_cast<nfds_t>(pollfds.size()), 100);
+        if (rc <= 0) {
+            continue;
+        }
+        for (size_t i = 0; i < conns.size(); i++) {
+            auto& conn = conns[i];
+            auto revents = pollfds[i].revents;
+            if (conn.fd == -1 || revents == 0) {
+                continue;
+            }
+            if (conn.connecting) {
+                int errCode = 0;
+                socklen_t errLen = sizeof(errCode);
+                ::getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &errCode, &errLen);
+                if (errCode != 0) {
+                    stats.errors++;
+                    closeConn(conn);
+                    continue;
+                }
+                conn.connecting = false;
+                conn.sendTime = Clock::now();
+            }
+            if (
+                ((revents & POLLOUT) && !writeConn(conn)) ||
+                ((revents & (POLLIN | POLLERR | POLLHUP)) && !readConn(conn))
+            ) {
+                stats.errors++;
+                closeConn(conn);
+            }
+        }
+    }
+}
+
+double toMillisecond(uint32_t us) {
+    return static_cast<double>(us) / 1000;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(
+            stderr,
+            "Usage: %s [-c connections] [-t threads] [-d seconds] [-s message-size] [host:port]\n",
+            argv[0]
+        );
+        return 1;
+    }
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addrs = nullptr;
+    auto rc = ::getaddrinfo(options.host.c_str(), options.port.c_str(), &hints, &addrs);
+    if (rc != 0) {
+        fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(rc));
+        return 1;
+    }
+    printf(
+        "Running %ds echo test @ %s:%s\n",
+        options.seconds, options.host.c_str(), options.port.c_str()
+    );
+    printf(
+        "  %d threads and %d connections, %d byte messages\n",
+        options.threads, options.connections, options.size
+    );
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < options.threads; i++) {
+        auto connCount = options.connections / options.threads;
+        if (i < options.connections % options.threads) {
+            connCount++;
+        }
+        workers.emplace_back(std::make_unique<Worker>(options, addrs, connCount));
+    }
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(options.seconds);
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, deadline]() {
+            worker->run(deadline);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = static_cast<double>(toMicroseconds(Clock::now() - start)) / 1000000;
+    Stats total;
+    for (auto& worker : workers) {
+        const auto& stats = worker->stats;
+        total.messages += stats.messages;
+        total.errors += stats.errors;
+        total.latencies.insert(total.latencies.end(), stats.latencies.begin(), stats.latencies.end());
+    }
+    workers.clear();
+    ::freeaddrinfo(addrs);
+    auto& latencies = total.latencies;
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        uint64_t sum = 0;
+        for (auto latency : latencies) {
+            sum += latency;
+        }
+        auto percentile = [&latencies](double p) {
+            auto index = static_cast<size_t>(p * static_cast<double>(latencies.size() - 1));
+            return toMillisecond(latencies[index]);
+        };
+        printf(
+            "  Latency avg %.3fms p50 %.3fms p90 %.3fms p99 %.3fms max %.3fms\n",
+            static_cast<double>(sum) / static_cast<double>(latencies.size()) / 1000,
+            percentile(0.5), percentile(0.9), percentile(0.99),
+            toMillisecond(latencies.back())
+        );
+    }
+    printf("  %llu round trips in %.2fs\n", static_cast<unsigned long long>(total.messages), elapsed);
+    if (total.errors > 0) {
+        printf("  Socket errors: %llu\n", static_cast<unsigned long long>(total.errors));
+    }
+    printf("Requests/sec: %.2f\n", static_cast<double>(total.messages) / elapsed);
+    return 0;
+}
@@ -0,0 +1,22 @@
+const listener = Kun.net.listen({ hostname: '127.0.0.1', port: 9000 });
+const { hostname, port } = listener.addr;
+console.log(`Echo server listening on ${hostname}:${port}`);
+
+async function serve(conn) {
+    const buf = new Uint8Array(64 * 1024);
+    while (true) {
+        const n = await conn.read(buf);
+        if (n === null) {
+            break;
+        }
+        await conn.write(buf.subarray(0, n));
+    }
+    conn.close();
+}
+
+(async () => {
+    while (true) {
+        const conn = await listener.accept();
+        serve(conn).catch(() => conn.close());
+    }
+})();
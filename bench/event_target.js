@@ -0,0 +1,62 @@
+const LISTENER_COUNTS = [1, 10, 100, 1000];
+const MIN_DURATION = 500;
+
+function measure(fn) {
+    let iterations = 1;
+    while (true) {
+        const start = Date.now();
+        for (let i = 0; i < iterations; i++) {
+            fn();
+        }
+        const elapsed = Date.now() - start;
+        if (elapsed >= MIN_DURATION) {
+            return iterations * 1000 / elapsed;
+        }
+        iterations *= elapsed > 0 ? Math.ceil(MIN_DURATION * 1.2 / elapsed) : 8;
+    }
+}
+
+function pad(value, width) {
+    return String(value).padStart(width);
+}
+
+let calls = 0;
+function onEvent() {
+    calls++;
+}
+
+function createTarget(count) {
+    const target = new EventTarget();
+    for (let i = 0; i < count; i++) {
+        target.addEventListener('message', function () {
+            calls++;
+        });
+    }
+    for (const type of ['open', 'close', 'error', 'abort']) {
+        target.addEventListener(type, onEvent);
+    }
+    return target;
+}
+
+console.log(
+    `${pad('listeners', 10)}${pad('dispatch/s', 14)}${pad('calls/s', 14)}${pad('once/s', 14)}`
+);
+for (const count of LISTENER_COUNTS) {
+    const target = createTarget(count);
+    const event = new Event('message');
+    const dispatches = measure(() => target.dispatchEvent(event));
+    const onceTarget = createTarget(0);
+    const once = measure(() => {
+        for (let i = 0; i < count; i++) {
+            onceTarget.addEventListener('message', onEvent, { once: true });
+        }
+        onceTarget.dispatchEvent(new Event('message'));
+    });
+    console.log(
+        `${pad(count, 10)}${pad(dispatches.toFixed(0), 14)}` +
+        `${pad((dispatches * count).toFixed(0), 14)}${pad(once.toFixed(0), 14)}`
+    );
+}
+if (calls === 0) {
+    throw new Error('no listener ran');
+}
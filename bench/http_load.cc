@@ -0,0 +1,513 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+constexpr size_t READ_SIZE = 64 * 1024;
+
+using Clock = std::chrono::steady_clock;
+
+class Options {
+public:
+    std::string host{"127.0.0.1"};
+    std::string port{"8000"};
+    std::string path{"/"};
+    int connections{64};
+    int threads{2};
+    int pipeline{1};
+    int seconds{10};
+};
+
+class Stats {
+public:
+    uint64_t requests{0};
+    uint64_t bytes{0};
+    uint64_t non2xx{0};
+    uint64_t connectErrors{0};
+    uint64_t readErrors{0};
+    uint64_t writeErrors{0};
+    std::vector<uint32_t> latencies;
+};
+
+class Connection {
+public:
+    int fd{-1};
+    bool connecting{false};
+    std::string readBuffer;
+    size_t writeOffset{0};
+    std::string writeBuffer;
+    std::deque<Clock::time_point> sendTimes;
+};
+
+uint64_t toMicroseconds(Clock::duration duration) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count()
+    );
+}
+
+bool parseUrl(const std::string& url, Options& options) {
+    const std::string scheme("http://");
+    if (url.compare(0, scheme.length(), scheme) != 0) {
+        return false;
+    }
+    auto rest = url.substr(scheme.length());
+    auto slash = rest.find('/');
+    auto authority = rest.substr(0, slash);
+    options.path = slash == std::string::npos ? "/" : rest.substr(slash);
+    auto colon = authority.rfind(':');
+    auto bracket = authority.rfind(']');
+    if (colon != std::string::npos && (bracket == std::string::npos || bracket < colon)) {
+        options.host = authority.substr(0, colon);
+        options.port = authority.substr(colon + 1);
+    } else {
+        options.host = authority;
+        options.port = "80";
+    }
+    if (options.host.size() > 2 && options.host.front() == '[' && options.host.back() == ']') {
+        options.host = options.host.substr(1, options.host.size() - 2);
+    }
+    return !options.host.empty() && !options.port.empty();
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    bool hasUrl = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        int* target = nullptr;
+        if (arg == "-c") {
+            target = &options.connections;
+        } else if (arg == "-t") {
+            target = &options.threads;
+        } else if (arg == "-d") {
+            target = &options.seconds;
+        } else if (arg == "-p") {
+            target = &options.pipeline;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            if (!parseUrl(arg, options)) {
+                return false;
+            }
+            hasUrl = true;
+            continue;
+        }
+        if (++i >= argc) {
+            return false;
+        }
+        *target = atoi(argv[i]);
+        if (*target <= 0) {
+            return false;
+        }
+    }
+    if (options.threads > options.connections) {
+        options.threads = options.connections;
+    }
+    return hasUrl;
+}
+
+bool findContentLength(const char* head, size_t len, size_t& contentLength) {
+    const char name[] = "\r\ncontent-length:";
+    const size_t nameLen = sizeof(name) - 1;
+    for (size_t i = 0; i + nameLen <= len; i++) {
+        if (strncasecmp(head + i, name, nameLen) != 0) {
+            continue;
+        }
+        auto p = head + i + nameLen;
+        auto end = head + len;
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            p++;
+        }
+        size_t value = 0;
+        auto digits = p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value = value * 10 + static_cast<size_t>(*p - '0');
+            p++;
+        }
+        if (p == digits) {
+            return false;
+        }
+        contentLength = value;
+        return true;
+    }
+    contentLength = 0;
+    return true;
+}
+
+class Worker {
+public:
+    Worker(const Worker&) = delete;
+
+    Worker& operator=(const Worker&) = delete;
+
+    Worker(Worker&&) = delete;
+
+    Worker& operator=(Worker&&) = delete;
+
+    Worker(const Options& options, const struct addrinfo* addr, int connCount) :
+        options(options),
+        addr(addr),
+        conns(connCount)
+    {
+        request = "GET " + options.path + " HTTP/1.1\r\nHost: " + options.host;
+        request += "\r\nUser-Agent: http_load\r\n\r\n";
+    }
+
+    ~Worker() {
+        for (auto& conn : conns) {
+            closeConn(conn);
+        }
+    }
+
+    void run(Clock::time_point deadline, const std::atomic<bool>& stopped);
+
+    Stats stats;
+
+private:
+    void openConn(Connection& conn);
+
+    void closeConn(Connection& conn);
+
+    void reconnect(Connection& conn);
+
+    void sendRequests(Connection& conn, int count);
+
+    bool flushConn(Connection& conn);
+
+    bool readConn(Connection& conn);
+
+    bool parseResponses(Connection& conn);
+
+    const Options& options;
+    const struct addrinfo* addr;
+    std::vector<Connection> conns;
+    std::string request;
+};
+
+void Worker::openConn(Connection& conn) {
+    conn.readBuffer.clear();
+    conn.writeBuffer.clear();
+    conn.writeOffset = 0;
+    conn.sendTimes.clear();
+    conn.fd = ::socket(addr->ai_family, SOCK_STREAM, 0);
+    if (conn.fd == -1) {
+        stats.connectErrors++;
+        return;
+    }
+    auto flags = ::fcntl(conn.fd, F_GETFL, 0);
+    ::fcntl(conn.fd, F_SETFL, flags | O_NONBLOCK);
+    int one = 1;
+    ::setsockopt(conn.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (::connect(conn.fd, addr->ai_addr, addr->ai_addrlen) == -1 && errno != EINPROGRESS) {
+        stats.connectErrors++;
+        closeConn(conn);
+        return;
+    }
+    conn.connecting = true;
+    sendRequests(conn, options.pipeline);
+}
+
+void Worker::closeConn(Connection& conn) {
+    if (conn.fd != -1) {
+        ::close(conn.fd);
+        conn.fd = -1;
+    }
+    conn.connecting = false;
+}
+
+void Worker::reconnect(Connection& conn) {
+    closeConn(conn);
+    openConn(conn);
+}
+
+void Worker::sendRequests(Connection& conn, int count) {
+    auto now = Clock::now();
+    for (int i = 0; i < count; i++) {
+        conn.writeBuffer += request;
+        conn.sendTimes.push_back(now);
+    }
+}
+
+bool Worker::flushConn(Connection& conn) {
+    while (conn.writeOffset < conn.writeBuffer.size()) {
+        auto rc = ::send(
+            conn.fd,
+            conn.writeBuffer.data() + conn.writeOffset,
+            conn.writeBuffer.size() - conn.writeOffset,
+            SEND_FLAGS
+        );
+        if (rc > 0) {
+            conn.writeOffset += static_cast<size_t>(rc);
+            continue;
+        }
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        if (rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        return false;
+    }
+    conn.writeBuffer.clear();
+    conn.writeOffset = 0;
+    return true;
+}
+
+bool Worker::readConn(Connection& conn) {
+    char buf[READ_SIZE];
+    while (true) {
+        auto rc = ::read(conn.fd, buf, sizeof(buf));
+        if (rc > 0) {
+            stats.bytes += static_cast<uint64_t>(rc);
+            conn.readBuffer.append(buf, static_cast<size_t>(rc));
+            continue;
+        }
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        if (rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return parseResponses(conn);
+        }
+        return false;
+    }
+}
+
+bool Worker::parseResponses(Connection& conn) {
+    size_t offset = 0;
+    int completed = 0;
+    auto now = Clock::now();
+    while (true) {
+        auto head = conn.readBuffer.data() + offset;
+        auto len = conn.readBuffer.size() - offset;
+        auto headEnd = static_cast<const char*>(memmem(head, len, "\r\n\r\n", 4));
+        if (headEnd == nullptr) {
+            break;
+        }
+        auto headLength = static_cast<size_t>(headEnd - head) + 4;
+        size_t contentLength = 0;
+        if (len < 12 || !findContentLength(head, headLength, contentLength)) {
+            return false;
+        }
+        if (len - headLength < contentLength) {
+            break;
+        }
+        if (conn.sendTimes.empty()) {
+            return false;
+        }
+        if (head[9] != '2') {
+            stats.non2xx++;
+        }
+        stats.requests++;
+        stats.latencies.push_back(
+            static_cast<uint32_t>(toMicroseconds(now - conn.sendTimes.front()))
+        );
+        conn.sendTimes.pop_front();
+        offset += headLength + contentLength;
+        completed++;
+    }
+    if (offset > 0) {
+        conn.readBuffer.erase(0, offset);
+    }
+    if (completed > 0) {
+        sendRequests(conn, completed);
+    }
+    return true;
+}
+
+void Worker::run(Clock::time_point deadline, const std::atomic<bool>& stopped) {
+    for (auto& conn : conns) {
+        openConn(conn);
+    }
+    std::vector<struct pollfd> pollfds(conns.size());
+    while (!stopped.load(std::memory_order_relaxed) && Clock::now() < deadline) {
+        for (size_t i = 0; i < conns.size(); i++) {
+            auto& conn = conns[i];
+            if (conn.fd == -1) {
+                openConn(conn);
+            }
+            pollfds[i].fd = conn.fd;
+            pollfds[i].events = POLLIN;
+            if (conn.connecting || !conn.writeBuffer.empty()) {
+                pollfds[i].events |= POLLOUT;
+            }
+            pollfds[i].revents = 0;
+        }
+        auto rc = ::poll(pollfds.data(), static_cast<nfds_t>(pollfds.size()), 100);
+        if (rc <= 0) {
+            continue;
+        }
+        for (size_t i = 0; i < conns.size(); i++) {
+            auto& conn = conns[i];
+            auto revents = pollfds[i].revents;
+            if (conn.fd == -1 || revents == 0) {
+                continue;
+            }
+            if (conn.connecting && (revents & (POLLOUT | POLLERR | POLLHUP))) {
+                int errCode = 0;
+                socklen_t errLen = sizeof(errCode);
+                ::getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &errCode, &errLen);
+                if (errCode != 0) {
+                    stats.connectErrors++;
+                    reconnect(conn);
+                    continue;
+                }
+                conn.connecting = false;
+            }
+            if ((revents & POLLOUT) && !flushConn(conn)) {
+                stats.writeErrors++;
+                reconnect(conn);
+                continue;
+            }
+            if ((revents & (POLLIN | POLLERR | POLLHUP)) && !readConn(conn)) {
+                stats.readErrors++;
+                reconnect(conn);
+                continue;
+            }
+            if (!conn.writeBuffer.empty() && !flushConn(conn)) {
+                stats.writeErrors++;
+                reconnect(conn);
+            }
+        }
+    }
+}
+
+double toMillisecond(uint32_t us) {
+    return static_cast<double>(us) / 1000;
+}
+
+void printSize(const char* label, double bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB"};
+    int unit = 0;
+    while (bytes >= 1024 && unit < 3) {
+        bytes /= 1024;
+        unit++;
+    }
+    printf("%s%.2f%s", label, bytes, units[unit]);
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(
+            stderr,
+            "Usage: %s [-c connections] [-t threads] [-d seconds] [-p pipeline] http://host:port/path\n",
+            argv[0]
+        );
+        return 1;
+    }
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addrs = nullptr;
+    auto rc = ::getaddrinfo(options.host.c_str(), options.port.c_str(), &hints, &addrs);
+    if (rc != 0) {
+        fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(rc));
+        return 1;
+    }
+    printf(
+        "Running %ds test @ http://%s:%s%s\n",
+        options.seconds, options.host.c_str(), options.port.c_str(), options.path.c_str()
+    );
+    printf(
+        "  %d threads and %d connections, pipeline %d\n",
+        options.threads, options.connections, options.pipeline
+    );
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < options.threads; i++) {
+        auto connCount = options.connections / options.threads;
+        if (i < options.connections % options.threads) {
+            connCount++;
+        }
+        workers.emplace_back(std::make_unique<Worker>(options, addrs, connCount));
+    }
+    std::atomic<bool> stopped{false};
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(options.seconds);
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, deadline, &stopped]() {
+            worker->run(deadline, stopped);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = static_cast<double>(toMicroseconds(Clock::now() - start)) / 1000000;
+    Stats total;
+    for (auto& worker : workers) {
+        const auto& stats = worker->stats;
+        total.requests += stats.requests;
+        total.bytes += stats.bytes;
+        total.non2xx += stats.non2xx;
+        total.connectErrors += stats.connectErrors;
+        total.readErrors += stats.readErrors;
+        total.writeErrors += stats.writeErrors;
+        total.latencies.insert(total.latencies.end(), stats.latencies.begin(), stats.latencies.end());
+    }
+    workers.clear();
+    ::freeaddrinfo(addrs);
+    auto& latencies = total.latencies;
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        uint64_t sum = 0;
+        for (auto latency : latencies) {
+            sum += latency;
+        }
+        auto percentile = [&latencies](double p) {
+            auto index = static_cast<size_t>(p * static_cast<double>(latencies.size() - 1));
+            return toMillisecond(latencies[index]);
+        };
+        printf(
+            "  Latency avg %.3fms p50 %.3fms p90 %.3fms p99 %.3fms max %.3fms\n",
+            static_cast<double>(sum) / static_cast<double>(latencies.size()) / 1000,
+            percentile(0.5), percentile(0.9), percentile(0.99),
+            toMillisecond(latencies.back())
+        );
+    }
+    printf("  %llu requests in %.2fs, ", static_cast<unsigned long long>(total.requests), elapsed);
+    printSize("", static_cast<double>(total.bytes));
+    printf(" read\n");
+    if (total.non2xx > 0) {
+        printf("  Non-2xx responses: %llu\n", static_cast<unsigned long long>(total.non2xx));
+    }
+    if (total.connectErrors + total.readErrors + total.writeErrors > 0) {
+        printf(
+            "  Socket errors: connect %llu, read %llu, write %llu\n",
+            static_cast<unsigned long long>(total.connectErrors),
+            static_cast<unsigned long long>(total.readErrors),
+            static_cast<unsigned long long>(total.writeErrors)
+        );
+    }
+    printf("Requests/sec: %.2f\n", static_cast<double>(total.requests) / elapsed);
+    printSize("Transfer/sec: ", static_cast<double>(total.bytes) / elapsed);
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,55 @@
+const MODULE_COUNT = 50;
+const TARGET_SIZE = 10 * 1024 * 1024;
+
+function makeData() {
+    const items = [];
+    let size = 0;
+    for (let i = 0; size < TARGET_SIZE; i++) {
+        const item = {
+            id: i,
+            name: `item-${i}`,
+            price: (i % 1000) / 10,
+            tags: ['a', 'b', `t${i % 10}`],
+            active: i % 2 === 0
+        };
+        size += JSON.stringify(item).length + 1;
+        items.push(item);
+    }
+    return JSON.stringify({ items });
+}
+
+(async () => {
+    const url = await import.meta.resolve('./json_modules/data.json');
+    const dataPath = url.slice('file://'.length);
+    const dir = dataPath.slice(0, dataPath.lastIndexOf('/'));
+    await Kun.fs.mkdir(dir).catch(() => {});
+    const json = makeData();
+    await Kun.fs.writeFile(dataPath, json);
+    const specifiers = [];
+    for (let i = 0; i < MODULE_COUNT; i++) {
+        const source =
+            `import data from './data.json' with { type: 'json' };\n` +
+            `export { data };\n` +
+            `export const count = data.items.length;\n`;
+        await Kun.fs.writeFile(`${dir}/m${i}.js`, source);
+        specifiers.push(`./json_modules/m${i}.js`);
+    }
+    const sizeMB = (json.length / 1048576).toFixed(1);
+    console.log(`${MODULE_COUNT} modules importing one ${sizeMB}MB JSON file`);
+
+    let start = Date.now();
+    const modules = await Promise.all(specifiers.map((specifier) => import(specifier)));
+    const importMs = Date.now() - start;
+    const shared = modules.every((mod) => mod.data === modules[0].data);
+    if (modules.some((mod) => mod.count !== modules[0].count)) {
+        throw new Error('modules disagree on the item count');
+    }
+    console.log(`  ${'import() x' + MODULE_COUNT}`.padEnd(32) + `${importMs}ms, shared value: ${shared}`);
+
+    start = Date.now();
+    for (let i = 0; i < MODULE_COUNT; i++) {
+        JSON.parse(await Kun.fs.readTextFile(dataPath));
+    }
+    const parseMs = Date.now() - start;
+    console.log(`  ${'readTextFile + parse x' + MODULE_COUNT}`.padEnd(32) + `${parseMs}ms`);
+})();
@@ -0,0 +1,162 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "util/mpsc_queue.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class Completion {
+public:
+    Completion(const Completion&) = delete;
+
+    Completion& operator=(const Completion&) = delete;
+
+    Completion(Completion&& completion) noexcept : value(completion.value) {
+        memcpy(data, completion.data, sizeof(data));
+    }
+
+    Completion& operator=(Completion&& completion) noexcept {
+        value = completion.value;
+        memcpy(data, completion.data, sizeof(data));
+        return *this;
+    }
+
+    explicit Completion(uint64_t value) : value(value) {
+        memset(data, 0, sizeof(data));
+    }
+
+    ~Completion() = default;
+
+    uint64_t value;
+    uint64_t data[7];
+};
+
+class RingQueue {
+public:
+    void push(Completion&& completion) {
+        queue.push(std::move(completion));
+    }
+
+    template<typename F>
+    size_t drain(F&& f) {
+        size_t count = 0;
+        while (auto completion = queue.front()) {
+            f(*completion);
+            queue.pop();
+            count++;
+        }
+        return count;
+    }
+
+private:
+    kun::MpscQueue<Completion, 1024> queue;
+};
+
+class ListQueue {
+public:
+    void push(Completion&& completion) {
+        std::lock_guard<std::mutex> lockGuard(mutex);
+        completions.emplace_back(std::move(completion));
+    }
+
+    template<typename F>
+    size_t drain(F&& f) {
+        std::list<Completion> drained;
+        {
+            std::lock_guard<std::mutex> lockGuard(mutex);
+            drained.swap(completions);
+        }
+        for (auto& completion : drained) {
+            f(completion);
+        }
+        return drained.size();
+    }
+
+private:
+    std::list<Completion> completions;
+    std::mutex mutex;
+};
+
+template<typename Q>
+double run(int producers, uint64_t total) {
+    Q queue;
+    std::atomic<bool> started{false};
+    std::vector<std::thread> threads;
+    auto perThread = total / static_cast<uint64_t>(producers);
+    for (int i = 0; i < producers; i++) {
+        threads.emplace_back([&queue, &started, perThread]() {
+            while (!started.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (uint64_t j = 0; j < perThread; j++) {
+                queue.push(Completion(j));
+            }
+        });
+    }
+    auto expected = perThread * static_cast<uint64_t>(producers);
+    uint64_t received = 0;
+    uint64_t checksum = 0;
+    auto start = Clock::now();
+    started.store(true, std::memory_order_release);
+    while (received < expected) {
+        auto count = queue.drain([&checksum](Completion& completion) {
+            checksum += completion.value;
+        });
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        received += count;
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (checksum != perThread * (perThread - 1) / 2 * static_cast<uint64_t>(producers)) {
+        fprintf(stderr, "checksum mismatch\n");
+    }
+    return static_cast<double>(expected) / elapsed;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+    uint64_t total = 4000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            maxThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            total = strtoull(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [-t max-threads] [-n completions]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+    printf("%llu completions per run\n", static_cast<unsigned long long>(total));
+    printf("%8s %16s %16s\n", "threads", "mpsc ring/s", "mutex list/s");
+    for (int producers = 1; ; producers = std::min(producers << 1, maxThreads)) {
+        auto ring = run<RingQueue>(producers, total);
+        auto list = run<ListQueue>(producers, total);
+        printf("%8d %16.0f %16.0f\n", producers, ring, list);
+        if (producers == maxThreads) {
+            break;
+        }
+    }
+    return 0;
+}
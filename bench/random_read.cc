@@ -0,0 +1,376 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t READ_SIZE = 4096;
+
+using Clock = std::chrono::steady_clock;
+
+class Options {
+public:
+    std::string path;
+    size_t fileSize{256 * 1024 * 1024};
+    int threads{4};
+    unsigned depth{32};
+    int seconds{3};
+};
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed * 0x9e3779b97f4a7c15ULL + 1) {}
+
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+private:
+    uint64_t state;
+};
+
+inline int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+inline int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(
+        __NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0
+    ));
+}
+
+inline int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned nrArgs) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+template<typename T>
+inline T* offsetOf(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+class Ring {
+public:
+    Ring(const Ring&) = delete;
+
+    Ring& operator=(const Ring&) = delete;
+
+    Ring(Ring&&) = delete;
+
+    Ring& operator=(Ring&&) = delete;
+
+    explicit Ring(unsigned entries) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd = ioUringSetup(entries, &params);
+        if (fd == -1) {
+            return;
+        }
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqRing = ::mmap(
+            nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING
+        );
+        cqRing = ::mmap(
+            nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING
+        );
+        auto sqesPtr = ::mmap(
+            nullptr, sqesSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES
+        );
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqesPtr == MAP_FAILED) {
+            ::close(fd);
+            fd = -1;
+            return;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqesPtr);
+        sqHead = offsetOf<unsigned>(sqRing, params.sq_off.head);
+        sqTail = offsetOf<unsigned>(sqRing, params.sq_off.tail);
+        sqArray = offsetOf<unsigned>(sqRing, params.sq_off.array);
+        sqMask = *offsetOf<unsigned>(sqRing, params.sq_off.ring_mask);
+        cqHead = offsetOf<unsigned>(cqRing, params.cq_off.head);
+        cqTail = offsetOf<unsigned>(cqRing, params.cq_off.tail);
+        cqes = offsetOf<io_uring_cqe>(cqRing, params.cq_off.cqes);
+        cqMask = *offsetOf<unsigned>(cqRing, params.cq_off.ring_mask);
+        localTail = *sqTail;
+    }
+
+    ~Ring() {
+        if (fd != -1) {
+            ::munmap(sqes, sqesSize);
+            ::munmap(cqRing, cqRingSize);
+            ::munmap(sqRing, sqRingSize);
+            ::close(fd);
+        }
+    }
+
+    bool isValid() const {
+        return fd != -1;
+    }
+
+    io_uring_sqe* getSqe() {
+        auto index = localTail & sqMask;
+        auto sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        localTail++;
+        unsubmitted++;
+        return sqe;
+    }
+
+    bool submitAndWait(unsigned minComplete) {
+        __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+        while (true) {
+            auto rc = ioUringEnter(fd, unsubmitted, minComplete, IORING_ENTER_GETEVENTS);
+            if (rc >= 0) {
+                unsubmitted -= static_cast<unsigned>(rc);
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    template<typename F>
+    unsigned reap(F&& f) {
+        auto head = *cqHead;
+        auto tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        unsigned count = 0;
+        while (head != tail) {
+            auto& cqe = cqes[head & cqMask];
+            f(cqe.user_data, cqe.res);
+            head++;
+            count++;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    int fd{-1};
+
+private:
+    void* sqRing{nullptr};
+    void* cqRing{nullptr};
+    size_t sqRingSize{0};
+    size_t cqRingSize{0};
+    size_t sqesSize{0};
+    io_uring_sqe* sqes{nullptr};
+    unsigned* sqHead{nullptr};
+    unsigned* sqTail{nullptr};
+    unsigned* sqArray{nullptr};
+    unsigned sqMask{0};
+    unsigned* cqHead{nullptr};
+    unsigned* cqTail{nullptr};
+    io_uring_cqe* cqes{nullptr};
+    unsigned cqMask{0};
+    unsigned localTail{0};
+    unsigned unsubmitted{0};
+};
+
+inline off_t randomOffset(Random& random, size_t blocks) {
+    return static_cast<off_t>((random.next() % blocks) * READ_SIZE);
+}
+
+double runPread(const Options& options, int fileFd) {
+    const auto blocks = options.fileSize / READ_SIZE;
+    std::atomic<bool> stopped{false};
+    std::vector<uint64_t> counts(static_cast<size_t>(options.threads), 0);
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (int i = 0; i < options.threads; i++) {
+        threads.emplace_back([&, i]() {
+            Random random(static_cast<uint64_t>(i) + 1);
+            std::unique_ptr<char[]> buf(new char[READ_SIZE]);
+            uint64_t count = 0;
+            while (!stopped.load(std::memory_order_relaxed)) {
+                if (::pread(fileFd, buf.get(), READ_SIZE, randomOffset(random, blocks)) > 0) {
+                    count++;
+                }
+            }
+            counts[static_cast<size_t>(i)] = count;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(options.seconds));
+    stopped.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t total = 0;
+    for (auto count : counts) {
+        total += count;
+    }
+    return static_cast<double>(total) / elapsed;
+}
+
+double runUring(const Options& options, int fileFd, bool fixed) {
+    const auto blocks = options.fileSize / READ_SIZE;
+    const auto depth = options.depth;
+    Ring ring(depth);
+    if (!ring.isValid()) {
+        fprintf(stderr, "io_uring_setup: %s\n", strerror(errno));
+        return 0;
+    }
+    std::unique_ptr<char[]> results(new char[depth * READ_SIZE]);
+    std::unique_ptr<char[]> fixedBufs;
+    if (fixed) {
+        fixedBufs.reset(new char[depth * READ_SIZE]);
+        std::vector<iovec> iovecs(depth);
+        for (unsigned i = 0; i < depth; i++) {
+            iovecs[i].iov_base = fixedBufs.get() + i * READ_SIZE;
+            iovecs[i].iov_len = READ_SIZE;
+        }
+        if (ioUringRegister(ring.fd, IORING_REGISTER_BUFFERS, iovecs.data(), depth) == -1) {
+            fprintf(stderr, "IORING_REGISTER_BUFFERS: %s\n", strerror(errno));
+            return 0;
+        }
+    }
+    Random random(1);
+    auto issue = [&](unsigned slot) {
+        auto sqe = ring.getSqe();
+        sqe->fd = fileFd;
+        sqe->off = static_cast<uint64_t>(randomOffset(random, blocks));
+        sqe->len = READ_SIZE;
+        sqe->user_data = slot;
+        if (fixed) {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->addr = reinterpret_cast<uint64_t>(fixedBufs.get() + slot * READ_SIZE);
+            sqe->buf_index = static_cast<uint16_t>(slot);
+        } else {
+            sqe->opcode = IORING_OP_READ;
+            sqe->addr = reinterpret_cast<uint64_t>(results.get() + slot * READ_SIZE);
+        }
+    };
+    for (unsigned slot = 0; slot < depth; slot++) {
+        issue(slot);
+    }
+    uint64_t total = 0;
+    uint64_t errors = 0;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(options.seconds);
+    while (Clock::now() < deadline) {
+        if (!ring.submitAndWait(1)) {
+            fprintf(stderr, "io_uring_enter: %s\n", strerror(errno));
+            return 0;
+        }
+        ring.reap([&](uint64_t slot, int res) {
+            if (res > 0) {
+                if (fixed) {
+                    memcpy(
+                        results.get() + slot * READ_SIZE,
+                        fixedBufs.get() + slot * READ_SIZE,
+                        static_cast<size_t>(res)
+                    );
+                }
+                total++;
+            } else {
+                errors++;
+            }
+            issue(static_cast<unsigned>(slot));
+        });
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    unsigned inflight = depth;
+    while (inflight > 0 && ring.submitAndWait(1)) {
+        inflight -= ring.reap([](uint64_t, int) {});
+    }
+    if (errors > 0) {
+        fprintf(stderr, "%llu reads failed\n", static_cast<unsigned long long>(errors));
+    }
+    return static_cast<double>(total) / elapsed;
+}
+
+bool createFile(const Options& options, int& fileFd) {
+    fileFd = ::open(options.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileFd == -1) {
+        fprintf(stderr, "open '%s': %s\n", options.path.c_str(), strerror(errno));
+        return false;
+    }
+    constexpr size_t CHUNK_SIZE = 1024 * 1024;
+    std::unique_ptr<char[]> chunk(new char[CHUNK_SIZE]);
+    Random random(42);
+    for (size_t written = 0; written < options.fileSize; written += CHUNK_SIZE) {
+        for (size_t i = 0; i < CHUNK_SIZE; i += 8) {
+            auto value = random.next();
+            memcpy(chunk.get() + i, &value, 8);
+        }
+        if (::write(fileFd, chunk.get(), CHUNK_SIZE) != static_cast<ssize_t>(CHUNK_SIZE)) {
+            fprintf(stderr, "write '%s': %s\n", options.path.c_str(), strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    options.path = "/tmp/kun_random_read.dat";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            options.path = argv[++i];
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            options.fileSize = strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
+            options.depth = static_cast<unsigned>(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            options.seconds = atoi(argv[++i]);
+        } else {
+            fprintf(
+                stderr,
+                "Usage: %s [-f file] [-m file-mb] [-t threads] [-q queue-depth] [-d seconds]\n",
+                argv[0]
+            );
+            return 1;
+        }
+    }
+    if (
+        options.fileSize < 1024 * 1024 || options.threads < 1 ||
+        options.depth < 1 || options.depth > 4096 || options.seconds < 1
+    ) {
+        fprintf(stderr, "Invalid options\n");
+        return 1;
+    }
+    int fileFd = -1;
+    if (!createFile(options, fileFd)) {
+        return 1;
+    }
+    printf(
+        "4KB random reads over %zuMB for %ds each\n",
+        options.fileSize / (1024 * 1024), options.seconds
+    );
+    char label[64];
+    snprintf(label, sizeof(label), "pread, %d threads", options.threads);
+    printf("  %-30s %12.0f ops/sec\n", label, runPread(options, fileFd));
+    snprintf(label, sizeof(label), "IORING_OP_READ, qd %u", options.depth);
+    printf("  %-30s %12.0f ops/sec\n", label, runUring(options, fileFd, false));
+    snprintf(label, sizeof(label), "READ_FIXED + memcpy, qd %u", options.depth);
+    printf("  %-30s %12.0f ops/sec\n", label, runUring(options, fileFd, true));
+    ::close(fileFd);
+    ::unlink(options.path.c_str());
+    return 0;
+}
@@ -0,0 +1,42 @@
+const COUNT = 10000000;
+const CAPACITIES = [256, 4096, 65536];
+
+function pad(value, width) {
+    return String(value).padStart(width);
+}
+
+function run(capacity) {
+    return new Promise((resolve, reject) => {
+        const buffer = new SharedArrayBuffer(8 + capacity * 4);
+        const start = Date.now();
+        let pending = 2;
+        let sum = 0;
+        for (const role of ['consumer', 'producer']) {
+            const worker = new Worker('./shared_ring/worker.js');
+            worker.onmessage = (e) => {
+                if (e.data.role === 'consumer') {
+                    sum = e.data.sum;
+                }
+                if (--pending === 0) {
+                    const elapsed = Date.now() - start;
+                    if (sum !== COUNT * (COUNT - 1) / 2) {
+                        reject(new Error(`checksum mismatch: ${sum}`));
+                        return;
+                    }
+                    resolve(elapsed);
+                }
+            };
+            worker.postMessage({ role, buffer, capacity, count: COUNT });
+        }
+    });
+}
+
+(async () => {
+    console.log(`${COUNT} records through a SharedArrayBuffer ring, 1 producer and 1 consumer worker`);
+    console.log(`${pad('capacity', 10)}${pad('ms', 10)}${pad('records/s', 14)}`);
+    for (const capacity of CAPACITIES) {
+        const elapsed = await run(capacity);
+        const perSec = (COUNT * 1000 / Math.max(elapsed, 1)).toFixed(0);
+        console.log(`${pad(capacity, 10)}${pad(elapsed, 10)}${pad(perSec, 14)}`);
+    }
+})();
@@ -0,0 +1,68 @@
+const HEAD = 0;
+const TAIL = 1;
+const BATCH = 64;
+
+function publish(ctrl, index, value) {
+    Atomics.store(ctrl, index, value);
+    Atomics.notify(ctrl, index);
+}
+
+function produce(ctrl, data, count) {
+    const capacity = data.length;
+    const mask = capacity - 1;
+    let head = 0;
+    let tail = 0;
+    for (let i = 0; i < count; i++) {
+        if (tail - head === capacity) {
+            publish(ctrl, TAIL, tail);
+            head = Atomics.load(ctrl, HEAD);
+            while (tail - head === capacity) {
+                Atomics.wait(ctrl, HEAD, head);
+                head = Atomics.load(ctrl, HEAD);
+            }
+        }
+        data[tail & mask] = i;
+        tail++;
+        if ((tail & (BATCH - 1)) === 0) {
+            publish(ctrl, TAIL, tail);
+        }
+    }
+    publish(ctrl, TAIL, tail);
+}
+
+function consume(ctrl, data, count) {
+    const mask = data.length - 1;
+    let head = 0;
+    let tail = 0;
+    let sum = 0;
+    while (head < count) {
+        if (head === tail) {
+            publish(ctrl, HEAD, head);
+            tail = Atomics.load(ctrl, TAIL);
+            while (tail === head) {
+                Atomics.wait(ctrl, TAIL, tail);
+                tail = Atomics.load(ctrl, TAIL);
+            }
+        }
+        sum += data[head & mask];
+        head++;
+        if ((head & (BATCH - 1)) === 0) {
+            publish(ctrl, HEAD, head);
+        }
+    }
+    publish(ctrl, HEAD, head);
+    return sum;
+}
+
+onmessage = (e) => {
+    const { role, buffer, capacity, count } = e.data;
+    const ctrl = new Int32Array(buffer, 0, 2);
+    const data = new Int32Array(buffer, 8, capacity);
+    if (role === 'producer') {
+        produce(ctrl, data, count);
+        postMessage({ role });
+    } else {
+        postMessage({ role, sum: consume(ctrl, data, count) });
+    }
+    close();
+};
@@ -0,0 +1,148 @@
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class Command {
+public:
+    std::string line;
+    std::vector<std::string> args;
+    std::vector<double> samples;
+    int failures{0};
+};
+
+std::vector<std::string> splitArgs(const std::string& line) {
+    std::vector<std::string> args;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        auto end = line.find(' ', pos);
+        if (end == std::string::npos) {
+            end = line.size();
+        }
+        if (end > pos) {
+            args.emplace_back(line.substr(pos, end - pos));
+        }
+        pos = end + 1;
+    }
+    return args;
+}
+
+bool runOnce(const Command& command, int devNull, double& ms) {
+    std::vector<char*> argv;
+    for (const auto& arg : command.args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, devNull, STDOUT_FILENO);
+    auto start = Clock::now();
+    pid_t pid;
+    auto rc = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0) {
+        fprintf(stderr, "posix_spawn '%s': %s\n", argv[0], strerror(rc));
+        return false;
+    }
+    int status = 0;
+    if (::waitpid(pid, &status, 0) == -1) {
+        return false;
+    }
+    ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+}
+
+int main(int argc, char** argv) {
+    int runs = 50;
+    int warmup = 3;
+    std::vector<Command> commands;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else {
+            Command command;
+            command.line = argv[i];
+            command.args = splitArgs(command.line);
+            if (!command.args.empty()) {
+                commands.emplace_back(std::move(command));
+            }
+        }
+    }
+    if (commands.empty() || runs < 1) {
+        fprintf(stderr, "Usage: %s [-n runs] [-w warmup] \"command args...\" ...\n", argv[0]);
+        return 1;
+    }
+    auto devNull = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    if (devNull == -1) {
+        perror("open /dev/null");
+        return 1;
+    }
+    for (int i = 0; i < warmup; i++) {
+        for (auto& command : commands) {
+            double ms;
+            runOnce(command, devNull, ms);
+        }
+    }
+    for (int i = 0; i < runs; i++) {
+        for (auto& command : commands) {
+            double ms;
+            if (runOnce(command, devNull, ms)) {
+                command.samples.push_back(ms);
+            } else {
+                command.failures++;
+            }
+        }
+    }
+    ::close(devNull);
+    printf("%d runs per command, %d warmup\n", runs, warmup);
+    for (auto& command : commands) {
+        printf("%s\n", command.line.c_str());
+        auto& samples = command.samples;
+        if (samples.empty()) {
+            printf("  all runs failed\n");
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        double sum = 0;
+        for (auto sample : samples) {
+            sum += sample;
+        }
+        printf(
+            "  mean %.2fms min %.2fms p50 %.2fms p99 %.2fms max %.2fms\n",
+            sum / static_cast<double>(samples.size()),
+            samples.front(),
+            percentile(samples, 0.5),
+            percentile(samples, 0.99),
+            samples.back()
+        );
+        if (command.failures > 0) {
+            printf("  %d runs failed\n", command.failures);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+const MIN_DURATION = 500;
+
+function measure(fn) {
+    let iterations = 1;
+    while (true) {
+        const start = Date.now();
+        for (let i = 0; i < iterations; i++) {
+            fn();
+        }
+        const elapsed = Date.now() - start;
+        if (elapsed >= MIN_DURATION) {
+            return iterations * 1000 / elapsed;
+        }
+        iterations *= elapsed > 0 ? Math.ceil(MIN_DURATION * 1.2 / elapsed) : 8;
+    }
+}
+
+function pad(value, width) {
+    return String(value).padStart(width);
+}
+
+function makeConfig(services) {
+    const config = { version: 3, name: 'gateway', services: [] };
+    for (let i = 0; i < services; i++) {
+        config.services.push({
+            id: i,
+            name: `service-${i}`,
+            enabled: i % 3 !== 0,
+            weight: i / services,
+            hosts: [`10.0.${i >> 8}.${i & 255}`, `10.1.${i >> 8}.${i & 255}`],
+            limits: { rps: 1000 + i, burst: 50, timeoutMs: 3000 },
+            tags: ['edge', 'v2', `zone-${i % 4}`]
+        });
+    }
+    return config;
+}
+
+function jsonClone(value) {
+    return JSON.parse(JSON.stringify(value));
+}
+
+const cases = [
+    ['config, 10 services', makeConfig(10)],
+    ['config, 1000 services', makeConfig(1000)],
+    ['array of 10000 numbers', Array.from({ length: 10000 }, (_, i) => i * 1.5)],
+    ['string of 1MB', 'x'.repeat(1024 * 1024)]
+];
+
+console.log(`${'value'.padEnd(26)}${pad('clone/s', 12)}${pad('json/s', 12)}${pad('ratio', 8)}`);
+for (const [name, value] of cases) {
+    const clone = measure(() => structuredClone(value));
+    const json = measure(() => jsonClone(value));
+    console.log(
+        `${name.padEnd(26)}${pad(clone.toFixed(0), 12)}${pad(json.toFixed(0), 12)}` +
+        `${pad((clone / json).toFixed(2), 8)}`
+    );
+}
+
+const bytes = 16 * 1024 * 1024;
+const copy = measure(() => structuredClone(new Uint8Array(bytes)));
+const transfer = measure(() => {
+    const arr = new Uint8Array(bytes);
+    structuredClone(arr, { transfer: [arr.buffer] });
+});
+console.log(`${'16MB Uint8Array, copy'.padEnd(26)}${pad(copy.toFixed(0), 12)}`);
+console.log(`${'16MB Uint8Array, transfer'.padEnd(26)}${pad(transfer.toFixed(0), 12)}`);
@@ -0,0 +1,50 @@
+const SIZES = [1024, 65536, 4194304];
+const MIN_DURATION = 500;
+
+function makeCorpus(size, chunk) {
+    const encoded = new TextEncoder().encode(chunk);
+    const arr = new Uint8Array(size);
+    let len = 0;
+    while (len + encoded.length <= size) {
+        arr.set(encoded, len);
+        len += encoded.length;
+    }
+    arr.fill(0x20, len);
+    return arr;
+}
+
+function measure(fn, bytes) {
+    let iterations = 1;
+    while (true) {
+        const start = Date.now();
+        for (let i = 0; i < iterations; i++) {
+            fn();
+        }
+        const elapsed = Date.now() - start;
+        if (elapsed >= MIN_DURATION) {
+            return iterations * bytes * 1000 / elapsed / 1048576;
+        }
+        iterations *= elapsed > 0 ? Math.ceil(MIN_DURATION * 1.2 / elapsed) : 8;
+    }
+}
+
+function pad(value, width) {
+    return String(value).padStart(width);
+}
+
+const corpora = [
+    ['ascii', '{"id":12345,"name":"kun","tags":["fast","small"],"ok":true},\n'],
+    ['mixed', '{"city":"München","note":"café — naïve","emoji":"\u{1F600}"},\n'],
+    ['cjk', '東京都千代田区、北京市朝阳区。\n']
+];
+const decoder = new TextDecoder();
+const fatalDecoder = new TextDecoder('utf-8', { fatal: true });
+console.log(`${pad('corpus', 8)}${pad('bytes', 10)}${pad('MB/s', 10)}${pad('fatal MB/s', 12)}`);
+for (const [name, chunk] of corpora) {
+    for (const size of SIZES) {
+        const input = makeCorpus(size, chunk);
+        const replacement = measure(() => decoder.decode(input), size);
+        const fatal = measure(() => fatalDecoder.decode(input), size);
+        console.log(`${pad(name, 8)}${pad(size, 10)}${pad(replacement.toFixed(1), 10)}${pad(fatal.toFixed(1), 12)}`);
+    }
+}
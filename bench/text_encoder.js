@@ -0,0 +1,51 @@
+const SIZES = [16, 256, 4096, 65536, 1048576];
+const MIN_DURATION = 500;
+
+function makeInput(size, chunk) {
+    let str = '';
+    while (str.length < size) {
+        str += chunk;
+    }
+    return str.slice(0, size);
+}
+
+function measure(fn, bytes) {
+    let iterations = 1;
+    while (true) {
+        const start = Date.now();
+        for (let i = 0; i < iterations; i++) {
+            fn();
+        }
+        const elapsed = Date.now() - start;
+        if (elapsed >= MIN_DURATION) {
+            const opsPerSec = iterations * 1000 / elapsed;
+            return {
+                opsPerSec,
+                mbPerSec: opsPerSec * bytes / 1048576
+            };
+        }
+        iterations *= elapsed > 0 ? Math.ceil(MIN_DURATION * 1.2 / elapsed) : 8;
+    }
+}
+
+function pad(value, width) {
+    return String(value).padStart(width);
+}
+
+const encoder = new TextEncoder();
+const inputs = [
+    ['ascii', 'The quick brown fox jumps over the lazy dog. '],
+    ['latin1', 'Café crème brûlée, naïve façade. '],
+    ['mixed', 'Hello 世界, café — αβγ. ']
+];
+console.log(`${pad('input', 8)}${pad('chars', 10)}${pad('encodes/s', 14)}${pad('MB/s', 10)}`);
+for (const [name, chunk] of inputs) {
+    for (const size of SIZES) {
+        const input = makeInput(size, chunk);
+        const bytes = encoder.encode(input).length;
+        const { opsPerSec, mbPerSec } = measure(() => encoder.encode(input), bytes);
+        console.log(
+            `${pad(name, 8)}${pad(size, 10)}${pad(opsPerSec.toFixed(0), 14)}${pad(mbPerSec.toFixed(1), 10)}`
+        );
+    }
+}
@@ -113,6 +113,12 @@ function getBuildType() {
         if (name === '--debug') {
             return 'debug';
         }
+        if (name === '--test') {
+            return 'test';
+        }
+        if (name === '--bench') {
+            return 'bench';
+        }
         console.log(`bad option '${name}'`);
     }
     return 'debug';
@@ -403,10 +409,88 @@ function generateUnixMakefile(config) {
         content += `\n${objectPath}: ${sourcePath} ${headerPaths}\n`;
         content += `\tg++ ${cxxflags} ${includes} -c ${sourcePath} -o ${objectPath}\n`;
     }
+    const benchNames = fs.readdirSync('./bench').filter((name) => name.endsWith('.cc')).sort();
+    for (const name of benchNames) {
+        const benchPath = `${config.distDir}/${name.slice(0, -3)}`;
+        content += `\n${benchPath}: bench/${name}\n`;
+        content += `\tg++ -std=c++17 -m64 -O3 -Wall -Wextra -pthread -I ${config.srcDir} `;
+        content += `bench/${name} -o ${benchPath}\n`;
+    }
     fs.writeFileSync('./Makefile', content);
     console.log('Generate Makefile successfully!');
 }
 
+function runTests(config) {
+    const suffix = config.platform === 'win32' ? '.exe' : '';
+    const targetPath = `${config.distDir}/${config.target}${suffix}`;
+    const testDir = './test';
+    const names = fs.readdirSync(testDir).filter((name) => name.endsWith('.js')).sort();
+    let failedCount = 0;
+    for (const name of names) {
+        const result = childProcess.spawnSync(targetPath, [`${testDir}/${name}`], {
+            encoding: 'utf8',
+            timeout: 60000
+        });
+        const lines = (result.stdout || '').trim().split('\n');
+        if (
+            result.status === 0 &&
+            result.stderr === '' &&
+            lines[lines.length - 1] === 'PASS'
+        ) {
+            console.log(`ok ${name}`);
+        } else {
+            failedCount++;
+            console.log(`FAIL ${name}`);
+            process.stdout.write(result.stdout || '');
+            process.stdout.write(result.stderr || '');
+        }
+    }
+    console.log(`${names.length - failedCount} passed, ${failedCount} failed`);
+    if (failedCount > 0) {
+        process.exitCode = 1;
+    }
+}
+
+function runStartupBench(config) {
+    if (config.platform === 'win32') {
+        console.log('The startup benchmark requires a unix platform');
+        process.exitCode = 1;
+        return;
+    }
+    const targetPath = `${config.distDir}/${config.target}`;
+    const benchPath = `${config.distDir}/startup`;
+    const scriptPath = './bench/startup/hello.js';
+    childProcess.execSync(`make ${benchPath}`, {
+        stdio: 'inherit'
+    });
+    childProcess.execSync(`${targetPath} --build-snapshot`, {
+        stdio: 'inherit'
+    });
+    const commands = [
+        `${targetPath} --no-snapshot ${scriptPath}`,
+        `${targetPath} ${scriptPath}`
+    ];
+    childProcess.execFileSync(benchPath, commands, {
+        stdio: 'inherit'
+    });
+    const appPath = './bench/cold_start/app/main.js';
+    const imagePath = `${config.distDir}/cold_start.kimg`;
+    childProcess.execSync(`${targetPath} ./bench/cold_start/generate.js`, {
+        stdio: 'inherit'
+    });
+    childProcess.execSync(`${targetPath} --compile=${imagePath} ${appPath}`, {
+        stdio: 'inherit'
+    });
+    const coldStartCommands = [
+        `${targetPath} --no-code-cache ${appPath}`,
+        `${targetPath} ${appPath}`,
+        `${targetPath} ${imagePath}`
+    ];
+    childProcess.execFileSync(benchPath, coldStartCommands, {
+        stdio: 'inherit'
+    });
+}
+
 function buildProject(platform) {
     console.log('Building project...');
     if (platform === 'win32') {
@@ -504,6 +588,11 @@ if (buildType === 'clean') {
     }
     console.log('Clean successfully!');
     return;
+} else if (buildType === 'test') {
+    runTests(config);
+    return;
+} else if (buildType === 'bench') {
+    config.buildType = 'release';
 } else {
     config.buildType = buildType;
 }
@@ -520,4 +609,8 @@ if (config.platform === 'win32') {
 
 buildProject(config.platform);
 
+if (buildType === 'bench') {
+    runStartupBench(config);
+}
+
 })();
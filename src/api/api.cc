@@ -0,0 +1,35 @@
+#include "api/api.h"
+
+#include "api/fs.h"
+#include "api/http.h"
+#include "api/net.h"
+#include "util/v8_utils.h"
+
+KUN_V8_USINGS;
+
+using kun::util::toV8String;
+
+namespace kun::api {
+
+void expose(Local<Context> context, ExposedScope exposedScope) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    globalThis->DefineOwnProperty(
+        context,
+        toV8String(isolate, KUN_NAME),
+        Object::New(isolate),
+        v8::ReadOnly
+    ).Check();
+    exposeFs(context, exposedScope);
+    exposeNet(context, exposedScope);
+    exposeHttp(context, exposedScope);
+}
+
+void registerReferences(std::vector<intptr_t>& references) {
+    registerFsReferences(references);
+    registerNetReferences(references);
+    registerHttpReferences(references);
+}
+
+}
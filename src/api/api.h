@@ -0,0 +1,19 @@
+#ifndef KUN_API_API_H
+#define KUN_API_API_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "v8.h"
+#include "util/constants.h"
+
+namespace kun::api {
+
+void expose(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
@@ -0,0 +1,421 @@
+#include "api/fs.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <vector>
+
+#include "env/environment.h"
+#include "loop/async_request.h"
+#include "loop/event_loop.h"
+#include "sys/fs.h"
+#include "util/file_info.h"
+#include "util/js_utils.h"
+#include "util/scope_guard.h"
+#include "util/sys_err.h"
+#include "util/utils.h"
+#include "util/v8_utils.h"
+
+KUN_V8_USINGS;
+
+using v8::ArrayBufferView;
+using v8::Date;
+using v8::Exception;
+using kun::AsyncRequest;
+using kun::BString;
+using kun::DirEntry;
+using kun::Environment;
+using kun::FileStat;
+using kun::FileType;
+#ifdef KUN_PLATFORM_LINUX
+using kun::IoUringOp;
+#endif
+using kun::JS;
+using kun::SysErr;
+using kun::util::addReferences;
+using kun::util::callAsyncFunc;
+using kun::util::checkFuncArgs;
+using kun::util::fromObject;
+using kun::util::setFunction;
+using kun::util::submitAsyncRequest;
+using kun::util::toV8String;
+
+namespace {
+
+char* toCString(Isolate* isolate, Local<String> v8Str) {
+    const auto len = v8Str->Utf8Length(isolate);
+    auto buf = new char[len + 1];
+    v8Str->WriteUtf8(isolate, buf, len);
+    buf[len] = '\0';
+    return buf;
+}
+
+bool getRecursive(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    bool recursive = false;
+    if (info.Length() > 1 && !info[1]->IsNull() && info[1]->IsObject()) {
+        fromObject(context, info[1].As<Object>(), "recursive", recursive);
+    }
+    return recursive;
+}
+
+void rejectSysErr(Local<Context> context, Local<Promise::Resolver> resolver, int errCode) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto [code, name, phrase] = SysErr(errCode);
+    auto errStr = BString::format("{}({}) {}", name, code, phrase);
+    auto v8Str = toV8String(isolate, errStr);
+    resolver->Reject(context, Exception::TypeError(v8Str)).Check();
+}
+
+#ifdef KUN_PLATFORM_LINUX
+bool submitIoUring(const FunctionCallbackInfo<Value>& info, IoUringOp op, AsyncRequest& req) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto env = Environment::from(context);
+    auto ioUring = env->getEventLoop()->getIoUring();
+    if (ioUring == nullptr) {
+        return false;
+    }
+    auto resolver = Promise::Resolver::New(context).ToLocalChecked();
+    auto promise = resolver->GetPromise();
+    req.setResolver(isolate, resolver);
+    ioUring->submit(op, std::move(req));
+    info.GetReturnValue().Set(promise);
+    return true;
+}
+#endif
+
+void submitFileRequest(
+    const FunctionCallbackInfo<Value>& info,
+    bool isRead,
+    AsyncRequest&& req
+) {
+    #ifdef KUN_PLATFORM_LINUX
+    auto op = isRead ? IoUringOp::READ_FILE : IoUringOp::WRITE_FILE;
+    if (submitIoUring(info, op, req)) {
+        return;
+    }
+    #endif
+    submitAsyncRequest(info, std::move(req));
+}
+
+void setFileType(Local<Context> context, Local<Object> obj, FileType fileType) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    obj->Set(
+        context,
+        toV8String(isolate, "isFile"),
+        Boolean::New(isolate, fileType == FileType::FILE)
+    ).Check();
+    obj->Set(
+        context,
+        toV8String(isolate, "isDirectory"),
+        Boolean::New(isolate, fileType == FileType::DIRECTORY)
+    ).Check();
+    obj->Set(
+        context,
+        toV8String(isolate, "isSymlink"),
+        Boolean::New(isolate, fileType == FileType::SYMLINK)
+    ).Check();
+}
+
+void handleReadFile(AsyncRequest& req) {
+    auto path = req.get<char*>(0);
+    ON_SCOPE_EXIT {
+        delete[] path;
+    };
+    auto result = kun::sys::readFile(BString::view(path, strlen(path)));
+    if (!result) {
+        req.set(0, nullptr);
+        req.set(1, result.err().code);
+        return;
+    }
+    auto content = result.unwrap();
+    auto len = content.length();
+    auto buf = new char[len + 1];
+    memcpy(buf, content.data(), len);
+    req.set(0, buf);
+    req.set(1, len);
+}
+
+void handleWriteFile(AsyncRequest& req) {
+    auto path = req.get<char*>(0);
+    auto data = req.get<char*>(1);
+    auto len = req.get<size_t>(2);
+    ON_SCOPE_EXIT {
+        delete[] path;
+        delete[] data;
+    };
+    auto content = BString::view(data, len);
+    if (auto result = kun::sys::writeFile(BString::view(path, strlen(path)), content)) {
+        req.set(0, 0);
+    } else {
+        req.set(0, -1);
+        req.set(1, result.err().code);
+    }
+}
+
+void handleStat(AsyncRequest& req) {
+    auto path = req.get<char*>(0);
+    ON_SCOPE_EXIT {
+        delete[] path;
+    };
+    if (auto result = kun::sys::getFileStat(BString::view(path, strlen(path)))) {
+        req.set(0, new FileStat(result.unwrap()));
+    } else {
+        req.set(0, nullptr);
+        req.set(1, result.err().code);
+    }
+}
+
+void resolveStat(Local<Context> context, AsyncRequest& req) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto resolver = req.getResolver(isolate);
+    auto fileStat = req.get<FileStat*>(0);
+    if (fileStat == nullptr) {
+        rejectSysErr(context, resolver, req.get<int>(1));
+        return;
+    }
+    ON_SCOPE_EXIT {
+        delete fileStat;
+    };
+    auto obj = Object::New(isolate);
+    setFileType(context, obj, fileStat->type);
+    obj->Set(
+        context,
+        toV8String(isolate, "size"),
+        Number::New(isolate, static_cast<double>(fileStat->size))
+    ).Check();
+    obj->Set(
+        context,
+        toV8String(isolate, "mode"),
+        Number::New(isolate, fileStat->mode)
+    ).Check();
+    obj->Set(
+        context,
+        toV8String(isolate, "atime"),
+        Date::New(context, fileStat->atime).ToLocalChecked()
+    ).Check();
+    obj->Set(
+        context,
+        toV8String(isolate, "mtime"),
+        Date::New(context, fileStat->mtime).ToLocalChecked()
+    ).Check();
+    resolver->Resolve(context, obj).Check();
+}
+
+void handleReadDir(AsyncRequest& req) {
+    auto path = req.get<char*>(0);
+    ON_SCOPE_EXIT {
+        delete[] path;
+    };
+    if (auto result = kun::sys::readDir(BString::view(path, strlen(path)))) {
+        req.set(0, new std::vector<DirEntry>(result.unwrap()));
+    } else {
+        req.set(0, nullptr);
+        req.set(1, result.err().code);
+    }
+}
+
+void resolveReadDir(Local<Context> context, AsyncRequest& req) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto resolver = req.getResolver(isolate);
+    auto entries = req.get<std::vector<DirEntry>*>(0);
+    if (entries == nullptr) {
+        rejectSysErr(context, resolver, req.get<int>(1));
+        return;
+    }
+    ON_SCOPE_EXIT {
+        delete entries;
+    };
+    auto len = static_cast<uint32_t>(entries->size());
+    auto arr = Array::New(isolate, static_cast<int>(len));
+    for (uint32_t i = 0; i < len; i++) {
+        const auto& entry = (*entries)[i];
+        auto obj = Object::New(isolate);
+        obj->Set(context, toV8String(isolate, "name"), toV8String(isolate, entry.name)).Check();
+        setFileType(context, obj, entry.type);
+        arr->Set(context, i, obj).Check();
+    }
+    resolver->Resolve(context, arr).Check();
+}
+
+void handleMakeDir(AsyncRequest& req) {
+    auto path = req.get<char*>(0);
+    auto recursive = req.get<bool>(1);
+    ON_SCOPE_EXIT {
+        delete[] path;
+    };
+    auto str = BString::view(path, strlen(path));
+    auto result = recursive ? kun::sys::makeDirs(str) : kun::sys::makeDir(str);
+    if (result) {
+        req.set(0, 0);
+    } else {
+        req.set(0, -1);
+        req.set(1, result.err().code);
+    }
+}
+
+void handleRemove(AsyncRequest& req) {
+    auto path = req.get<char*>(0);
+    auto recursive = req.get<bool>(1);
+    ON_SCOPE_EXIT {
+        delete[] path;
+    };
+    auto str = BString::view(path, strlen(path));
+    int errCode = SysErr::NOT_DIRECTORY;
+    if (recursive) {
+        auto result = kun::sys::removeDir(str);
+        errCode = result ? 0 : result.err().code;
+    }
+    if (errCode == SysErr::NOT_DIRECTORY) {
+        auto result = kun::sys::removePath(str);
+        errCode = result ? 0 : result.err().code;
+    }
+    if (errCode == 0) {
+        req.set(0, 0);
+    } else {
+        req.set(0, -1);
+        req.set(1, errCode);
+    }
+}
+
+void readFile(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::String>(info)) {
+        return;
+    }
+    AsyncRequest req(handleReadFile, AsyncRequest::resolveUint8Array);
+    req.set(0, toCString(isolate, info[0].As<String>()));
+    submitFileRequest(info, true, std::move(req));
+}
+
+void readTextFile(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::String>(info)) {
+        return;
+    }
+    AsyncRequest req(handleReadFile, AsyncRequest::resolveString);
+    req.set(0, toCString(isolate, info[0].As<String>()));
+    submitFileRequest(info, true, std::move(req));
+}
+
+void writeFile(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<
+        JS::String,
+        JS::String | JS::ArrayBuffer | JS::DataView | JS::TypedArray
+    >(info)) {
+        return;
+    }
+    char* data = nullptr;
+    size_t len = 0;
+    auto value = info[1];
+    if (value->IsString()) {
+        auto v8Str = value.As<String>();
+        len = v8Str->Utf8Length(isolate);
+        data = new char[len + 1];
+        v8Str->WriteUtf8(isolate, data, static_cast<int>(len));
+    } else if (value->IsArrayBuffer()) {
+        auto arrBuf = value.As<ArrayBuffer>();
+        len = arrBuf->ByteLength();
+        data = new char[len + 1];
+        memcpy(data, arrBuf->Data(), len);
+    } else {
+        auto abv = value.As<ArrayBufferView>();
+        len = abv->ByteLength();
+        data = new char[len + 1];
+        abv->CopyContents(data, len);
+    }
+    AsyncRequest req(handleWriteFile, AsyncRequest::resolveUndefined<int>);
+    req.set(0, toCString(isolate, info[0].As<String>()));
+    req.set(1, data);
+    req.set(2, len);
+    submitFileRequest(info, false, std::move(req));
+}
+
+void getStat(const FunctionCallbackInfo<Value>& info) {
+    AsyncRequest req(handleStat, resolveStat);
+    callAsyncFunc<JS::String>(info, std::move(req));
+}
+
+void readDir(const FunctionCallbackInfo<Value>& info) {
+    AsyncRequest req(handleReadDir, resolveReadDir);
+    callAsyncFunc<JS::String>(info, std::move(req));
+}
+
+void makeDir(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::String, JS::Optional | JS::Object | JS::Undefined>(info)) {
+        return;
+    }
+    AsyncRequest req(handleMakeDir, AsyncRequest::resolveUndefined<int>);
+    req.set(0, toCString(isolate, info[0].As<String>()));
+    req.set(1, getRecursive(info));
+    submitAsyncRequest(info, std::move(req));
+}
+
+void removePath(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::String, JS::Optional | JS::Object | JS::Undefined>(info)) {
+        return;
+    }
+    AsyncRequest req(handleRemove, AsyncRequest::resolveUndefined<int>);
+    req.set(0, toCString(isolate, info[0].As<String>()));
+    req.set(1, getRecursive(info));
+    submitAsyncRequest(info, std::move(req));
+}
+
+}
+
+namespace kun::api {
+
+void exposeFs(Local<Context> context, ExposedScope exposedScope) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    Local<Object> kunObj;
+    if (!fromObject(context, globalThis, KUN_NAME, kunObj)) {
+        KUN_LOG_ERR("'{}' not found", KUN_NAME);
+        return;
+    }
+    auto fsObj = Object::New(isolate);
+    setFunction(context, fsObj, "readFile", readFile);
+    setFunction(context, fsObj, "readTextFile", readTextFile);
+    setFunction(context, fsObj, "writeFile", writeFile);
+    setFunction(context, fsObj, "stat", getStat);
+    setFunction(context, fsObj, "readDir", readDir);
+    setFunction(context, fsObj, "mkdir", makeDir);
+    setFunction(context, fsObj, "remove", removePath);
+    kunObj->DefineOwnProperty(
+        context,
+        toV8String(isolate, "fs"),
+        fsObj,
+        v8::ReadOnly
+    ).Check();
+}
+
+void registerFsReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        readFile,
+        readTextFile,
+        writeFile,
+        getStat,
+        readDir,
+        makeDir,
+        removePath
+    });
+}
+
+}
@@ -0,0 +1,19 @@
+#ifndef KUN_API_FS_H
+#define KUN_API_FS_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "v8.h"
+#include "util/constants.h"
+
+namespace kun::api {
+
+void exposeFs(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerFsReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
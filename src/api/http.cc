@@ -0,0 +1,894 @@
+#include "api/http.h"
+
+#include "util/constants.h"
+
+#ifdef KUN_PLATFORM_UNIX
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <charconv>
+
+#include "api/net.h"
+#include "loop/event_loop.h"
+#include "sys/io.h"
+#include "sys/net.h"
+#include "util/js_utils.h"
+#include "util/utils.h"
+#include "util/v8_utils.h"
+
+KUN_V8_USINGS;
+
+using v8::ArrayBufferView;
+using v8::External;
+using v8::Name;
+using v8::NewStringType;
+using v8::PropertyCallbackInfo;
+using v8::TryCatch;
+using kun::BString;
+using kun::Environment;
+using kun::HttpParseStatus;
+using kun::InternalField;
+using kun::JS;
+using kun::api::HttpConn;
+using kun::api::HttpExchange;
+using kun::api::HttpServer;
+using kun::api::getSocketAddress;
+using kun::sys::eprintln;
+using kun::util::addReferences;
+using kun::util::checkFuncArgs;
+using kun::util::createObject;
+using kun::util::defineAccessor;
+using kun::util::formatException;
+using kun::util::fromObject;
+using kun::util::getPrototypeOf;
+using kun::util::setFunction;
+using kun::util::setToStringTag;
+using kun::util::throwTypeError;
+using kun::util::toBString;
+using kun::util::toV8String;
+
+#ifdef KUN_PLATFORM_UNIX
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+constexpr size_t READ_SIZE = 16 * 1024;
+constexpr size_t MAX_HEAD_SIZE = 64 * 1024;
+constexpr size_t MAX_BODY_SIZE = 16 * 1024 * 1024;
+constexpr size_t MAX_WRITE_BACKLOG = 1024 * 1024;
+
+const char* getReasonPhrase(int status) {
+    switch (status) {
+        case 100: return "Continue";
+        case 101: return "Switching Protocols";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 303: return "See Other";
+        case 304: return "Not Modified";
+        case 307: return "Temporary Redirect";
+        case 308: return "Permanent Redirect";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 409: return "Conflict";
+        case 410: return "Gone";
+        case 411: return "Length Required";
+        case 413: return "Content Too Large";
+        case 414: return "URI Too Long";
+        case 415: return "Unsupported Media Type";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default: return "Unknown";
+    }
+}
+
+void ensureSpace(BString& buf, size_t extra) {
+    auto required = buf.length() + extra;
+    auto capacity = buf.capacity();
+    if (capacity < required) {
+        buf.reserve(required > capacity * 2 ? required : capacity * 2);
+    }
+}
+
+void appendNumber(BString& buf, size_t num) {
+    char digits[24];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), num);
+    buf.append(digits, end - digits);
+}
+
+bool hasLineBreak(const BString& str) {
+    auto p = str.data();
+    auto len = str.length();
+    return memchr(p, '\r', len) != nullptr || memchr(p, '\n', len) != nullptr;
+}
+
+bool isFramingHeader(const BString& name) {
+    return (
+        name.equalFold("content-length") ||
+        name.equalFold("transfer-encoding") ||
+        name.equalFold("connection")
+    );
+}
+
+void reportException(Local<Context> context, Local<Value> exception) {
+    auto errStr = formatException(context, exception);
+    eprintln("\x1b[0;31mUncaught\x1b[0m {}", errStr);
+}
+
+HttpExchange* getExchange(const PropertyCallbackInfo<Value>& info) {
+    auto obj = info.This();
+    return static_cast<HttpExchange*>(obj->GetAlignedPointerFromInternalField(0));
+}
+
+void releaseExchange(Isolate* isolate, HttpExchange* exchange) {
+    HandleScope handleScope(isolate);
+    if (!exchange->request.IsEmpty()) {
+        auto obj = exchange->request.Get(isolate);
+        obj->SetAlignedPointerInInternalField(0, nullptr);
+    }
+    delete exchange;
+}
+
+void getMethod(Local<Name> name, const PropertyCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto exchange = getExchange(info);
+    if (exchange == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(toV8String(isolate, exchange->head.method));
+}
+
+void getUrl(Local<Name> name, const PropertyCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto exchange = getExchange(info);
+    if (exchange == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(toV8String(isolate, exchange->head.target));
+}
+
+void getHeaders(Local<Name> name, const PropertyCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto exchange = getExchange(info);
+    if (exchange == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto obj = Object::New(isolate);
+    BString lowerName;
+    for (const auto& header : exchange->head.headers) {
+        lowerName.resize(0);
+        lowerName.append(header.name);
+        auto p = lowerName.data();
+        for (size_t i = 0; i < lowerName.length(); i++) {
+            if (p[i] >= 'A' && p[i] <= 'Z') {
+                p[i] = static_cast<char>(p[i] + ('a' - 'A'));
+            }
+        }
+        auto key = String::NewFromUtf8(
+            isolate,
+            lowerName.data(),
+            NewStringType::kInternalized,
+            static_cast<int>(lowerName.length())
+        ).ToLocalChecked();
+        auto value = toV8String(isolate, header.value);
+        Local<Value> prev;
+        if (
+            obj->HasOwnProperty(context, key).FromMaybe(false) &&
+            obj->Get(context, key).ToLocal(&prev)
+        ) {
+            auto joined = String::Concat(isolate, prev.As<String>(), toV8String(isolate, ", "));
+            value = String::Concat(isolate, joined, value);
+        }
+        obj->CreateDataProperty(context, key, value).Check();
+    }
+    info.GetReturnValue().Set(obj);
+}
+
+void getBody(Local<Name> name, const PropertyCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto exchange = getExchange(info);
+    if (exchange == nullptr) {
+        return;
+    }
+    const auto& body = exchange->body;
+    if (body.empty()) {
+        info.GetReturnValue().Set(v8::Null(isolate));
+        return;
+    }
+    auto arrBuf = ArrayBuffer::New(isolate, body.length());
+    memcpy(arrBuf->Data(), body.data(), body.length());
+    info.GetReturnValue().Set(Uint8Array::New(arrBuf, 0, body.length()));
+}
+
+void settleFulfilled(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto exchange = static_cast<HttpExchange*>(info.Data().As<External>()->Value());
+    if (exchange->conn == nullptr) {
+        releaseExchange(isolate, exchange);
+        return;
+    }
+    exchange->conn->complete(exchange, info[0], false);
+}
+
+void settleRejected(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    reportException(context, info[0]);
+    auto exchange = static_cast<HttpExchange*>(info.Data().As<External>()->Value());
+    if (exchange->conn == nullptr) {
+        releaseExchange(isolate, exchange);
+        return;
+    }
+    exchange->conn->complete(exchange, info[0], true);
+}
+
+void serve(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    BString hostname("0.0.0.0");
+    int port = 8000;
+    Local<Function> handler;
+    if (info.Length() >= 2) {
+        if (!checkFuncArgs<JS::Object, JS::Function>(info)) {
+            return;
+        }
+        auto options = info[0].As<Object>();
+        Local<Value> value;
+        if (fromObject(context, options, "hostname", value) && value->IsString()) {
+            hostname = toBString(context, value);
+        }
+        if (fromObject(context, options, "port", value) && !value->IsUndefined()) {
+            double num = -1;
+            if (value->IsNumber()) {
+                num = value.As<Number>()->Value();
+            }
+            if (num < 0 || num > 65535) {
+                throwTypeError(isolate, "'port' must be an integer between 0 and 65535");
+                return;
+            }
+            port = static_cast<int>(num);
+        }
+        handler = info[1].As<Function>();
+    } else {
+        if (!checkFuncArgs<JS::Function>(info)) {
+            return;
+        }
+        handler = info[0].As<Function>();
+    }
+    auto result = kun::sys::listenTcp(hostname, port);
+    if (!result) {
+        auto [code, name, phrase] = result.err();
+        throwTypeError(isolate, BString::format("{}({}) {}", name, code, phrase));
+        return;
+    }
+    auto env = Environment::from(context);
+    auto obj = createObject(context, "Kun.HttpServer", 1).ToLocalChecked();
+    new HttpServer(env, obj, handler, result.unwrap());
+    info.GetReturnValue().Set(obj);
+}
+
+void newHttpServer(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    throwTypeError(isolate, "Illegal constructor");
+}
+
+void closeServer(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto httpServer = InternalField<HttpServer>::get(info.This(), 0);
+    if (httpServer == nullptr) {
+        return;
+    }
+    httpServer->close();
+}
+
+void getServerAddr(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto httpServer = InternalField<HttpServer>::get(info.This(), 0);
+    if (httpServer == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    info.GetReturnValue().Set(getSocketAddress(context, httpServer->fd, false));
+}
+
+}
+
+namespace kun::api {
+
+void HttpExchange::detachFrom(const HttpExchange& exchange) {
+    const auto& src = exchange.head;
+    storage.append(exchange.base, src.headLength);
+    auto rebase = [this, &exchange](const BString& str) {
+        if (str.empty()) {
+            return BString();
+        }
+        return BString::view(storage.data() + (str.data() - exchange.base), str.length());
+    };
+    head.method = rebase(src.method);
+    head.target = rebase(src.target);
+    head.headers.reserve(src.headers.size());
+    for (const auto& header : src.headers) {
+        head.headers.push_back({rebase(header.name), rebase(header.value)});
+    }
+    head.versionMinor = src.versionMinor;
+    head.contentLength = src.contentLength;
+    head.headLength = src.headLength;
+    head.hasContentLength = src.hasContentLength;
+    head.chunked = src.chunked;
+    head.keepAlive = src.keepAlive;
+    body.append(exchange.body);
+    base = storage.data();
+}
+
+HttpConn::HttpConn(HttpServer* server, int fd) :
+    Channel(fd, ChannelType::READ_WRITE),
+    server(server)
+{
+
+}
+
+HttpConn::~HttpConn() = default;
+
+void HttpConn::onReadable() {
+    depth++;
+    bool eof = false;
+    while (!released && !closing && pending == nullptr && !isWriteBlocked()) {
+        auto len = readBuffer.length();
+        ensureSpace(readBuffer, READ_SIZE);
+        auto rc = ::read(fd, readBuffer.data() + len, readBuffer.capacity() - len);
+        if (rc > 0) {
+            readBuffer.resize(len + static_cast<size_t>(rc));
+            processRequests();
+            flush();
+            continue;
+        }
+        if (rc == 0) {
+            eof = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            eof = true;
+        }
+        break;
+    }
+    if (!released) {
+        flush();
+    }
+    updateReading();
+    if (eof && !released) {
+        closing = true;
+        if (isIdle()) {
+            release();
+        }
+    }
+    server->env->runMicrotask();
+    depth--;
+    if (released && depth == 0) {
+        delete this;
+    }
+}
+
+void HttpConn::onWritable() {
+    depth++;
+    flush();
+    if (!released && paused && !closing && pending == nullptr && !isWriteBlocked()) {
+        processRequests();
+        flush();
+        updateReading();
+        server->env->runMicrotask();
+    }
+    depth--;
+    if (released && depth == 0) {
+        delete this;
+    }
+}
+
+void HttpConn::onError() {
+    release();
+}
+
+void HttpConn::complete(HttpExchange* exchange, Local<Value> response, bool failed) {
+    auto isolate = server->env->getIsolate();
+    depth++;
+    pending = nullptr;
+    if (failed) {
+        writeError(500);
+    } else {
+        writeResponse(*exchange, response);
+    }
+    releaseExchange(isolate, exchange);
+    processRequests();
+    if (!released) {
+        flush();
+    }
+    updateReading();
+    depth--;
+    if (released && depth == 0) {
+        delete this;
+    }
+}
+
+void HttpConn::release() {
+    if (released) {
+        return;
+    }
+    released = true;
+    if (pending != nullptr) {
+        pending->conn = nullptr;
+        pending = nullptr;
+    }
+    server->env->getEventLoop()->removeChannel(this);
+    server->removeConn(this);
+    if (depth == 0) {
+        delete this;
+    }
+}
+
+bool HttpConn::isWriteBlocked() const {
+    return writeBuffer.length() - writeOffset > MAX_WRITE_BACKLOG;
+}
+
+void HttpConn::pauseReading() {
+    if (!paused) {
+        type = ChannelType::WRITE;
+        server->env->getEventLoop()->modifyChannel(this);
+        paused = true;
+    }
+}
+
+void HttpConn::resumeReading() {
+    if (paused) {
+        type = ChannelType::READ_WRITE;
+        server->env->getEventLoop()->modifyChannel(this);
+        paused = false;
+    }
+}
+
+void HttpConn::updateReading() {
+    if (released) {
+        return;
+    }
+    if (pending != nullptr || isWriteBlocked()) {
+        pauseReading();
+    } else if (!closing) {
+        resumeReading();
+    }
+}
+
+void HttpConn::processRequests() {
+    auto& head = exchange.head;
+    while (!released && !closing && pending == nullptr && !isWriteBlocked()) {
+        auto data = readBuffer.data() + readOffset;
+        auto len = readBuffer.length() - readOffset;
+        if (len == 0) {
+            break;
+        }
+        auto status = kun::parseHttpRequestHead(data, len, head);
+        if (status == HttpParseStatus::INCOMPLETE) {
+            if (len > MAX_HEAD_SIZE) {
+                writeError(431);
+            }
+            break;
+        }
+        if (status == HttpParseStatus::ERROR) {
+            writeError(400);
+            break;
+        }
+        auto consumed = head.headLength;
+        if (head.chunked) {
+            auto bodyStatus = kun::parseHttpChunkedBody(
+                data + consumed,
+                len - consumed,
+                chunkedBody,
+                chunkedOffset
+            );
+            if (bodyStatus == HttpParseStatus::INCOMPLETE) {
+                if (len - consumed > MAX_BODY_SIZE) {
+                    writeError(413);
+                }
+                break;
+            }
+            if (bodyStatus == HttpParseStatus::ERROR) {
+                writeError(400);
+                break;
+            }
+            exchange.body = BString::view(chunkedBody);
+            consumed += chunkedOffset;
+        } else if (head.contentLength > 0) {
+            if (head.contentLength > MAX_BODY_SIZE) {
+                writeError(413);
+                break;
+            }
+            if (len - consumed < head.contentLength) {
+                break;
+            }
+            exchange.body = BString::view(data + consumed, head.contentLength);
+            consumed += head.contentLength;
+        } else {
+            exchange.body = BString();
+        }
+        exchange.base = data;
+        readOffset += consumed;
+        dispatch();
+        chunkedBody.resize(0);
+        chunkedOffset = 0;
+    }
+    if (!released && pending == nullptr) {
+        auto remaining = readBuffer.length() - readOffset;
+        if (remaining > 0 && readOffset > 0) {
+            memmove(readBuffer.data(), readBuffer.data() + readOffset, remaining);
+        }
+        readBuffer.resize(remaining);
+        readOffset = 0;
+    }
+}
+
+void HttpConn::dispatch() {
+    auto env = server->env;
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    auto reqObj = server->requestTemplate.Get(isolate)->NewInstance(context).ToLocalChecked();
+    reqObj->SetAlignedPointerInInternalField(0, &exchange);
+    exchange.conn = this;
+    auto handler = server->handler.Get(isolate);
+    Local<Value> argv[] = {reqObj};
+    Local<Value> result;
+    {
+        TryCatch tryCatch(isolate);
+        if (!handler->Call(context, v8::Undefined(isolate), 1, argv).ToLocal(&result)) {
+            reqObj->SetAlignedPointerInInternalField(0, nullptr);
+            if (tryCatch.HasCaught()) {
+                reportException(context, tryCatch.Exception());
+            }
+            writeError(500);
+            return;
+        }
+    }
+    if (result->IsPromise()) {
+        auto promise = result.As<Promise>();
+        if (promise->State() != Promise::kFulfilled) {
+            auto detached = new HttpExchange();
+            detached->detachFrom(exchange);
+            detached->conn = this;
+            detached->request.Reset(isolate, reqObj);
+            reqObj->SetAlignedPointerInInternalField(0, detached);
+            pending = detached;
+            auto data = External::New(isolate, detached);
+            auto onFulfilled = Function::New(context, settleFulfilled, data).ToLocalChecked();
+            auto onRejected = Function::New(context, settleRejected, data).ToLocalChecked();
+            if (promise->Then(context, onFulfilled, onRejected).IsEmpty()) {
+                pending = nullptr;
+                releaseExchange(isolate, detached);
+                writeError(500);
+            }
+            return;
+        }
+        result = promise->Result();
+    }
+    reqObj->SetAlignedPointerInInternalField(0, nullptr);
+    writeResponse(exchange, result);
+}
+
+void HttpConn::writeResponse(const HttpExchange& exchange, Local<Value> response) {
+    auto isolate = server->env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = server->env->getContext();
+    int status = 200;
+    Local<Value> body = response;
+    Local<Object> headers;
+    if (
+        response->IsObject() &&
+        !response->IsArrayBufferView() &&
+        !response->IsArrayBuffer() &&
+        !response->IsStringObject()
+    ) {
+        auto obj = response.As<Object>();
+        double num = 0;
+        if (fromObject(context, obj, "status", num)) {
+            if (num < 100 || num > 999) {
+                writeError(500);
+                return;
+            }
+            status = static_cast<int>(num);
+        }
+        fromObject(context, obj, "headers", headers);
+        if (!fromObject(context, obj, "body", body)) {
+            body = v8::Undefined(isolate);
+        }
+    }
+    const char* bodyData = nullptr;
+    size_t bodyLength = 0;
+    Local<String> bodyStr;
+    const char* contentType = nullptr;
+    if (body->IsArrayBufferView()) {
+        auto view = body.As<ArrayBufferView>();
+        bodyData = static_cast<const char*>(view->Buffer()->Data()) + view->ByteOffset();
+        bodyLength = view->ByteLength();
+        contentType = "application/octet-stream";
+    } else if (body->IsArrayBuffer()) {
+        auto arrBuf = body.As<ArrayBuffer>();
+        bodyData = static_cast<const char*>(arrBuf->Data());
+        bodyLength = arrBuf->ByteLength();
+        contentType = "application/octet-stream";
+    } else if (!body->IsNullOrUndefined()) {
+        if (!body->ToString(context).ToLocal(&bodyStr)) {
+            writeError(500);
+            return;
+        }
+        bodyLength = bodyStr->Utf8Length(isolate);
+        contentType = "text/plain;charset=UTF-8";
+    }
+    const auto& head = exchange.head;
+    bool keepAlive = head.keepAlive && !closing;
+    bool hasBody = status >= 200 && status != 204 && status != 304;
+    bool isHead = head.method.length() == 4 && memcmp(head.method.data(), "HEAD", 4) == 0;
+    writeBuffer.append("HTTP/1.1 ", 9);
+    appendNumber(writeBuffer, static_cast<size_t>(status));
+    writeBuffer.append(" ", 1);
+    auto reason = getReasonPhrase(status);
+    writeBuffer.append(reason, strlen(reason));
+    writeBuffer.append("\r\n", 2);
+    bool hasContentType = false;
+    Local<Array> names;
+    if (!headers.IsEmpty() && headers->GetOwnPropertyNames(context).ToLocal(&names)) {
+        auto count = names->Length();
+        for (uint32_t i = 0; i < count; i++) {
+            Local<Value> key;
+            Local<Value> value;
+            if (
+                !names->Get(context, i).ToLocal(&key) ||
+                !headers->Get(context, key).ToLocal(&value)
+            ) {
+                continue;
+            }
+            auto name = toBString(context, key);
+            auto str = toBString(context, value);
+            if (hasLineBreak(name) || hasLineBreak(str) || isFramingHeader(name)) {
+                continue;
+            }
+            if (name.equalFold("content-type")) {
+                hasContentType = true;
+            }
+            writeBuffer.append(name);
+            writeBuffer.append(": ", 2);
+            writeBuffer.append(str);
+            writeBuffer.append("\r\n", 2);
+        }
+    }
+    if (hasBody) {
+        if (!hasContentType && contentType != nullptr) {
+            writeBuffer.append("content-type: ", 14);
+            writeBuffer.append(contentType, strlen(contentType));
+            writeBuffer.append("\r\n", 2);
+        }
+        writeBuffer.append("content-length: ", 16);
+        appendNumber(writeBuffer, bodyLength);
+        writeBuffer.append("\r\n", 2);
+    }
+    if (!keepAlive) {
+        closing = true;
+        writeBuffer.append("connection: close\r\n", 19);
+    } else if (head.versionMinor == 0) {
+        writeBuffer.append("connection: keep-alive\r\n", 24);
+    }
+    writeBuffer.append("\r\n", 2);
+    if (!hasBody || isHead || bodyLength == 0) {
+        return;
+    }
+    if (bodyData != nullptr) {
+        writeBuffer.append(bodyData, bodyLength);
+        return;
+    }
+    auto len = writeBuffer.length();
+    ensureSpace(writeBuffer, bodyLength);
+    bodyStr->WriteUtf8(
+        isolate,
+        writeBuffer.data() + len,
+        static_cast<int>(bodyLength),
+        nullptr,
+        String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8
+    );
+    writeBuffer.resize(len + bodyLength);
+}
+
+void HttpConn::writeError(int status) {
+    closing = true;
+    writeBuffer.append("HTTP/1.1 ", 9);
+    appendNumber(writeBuffer, static_cast<size_t>(status));
+    writeBuffer.append(" ", 1);
+    auto reason = getReasonPhrase(status);
+    writeBuffer.append(reason, strlen(reason));
+    writeBuffer.append("\r\ncontent-length: 0\r\nconnection: close\r\n\r\n", 42);
+}
+
+void HttpConn::flush() {
+    while (writeOffset < writeBuffer.length()) {
+        auto rc = ::send(
+            fd,
+            writeBuffer.data() + writeOffset,
+            writeBuffer.length() - writeOffset,
+            SEND_FLAGS
+        );
+        if (rc >= 0) {
+            writeOffset += static_cast<size_t>(rc);
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            release();
+        }
+        return;
+    }
+    writeBuffer.resize(0);
+    writeOffset = 0;
+    if (closing && pending == nullptr) {
+        release();
+    }
+}
+
+HttpServer::HttpServer(Environment* env, Local<Object> obj, Local<Function> handler, int fd) :
+    Channel(fd, ChannelType::READ),
+    env(env),
+    weakObject(obj, this),
+    internalField(this)
+{
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    internalField.set(obj, 0);
+    this->handler.Reset(isolate, handler);
+    auto objTmpl = ObjectTemplate::New(isolate);
+    objTmpl->SetInternalFieldCount(1);
+    objTmpl->SetLazyDataProperty(toV8String(isolate, "method"), getMethod);
+    objTmpl->SetLazyDataProperty(toV8String(isolate, "url"), getUrl);
+    objTmpl->SetLazyDataProperty(toV8String(isolate, "headers"), getHeaders);
+    objTmpl->SetLazyDataProperty(toV8String(isolate, "body"), getBody);
+    requestTemplate.Reset(isolate, objTmpl);
+    if (env->getEventLoop()->addChannel(this)) {
+        listening = true;
+        weakObject.ref();
+    }
+}
+
+HttpServer::~HttpServer() {
+    if (listening) {
+        env->getEventLoop()->removeChannel(this);
+    }
+}
+
+void HttpServer::onReadable() {
+    while (listening) {
+        auto result = kun::sys::acceptTcp(fd);
+        if (!result) {
+            auto errCode = result.err().code;
+            if (errCode == EINTR || errCode == ECONNABORTED) {
+                continue;
+            }
+            if (errCode != EAGAIN && errCode != EWOULDBLOCK) {
+                KUN_LOG_ERR(errCode);
+            }
+            break;
+        }
+        auto conn = new HttpConn(this, result.unwrap());
+        if (!env->getEventLoop()->addChannel(conn)) {
+            delete conn;
+            continue;
+        }
+        conns.insert(conn);
+    }
+}
+
+void HttpServer::close() {
+    if (!listening) {
+        return;
+    }
+    listening = false;
+    env->getEventLoop()->removeChannel(this);
+    if (::close(fd) == -1) {
+        KUN_LOG_ERR(errno);
+    }
+    fd = KUN_INVALID_FD;
+    std::vector<HttpConn*> list(conns.begin(), conns.end());
+    for (auto conn : list) {
+        if (conn->isIdle()) {
+            conn->release();
+        } else {
+            conn->closing = true;
+        }
+    }
+    if (conns.empty()) {
+        weakObject.unref();
+    }
+}
+
+void HttpServer::removeConn(HttpConn* conn) {
+    if (conns.erase(conn) > 0 && !listening && conns.empty()) {
+        weakObject.unref();
+    }
+}
+
+}
+
+#endif
+
+namespace kun::api {
+
+void exposeHttp(Local<Context> context, ExposedScope exposedScope) {
+    #ifdef KUN_PLATFORM_UNIX
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    Local<Object> kunObj;
+    if (!fromObject(context, globalThis, KUN_NAME, kunObj)) {
+        KUN_LOG_ERR("'{}' not found", KUN_NAME);
+        return;
+    }
+    setFunction(context, kunObj, "serve", serve);
+    auto funcTmpl = FunctionTemplate::New(isolate);
+    auto protoTmpl = funcTmpl->PrototypeTemplate();
+    auto exposedName = toV8String(isolate, "HttpServer");
+    funcTmpl->SetClassName(exposedName);
+    funcTmpl->SetCallHandler(newHttpServer);
+    setToStringTag(isolate, protoTmpl, exposedName);
+    setFunction(isolate, protoTmpl, "close", closeServer);
+    auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+    auto proto = getPrototypeOf(context, func).ToLocalChecked();
+    defineAccessor(context, proto, "addr", {getServerAddr});
+    kunObj->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    #endif
+}
+
+void registerHttpReferences(std::vector<intptr_t>& references) {
+    #ifdef KUN_PLATFORM_UNIX
+    addReferences(references, {
+        serve,
+        newHttpServer,
+        closeServer,
+        getServerAddr,
+        settleFulfilled,
+        settleRejected
+    });
+    for (auto getter : {getMethod, getUrl, getHeaders, getBody}) {
+        references.push_back(reinterpret_cast<intptr_t>(getter));
+    }
+    #endif
+}
+
+}
@@ -0,0 +1,137 @@
+#ifndef KUN_API_HTTP_H
+#define KUN_API_HTTP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <unordered_set>
+#include <vector>
+
+#include "v8.h"
+#include "env/environment.h"
+#include "loop/channel.h"
+#include "util/bstring.h"
+#include "util/constants.h"
+#include "util/http_parser.h"
+#include "util/internal_field.h"
+#include "util/weak_object.h"
+
+namespace kun::api {
+
+class HttpConn;
+class HttpServer;
+
+class HttpExchange {
+public:
+    HttpExchange(const HttpExchange&) = delete;
+
+    HttpExchange& operator=(const HttpExchange&) = delete;
+
+    HttpExchange(HttpExchange&&) = delete;
+
+    HttpExchange& operator=(HttpExchange&&) = delete;
+
+    HttpExchange() = default;
+
+    ~HttpExchange() = default;
+
+    void detachFrom(const HttpExchange& exchange);
+
+    HttpConn* conn{nullptr};
+    HttpRequestHead head;
+    BString body;
+    BString storage;
+    const char* base{nullptr};
+    v8::Global<v8::Object> request;
+};
+
+class HttpConn : public Channel {
+public:
+    HttpConn(HttpServer* server, KUN_FD_TYPE fd);
+
+    ~HttpConn() override;
+
+    void onReadable() override final;
+
+    void onWritable() override final;
+
+    void onError() override final;
+
+    void complete(HttpExchange* exchange, v8::Local<v8::Value> response, bool failed);
+
+    bool isIdle() const {
+        return pending == nullptr && writeOffset >= writeBuffer.length();
+    }
+
+    void release();
+
+    HttpServer* server;
+    bool closing{false};
+
+private:
+    bool isWriteBlocked() const;
+
+    void pauseReading();
+
+    void resumeReading();
+
+    void updateReading();
+
+    void processRequests();
+
+    void dispatch();
+
+    void writeResponse(const HttpExchange& exchange, v8::Local<v8::Value> response);
+
+    void writeError(int status);
+
+    void flush();
+
+    BString readBuffer;
+    BString writeBuffer;
+    BString chunkedBody;
+    size_t chunkedOffset{0};
+    size_t readOffset{0};
+    size_t writeOffset{0};
+    HttpExchange exchange;
+    HttpExchange* pending{nullptr};
+    int depth{0};
+    bool paused{false};
+    bool released{false};
+};
+
+class HttpServer : public Channel {
+public:
+    HttpServer(
+        Environment* env,
+        v8::Local<v8::Object> obj,
+        v8::Local<v8::Function> handler,
+        KUN_FD_TYPE fd
+    );
+
+    ~HttpServer() override;
+
+    void onReadable() override final;
+
+    void close();
+
+    void removeConn(HttpConn* conn);
+
+    Environment* env;
+    WeakObject<HttpServer> weakObject;
+    InternalField<HttpServer> internalField;
+    v8::Global<v8::Function> handler;
+    v8::Global<v8::ObjectTemplate> requestTemplate;
+
+private:
+    std::unordered_set<HttpConn*> conns;
+    bool listening{false};
+};
+
+void exposeHttp(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerHttpReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
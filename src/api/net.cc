@@ -0,0 +1,824 @@
+#include "api/net.h"
+
+#include "util/constants.h"
+
+#ifdef KUN_PLATFORM_UNIX
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "loop/async_request.h"
+#include "loop/event_loop.h"
+#include "sys/net.h"
+#include "util/bstring.h"
+#include "util/js_utils.h"
+#include "util/scope_guard.h"
+#include "util/sys_err.h"
+#include "util/utils.h"
+#include "util/v8_utils.h"
+
+KUN_V8_USINGS;
+
+using v8::ArrayBufferView;
+using v8::Exception;
+using v8::Integer;
+using kun::AsyncRequest;
+using kun::BString;
+using kun::Environment;
+using kun::InternalField;
+using kun::JS;
+using kun::SysErr;
+using kun::api::TcpConn;
+using kun::api::TcpListener;
+using kun::api::getSocketAddress;
+using kun::util::addReferences;
+using kun::util::checkFuncArgs;
+using kun::util::createObject;
+using kun::util::defineAccessor;
+using kun::util::fromObject;
+using kun::util::getPrototypeOf;
+using kun::util::setFunction;
+using kun::util::setToStringTag;
+using kun::util::submitAsyncRequest;
+using kun::util::throwTypeError;
+using kun::util::toBString;
+using kun::util::toV8String;
+
+#ifdef KUN_PLATFORM_UNIX
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+inline bool isConnectRetryable(int errCode) {
+    return (
+        errCode == ECONNREFUSED ||
+        errCode == ENETUNREACH ||
+        errCode == EHOSTUNREACH ||
+        errCode == EAFNOSUPPORT ||
+        errCode == EADDRNOTAVAIL
+    );
+}
+
+Local<Value> toSysError(Isolate* isolate, int errCode) {
+    EscapableHandleScope handleScope(isolate);
+    auto [code, name, phrase] = SysErr(errCode);
+    auto errStr = BString::format("{}({}) {}", name, code, phrase);
+    auto v8Str = toV8String(isolate, errStr);
+    return handleScope.Escape(Exception::TypeError(v8Str));
+}
+
+void rejectSysErr(Local<Context> context, Local<Promise::Resolver> resolver, int errCode) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    resolver->Reject(context, toSysError(isolate, errCode)).Check();
+}
+
+void rejectGaiErr(Local<Context> context, Local<Promise::Resolver> resolver, int errCode) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto errStr = ::gai_strerror(errCode);
+    auto v8Str = toV8String(isolate, BString::view(errStr, strlen(errStr)));
+    resolver->Reject(context, Exception::TypeError(v8Str)).Check();
+}
+
+bool getNetOptions(
+    const FunctionCallbackInfo<Value>& info,
+    BString& hostname,
+    int& port
+) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Object>(info)) {
+        return false;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto options = info[0].As<Object>();
+    Local<Value> value;
+    if (fromObject(context, options, "hostname", value) && value->IsString()) {
+        hostname = toBString(context, value);
+    }
+    double num = 0;
+    if (!fromObject(context, options, "port", num) || num < 0 || num > 65535) {
+        throwTypeError(isolate, "'port' must be an integer between 0 and 65535");
+        return false;
+    }
+    port = static_cast<int>(num);
+    return true;
+}
+
+Local<Promise> newPromise(
+    const FunctionCallbackInfo<Value>& info,
+    Local<Promise::Resolver>& resolver
+) {
+    auto isolate = info.GetIsolate();
+    auto context = isolate->GetCurrentContext();
+    resolver = Promise::Resolver::New(context).ToLocalChecked();
+    return resolver->GetPromise();
+}
+
+void handleResolveAddress(AsyncRequest& req) {
+    auto hostname = req.get<char*>(0);
+    auto port = req.get<int>(1);
+    ON_SCOPE_EXIT {
+        delete[] hostname;
+    };
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    auto service = BString::format("{}", port);
+    struct addrinfo* ai = nullptr;
+    auto rc = ::getaddrinfo(hostname, service.c_str(), &hints, &ai);
+    if (rc == 0) {
+        req.set(0, ai);
+    } else {
+        req.set(0, nullptr);
+        req.set(1, rc);
+    }
+}
+
+void resolveConnect(Local<Context> context, AsyncRequest& req) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto resolver = req.getResolver(isolate);
+    auto ai = req.get<struct addrinfo*>(0);
+    if (ai == nullptr) {
+        rejectGaiErr(context, resolver, req.get<int>(1));
+        return;
+    }
+    auto env = Environment::from(context);
+    auto obj = createObject(context, "Kun.net.TcpConn", 1).ToLocalChecked();
+    auto tcpConn = new TcpConn(env, obj, KUN_INVALID_FD);
+    tcpConn->connect(resolver, ai);
+}
+
+void listen(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    BString hostname("0.0.0.0");
+    int port = 0;
+    if (!getNetOptions(info, hostname, port)) {
+        return;
+    }
+    auto result = kun::sys::listenTcp(hostname, port);
+    if (!result) {
+        auto [code, name, phrase] = result.err();
+        throwTypeError(isolate, BString::format("{}({}) {}", name, code, phrase));
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto env = Environment::from(context);
+    auto obj = createObject(context, "Kun.net.TcpListener", 1).ToLocalChecked();
+    new TcpListener(env, obj, result.unwrap());
+    info.GetReturnValue().Set(obj);
+}
+
+void connect(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    BString hostname("127.0.0.1");
+    int port = 0;
+    if (!getNetOptions(info, hostname, port)) {
+        return;
+    }
+    auto buf = new char[hostname.length() + 1];
+    memcpy(buf, hostname.data(), hostname.length());
+    buf[hostname.length()] = '\0';
+    AsyncRequest req(handleResolveAddress, resolveConnect);
+    req.set(0, buf);
+    req.set(1, port);
+    submitAsyncRequest(info, std::move(req));
+}
+
+void newTcpListener(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    throwTypeError(isolate, "Illegal constructor");
+}
+
+void accept(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpListener = InternalField<TcpListener>::get(info.This(), 0);
+    if (tcpListener == nullptr) {
+        return;
+    }
+    Local<Promise::Resolver> resolver;
+    auto promise = newPromise(info, resolver);
+    tcpListener->accept(resolver);
+    info.GetReturnValue().Set(promise);
+}
+
+void closeListener(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpListener = InternalField<TcpListener>::get(info.This(), 0);
+    if (tcpListener == nullptr) {
+        return;
+    }
+    tcpListener->close();
+}
+
+void getListenerAddr(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpListener = InternalField<TcpListener>::get(info.This(), 0);
+    if (tcpListener == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    info.GetReturnValue().Set(getSocketAddress(context, tcpListener->fd, false));
+}
+
+void newTcpConn(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    throwTypeError(isolate, "Illegal constructor");
+}
+
+void read(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpConn = InternalField<TcpConn>::get(info.This(), 0);
+    if (tcpConn == nullptr) {
+        return;
+    }
+    if (!checkFuncArgs<JS::Uint8Array>(info)) {
+        return;
+    }
+    Local<Promise::Resolver> resolver;
+    auto promise = newPromise(info, resolver);
+    tcpConn->read(resolver, info[0].As<ArrayBufferView>());
+    info.GetReturnValue().Set(promise);
+}
+
+void write(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpConn = InternalField<TcpConn>::get(info.This(), 0);
+    if (tcpConn == nullptr) {
+        return;
+    }
+    if (!checkFuncArgs<JS::Uint8Array>(info)) {
+        return;
+    }
+    Local<Promise::Resolver> resolver;
+    auto promise = newPromise(info, resolver);
+    tcpConn->write(resolver, info[0].As<ArrayBufferView>());
+    info.GetReturnValue().Set(promise);
+}
+
+void closeConn(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpConn = InternalField<TcpConn>::get(info.This(), 0);
+    if (tcpConn == nullptr) {
+        return;
+    }
+    tcpConn->close();
+}
+
+void getLocalAddr(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpConn = InternalField<TcpConn>::get(info.This(), 0);
+    if (tcpConn == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    info.GetReturnValue().Set(getSocketAddress(context, tcpConn->fd, false));
+}
+
+void getRemoteAddr(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto tcpConn = InternalField<TcpConn>::get(info.This(), 0);
+    if (tcpConn == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    info.GetReturnValue().Set(getSocketAddress(context, tcpConn->fd, true));
+}
+
+}
+
+namespace kun::api {
+
+Local<Value> getSocketAddress(Local<Context> context, KUN_FD_TYPE fd, bool peer) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    struct sockaddr_storage addr;
+    socklen_t addrLen = sizeof(addr);
+    auto rc = peer ?
+        ::getpeername(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) :
+        ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen);
+    if (rc == -1) {
+        return handleScope.Escape(v8::Null(isolate));
+    }
+    char host[INET6_ADDRSTRLEN]{};
+    int port = 0;
+    if (addr.ss_family == AF_INET6) {
+        auto sin6 = reinterpret_cast<struct sockaddr_in6*>(&addr);
+        ::inet_ntop(AF_INET6, &sin6->sin6_addr, host, sizeof(host));
+        port = ntohs(sin6->sin6_port);
+    } else {
+        auto sin = reinterpret_cast<struct sockaddr_in*>(&addr);
+        ::inet_ntop(AF_INET, &sin->sin_addr, host, sizeof(host));
+        port = ntohs(sin->sin_port);
+    }
+    auto obj = Object::New(isolate);
+    obj->Set(
+        context,
+        toV8String(isolate, "hostname"),
+        toV8String(isolate, BString::view(host, strlen(host)))
+    ).Check();
+    obj->Set(
+        context,
+        toV8String(isolate, "port"),
+        Integer::New(isolate, port)
+    ).Check();
+    return handleScope.Escape(obj);
+}
+
+TcpListener::TcpListener(Environment* env, Local<Object> obj, int fd) :
+    Channel(fd, ChannelType::READ),
+    env(env),
+    weakObject(obj, this),
+    internalField(this)
+{
+    internalField.set(obj, 0);
+}
+
+TcpListener::~TcpListener() {
+    unwatch();
+}
+
+void TcpListener::onReadable() {
+    tryAccept();
+    env->runMicrotask();
+    if (acceptResolvers.empty()) {
+        unwatch();
+    }
+}
+
+void TcpListener::accept(Local<Promise::Resolver> resolver) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    if (fd == KUN_INVALID_FD) {
+        rejectSysErr(env->getContext(), resolver, EBADF);
+        return;
+    }
+    acceptResolvers.emplace_back(isolate, resolver);
+    if (acceptResolvers.size() == 1) {
+        tryAccept();
+    }
+}
+
+void TcpListener::close() {
+    if (fd == KUN_INVALID_FD) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (watched) {
+        env->getEventLoop()->removeChannel(this);
+    }
+    if (::close(fd) == -1) {
+        KUN_LOG_ERR(errno);
+    }
+    fd = KUN_INVALID_FD;
+    while (!acceptResolvers.empty()) {
+        auto resolver = acceptResolvers.front().Get(isolate);
+        acceptResolvers.pop_front();
+        rejectSysErr(context, resolver, ECANCELED);
+    }
+    if (watched) {
+        watched = false;
+        weakObject.unref();
+    }
+}
+
+void TcpListener::tryAccept() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    while (!acceptResolvers.empty() && fd != KUN_INVALID_FD) {
+        auto result = kun::sys::acceptTcp(fd);
+        if (!result) {
+            auto errCode = result.err().code;
+            if (errCode == EINTR || errCode == ECONNABORTED) {
+                continue;
+            }
+            if (errCode == EAGAIN || errCode == EWOULDBLOCK) {
+                watch();
+                return;
+            }
+            auto resolver = acceptResolvers.front().Get(isolate);
+            acceptResolvers.pop_front();
+            rejectSysErr(context, resolver, errCode);
+            continue;
+        }
+        auto obj = createObject(context, "Kun.net.TcpConn", 1).ToLocalChecked();
+        new TcpConn(env, obj, result.unwrap());
+        auto resolver = acceptResolvers.front().Get(isolate);
+        acceptResolvers.pop_front();
+        resolver->Resolve(context, obj).Check();
+    }
+}
+
+void TcpListener::watch() {
+    if (!watched && env->getEventLoop()->addChannel(this)) {
+        watched = true;
+        weakObject.ref();
+    }
+}
+
+void TcpListener::unwatch() {
+    if (watched) {
+        env->getEventLoop()->removeChannel(this);
+        watched = false;
+        weakObject.unref();
+    }
+}
+
+TcpConn::TcpConn(Environment* env, Local<Object> obj, int fd) :
+    Channel(fd, ChannelType::READ_WRITE),
+    env(env),
+    weakObject(obj, this),
+    internalField(this)
+{
+    internalField.set(obj, 0);
+}
+
+TcpConn::~TcpConn() {
+    unwatch();
+    if (addrList != nullptr) {
+        ::freeaddrinfo(addrList);
+    }
+}
+
+void TcpConn::onReadable() {
+    if (connectResolver.IsEmpty()) {
+        tryRead();
+    }
+    env->runMicrotask();
+    if (!readOp.isPending() && !writeOp.isPending() && connectResolver.IsEmpty()) {
+        unwatch();
+    }
+}
+
+void TcpConn::onWritable() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    if (!connectResolver.IsEmpty()) {
+        int errCode = 0;
+        socklen_t len = sizeof(errCode);
+        if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &errCode, &len) == -1) {
+            errCode = errno;
+        }
+        if (errCode == 0) {
+            finishConnect(0);
+            tryRead();
+        } else {
+            tryConnect(errCode);
+        }
+    }
+    if (connectResolver.IsEmpty()) {
+        tryWrite();
+    }
+    env->runMicrotask();
+    if (!readOp.isPending() && !writeOp.isPending() && connectResolver.IsEmpty()) {
+        unwatch();
+    }
+}
+
+void TcpConn::onError() {
+    int errCode = 0;
+    socklen_t len = sizeof(errCode);
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &errCode, &len) == -1 || errCode == 0) {
+        errCode = ECONNRESET;
+    }
+    if (!connectResolver.IsEmpty()) {
+        tryConnect(errCode);
+        env->runMicrotask();
+        if (!connectResolver.IsEmpty()) {
+            return;
+        }
+    } else {
+        failAll(errCode);
+        env->runMicrotask();
+    }
+    unwatch();
+}
+
+void TcpConn::connect(Local<Promise::Resolver> resolver, struct addrinfo* ai) {
+    auto isolate = env->getIsolate();
+    connectResolver.Reset(isolate, resolver);
+    addrList = ai;
+    nextAddr = ai;
+    tryConnect(ECONNREFUSED);
+}
+
+void TcpConn::tryConnect(int errCode) {
+    while (nextAddr != nullptr && (fd == KUN_INVALID_FD || isConnectRetryable(errCode))) {
+        auto ai = nextAddr;
+        nextAddr = ai->ai_next;
+        if (fd != KUN_INVALID_FD) {
+            unwatch();
+            if (::close(fd) == -1) {
+                KUN_LOG_ERR(errno);
+            }
+            fd = KUN_INVALID_FD;
+        }
+        auto result = kun::sys::createSocket(ai->ai_family);
+        if (!result) {
+            errCode = result.err().code;
+            continue;
+        }
+        fd = result.unwrap();
+        kun::sys::setNoDelay(fd);
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            finishConnect(0);
+            return;
+        }
+        if (errno == EINPROGRESS) {
+            watch();
+            return;
+        }
+        errCode = errno;
+    }
+    finishConnect(errCode);
+}
+
+void TcpConn::finishConnect(int errCode) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (addrList != nullptr) {
+        ::freeaddrinfo(addrList);
+        addrList = nullptr;
+        nextAddr = nullptr;
+    }
+    auto resolver = connectResolver.Get(isolate);
+    connectResolver.Reset();
+    if (errCode == 0) {
+        resolver->Resolve(context, weakObject.get()).Check();
+    } else {
+        rejectSysErr(context, resolver, errCode);
+        close();
+    }
+}
+
+void TcpConn::read(Local<Promise::Resolver> resolver, Local<ArrayBufferView> view) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (fd == KUN_INVALID_FD) {
+        rejectSysErr(context, resolver, EBADF);
+        return;
+    }
+    if (readOp.isPending()) {
+        rejectSysErr(context, resolver, EBUSY);
+        return;
+    }
+    if (view->ByteLength() == 0) {
+        resolver->Resolve(context, Integer::New(isolate, 0)).Check();
+        return;
+    }
+    readOp.resolver.Reset(isolate, resolver);
+    readOp.store = view->Buffer()->GetBackingStore();
+    readOp.offset = view->ByteOffset();
+    readOp.length = view->ByteLength();
+    if (connectResolver.IsEmpty()) {
+        tryRead();
+    }
+}
+
+void TcpConn::write(Local<Promise::Resolver> resolver, Local<ArrayBufferView> view) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (fd == KUN_INVALID_FD) {
+        rejectSysErr(context, resolver, EBADF);
+        return;
+    }
+    if (writeOp.isPending()) {
+        rejectSysErr(context, resolver, EBUSY);
+        return;
+    }
+    writeOp.resolver.Reset(isolate, resolver);
+    writeOp.store = view->Buffer()->GetBackingStore();
+    writeOp.offset = view->ByteOffset();
+    writeOp.length = view->ByteLength();
+    if (connectResolver.IsEmpty()) {
+        tryWrite();
+    }
+}
+
+void TcpConn::close() {
+    if (fd == KUN_INVALID_FD) {
+        return;
+    }
+    if (watched) {
+        env->getEventLoop()->removeChannel(this);
+    }
+    if (::close(fd) == -1) {
+        KUN_LOG_ERR(errno);
+    }
+    fd = KUN_INVALID_FD;
+    failAll(ECANCELED);
+    if (watched) {
+        watched = false;
+        weakObject.unref();
+    }
+}
+
+void TcpConn::tryRead() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    while (readOp.isPending()) {
+        auto rc = ::read(fd, readOp.data(), readOp.remaining());
+        if (rc >= 0) {
+            auto resolver = readOp.resolver.Get(isolate);
+            readOp.reset();
+            if (rc == 0) {
+                resolver->Resolve(context, v8::Null(isolate)).Check();
+            } else {
+                resolver->Resolve(context, Number::New(isolate, static_cast<double>(rc))).Check();
+            }
+            return;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            watch();
+            return;
+        }
+        auto resolver = readOp.resolver.Get(isolate);
+        readOp.reset();
+        rejectSysErr(context, resolver, errno);
+    }
+}
+
+void TcpConn::tryWrite() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    while (writeOp.isPending()) {
+        if (writeOp.remaining() == 0) {
+            auto resolver = writeOp.resolver.Get(isolate);
+            auto len = static_cast<double>(writeOp.length);
+            writeOp.reset();
+            resolver->Resolve(context, Number::New(isolate, len)).Check();
+            return;
+        }
+        auto rc = ::send(fd, writeOp.data(), writeOp.remaining(), SEND_FLAGS);
+        if (rc >= 0) {
+            writeOp.done += static_cast<size_t>(rc);
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            watch();
+            return;
+        }
+        auto resolver = writeOp.resolver.Get(isolate);
+        writeOp.reset();
+        rejectSysErr(context, resolver, errno);
+    }
+}
+
+void TcpConn::watch() {
+    if (!watched && env->getEventLoop()->addChannel(this)) {
+        watched = true;
+        weakObject.ref();
+    }
+}
+
+void TcpConn::unwatch() {
+    if (watched) {
+        env->getEventLoop()->removeChannel(this);
+        watched = false;
+        weakObject.unref();
+    }
+}
+
+void TcpConn::failAll(int errCode) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (!connectResolver.IsEmpty()) {
+        auto resolver = connectResolver.Get(isolate);
+        connectResolver.Reset();
+        rejectSysErr(context, resolver, errCode);
+    }
+    if (readOp.isPending()) {
+        auto resolver = readOp.resolver.Get(isolate);
+        readOp.reset();
+        if (errCode == ECANCELED) {
+            resolver->Resolve(context, v8::Null(isolate)).Check();
+        } else {
+            rejectSysErr(context, resolver, errCode);
+        }
+    }
+    if (writeOp.isPending()) {
+        auto resolver = writeOp.resolver.Get(isolate);
+        writeOp.reset();
+        rejectSysErr(context, resolver, errCode);
+    }
+}
+
+}
+
+#endif
+
+namespace kun::api {
+
+void exposeNet(Local<Context> context, ExposedScope exposedScope) {
+    #ifdef KUN_PLATFORM_UNIX
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    Local<Object> kunObj;
+    if (!fromObject(context, globalThis, KUN_NAME, kunObj)) {
+        KUN_LOG_ERR("'{}' not found", KUN_NAME);
+        return;
+    }
+    auto netObj = Object::New(isolate);
+    setFunction(context, netObj, "listen", listen);
+    setFunction(context, netObj, "connect", connect);
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto exposedName = toV8String(isolate, "TcpListener");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(newTcpListener);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "accept", accept);
+        setFunction(isolate, protoTmpl, "close", closeListener);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "addr", {getListenerAddr});
+        netObj->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto exposedName = toV8String(isolate, "TcpConn");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(newTcpConn);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "read", read);
+        setFunction(isolate, protoTmpl, "write", write);
+        setFunction(isolate, protoTmpl, "close", closeConn);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "localAddr", {getLocalAddr});
+        defineAccessor(context, proto, "remoteAddr", {getRemoteAddr});
+        netObj->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    kunObj->DefineOwnProperty(
+        context,
+        toV8String(isolate, "net"),
+        netObj,
+        v8::ReadOnly
+    ).Check();
+    #endif
+}
+
+void registerNetReferences(std::vector<intptr_t>& references) {
+    #ifdef KUN_PLATFORM_UNIX
+    addReferences(references, {
+        listen,
+        connect,
+        newTcpListener,
+        accept,
+        closeListener,
+        getListenerAddr,
+        newTcpConn,
+        read,
+        write,
+        closeConn,
+        getLocalAddr,
+        getRemoteAddr
+    });
+    #endif
+}
+
+}
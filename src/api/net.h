@@ -0,0 +1,149 @@
+#ifndef KUN_API_NET_H
+#define KUN_API_NET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "v8.h"
+#include "env/environment.h"
+#include "loop/channel.h"
+#include "util/constants.h"
+#include "util/internal_field.h"
+#include "util/weak_object.h"
+
+struct addrinfo;
+
+namespace kun::api {
+
+class NetOp {
+public:
+    NetOp(const NetOp&) = delete;
+
+    NetOp& operator=(const NetOp&) = delete;
+
+    NetOp(NetOp&&) = delete;
+
+    NetOp& operator=(NetOp&&) = delete;
+
+    NetOp() = default;
+
+    ~NetOp() = default;
+
+    bool isPending() const {
+        return !resolver.IsEmpty();
+    }
+
+    char* data() const {
+        return static_cast<char*>(store->Data()) + offset + done;
+    }
+
+    size_t remaining() const {
+        return length - done;
+    }
+
+    void reset() {
+        resolver.Reset();
+        store.reset();
+        offset = 0;
+        length = 0;
+        done = 0;
+    }
+
+    v8::Global<v8::Promise::Resolver> resolver;
+    std::shared_ptr<v8::BackingStore> store;
+    size_t offset{0};
+    size_t length{0};
+    size_t done{0};
+};
+
+class TcpListener : public Channel {
+public:
+    TcpListener(Environment* env, v8::Local<v8::Object> obj, KUN_FD_TYPE fd);
+
+    ~TcpListener() override;
+
+    void onReadable() override final;
+
+    void accept(v8::Local<v8::Promise::Resolver> resolver);
+
+    void close();
+
+    Environment* env;
+    WeakObject<TcpListener> weakObject;
+    InternalField<TcpListener> internalField;
+
+private:
+    void tryAccept();
+
+    void watch();
+
+    void unwatch();
+
+    std::deque<v8::Global<v8::Promise::Resolver>> acceptResolvers;
+    bool watched{false};
+};
+
+class TcpConn : public Channel {
+public:
+    TcpConn(Environment* env, v8::Local<v8::Object> obj, KUN_FD_TYPE fd);
+
+    ~TcpConn() override;
+
+    void onReadable() override final;
+
+    void onWritable() override final;
+
+    void onError() override final;
+
+    void connect(v8::Local<v8::Promise::Resolver> resolver, struct addrinfo* ai);
+
+    void read(v8::Local<v8::Promise::Resolver> resolver, v8::Local<v8::ArrayBufferView> view);
+
+    void write(v8::Local<v8::Promise::Resolver> resolver, v8::Local<v8::ArrayBufferView> view);
+
+    void close();
+
+    Environment* env;
+    WeakObject<TcpConn> weakObject;
+    InternalField<TcpConn> internalField;
+
+private:
+    void tryConnect(int errCode);
+
+    void finishConnect(int errCode);
+
+    void tryRead();
+
+    void tryWrite();
+
+    void watch();
+
+    void unwatch();
+
+    void failAll(int errCode);
+
+    NetOp readOp;
+    NetOp writeOp;
+    v8::Global<v8::Promise::Resolver> connectResolver;
+    struct addrinfo* addrList{nullptr};
+    struct addrinfo* nextAddr{nullptr};
+    bool watched{false};
+};
+
+v8::Local<v8::Value> getSocketAddress(
+    v8::Local<v8::Context> context,
+    KUN_FD_TYPE fd,
+    bool peer
+);
+
+void exposeNet(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerNetReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
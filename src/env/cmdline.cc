@@ -35,11 +35,46 @@ void printVersion(int optionName, const BString& optionValue);
 void checkValue(int optionName, const BString& optionValue);
 
 Option OPTIONS[] = {
+    {
+        nullptr, "--build-snapshot", nullptr,
+        "build the startup snapshot and exit",
+        nullptr
+    },
+    {
+        nullptr, "--compile", "",
+        "compile the script and its imports into an image and exit",
+        checkValue
+    },
     {
         "-h", "--help", nullptr,
         "print command line options",
         printHelp
     },
+    {
+        nullptr, "--io-backend", "threadpool",
+        "set the file io backend, 'threadpool' or 'uring'",
+        checkValue
+    },
+    {
+        nullptr, "--no-code-cache", nullptr,
+        "disable the code cache of modules",
+        nullptr
+    },
+    {
+        nullptr, "--no-snapshot", nullptr,
+        "start without the startup snapshot",
+        nullptr
+    },
+    {
+        nullptr, "--stdio-backlog", "8388608",
+        "set the max bytes queued for stdout/stderr when they are non-blocking pipes",
+        checkValue
+    },
+    {
+        nullptr, "--stdio-policy", "block",
+        "set the policy when the stdio backlog is full, 'block' or 'drop'",
+        checkValue
+    },
     {
         nullptr, "--thread-pool-size", "4",
         "set the thread pool size",
@@ -58,7 +93,7 @@ Option OPTIONS[] = {
 };
 
 void printHelp(int optionName, const BString& optionValue) {
-    println("Usage: kun [options] [script.js] [arguments]\n");
+    println("Usage: kun [options] [script.js | image.kimg] [arguments]\n");
     println("Options:");
     constexpr int n = sizeof(OPTIONS) / sizeof(Option);
     for (int i = 0; i < n; i++) {
@@ -94,7 +129,31 @@ void checkValue(int optionName, const BString& optionValue) {
         return;
     }
     const auto& option = OPTIONS[optionName];
-    if (optionName == Cmdline::THREAD_POOL_SIZE) {
+    if (optionName == Cmdline::COMPILE) {
+        if (!optionValue.endsWith(".kimg")) {
+            eprintln("'{}' requires a path ending with '.kimg'", option.longName);
+            ::exit(EXIT_FAILURE);
+        }
+    } else if (optionName == Cmdline::IO_BACKEND) {
+        if (optionValue != "threadpool" && optionValue != "uring") {
+            eprintln("'{}' requires 'threadpool' or 'uring'", option.longName);
+            ::exit(EXIT_FAILURE);
+        }
+    } else if (optionName == Cmdline::STDIO_BACKLOG) {
+        auto first = optionValue.data();
+        auto last = first + optionValue.length();
+        size_t value = 0;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec != std::errc() || value == 0) {
+            eprintln("'{}' requires a positive integer", option.longName);
+            ::exit(EXIT_FAILURE);
+        }
+    } else if (optionName == Cmdline::STDIO_POLICY) {
+        if (optionValue != "block" && optionValue != "drop") {
+            eprintln("'{}' requires 'block' or 'drop'", option.longName);
+            ::exit(EXIT_FAILURE);
+        }
+    } else if (optionName == Cmdline::THREAD_POOL_SIZE) {
         auto first = optionValue.data();
         auto last = first + optionValue.length();
         int value = 0;
@@ -155,15 +214,15 @@ Cmdline::Cmdline(int argc, char** argv) {
     bool scriptFound = false;
     for (int i = 1; i < argc; i++) {
         auto name = BString::view(argv[i], strlen(argv[i]));
-        if (name.endsWith(".js")) {
-            scriptPath = toAbsolutePath(name).unwrap();
-            scriptFound = true;
-            continue;
-        }
         if (scriptFound) {
             arguments.emplace_back(name.data(), name.length());
             continue;
         }
+        if (!name.startsWith("-") && (name.endsWith(".js") || name.endsWith(".kimg"))) {
+            scriptPath = toAbsolutePath(name).unwrap();
+            scriptFound = true;
+            continue;
+        }
         auto optionKind = OptionKind::UNKNOWN;
         const auto optionName = findOption(name, optionKind);
         if (optionName == -1) {
@@ -73,12 +73,23 @@ public:
         return options;
     }
 
+    bool hasOption(int optionName) const {
+        return options.find(optionName) != options.end();
+    }
+
     const std::vector<BString>& getArguments() const {
         return arguments;
     }
 
     enum {
-        HELP = 0,
+        BUILD_SNAPSHOT = 0,
+        COMPILE,
+        HELP,
+        IO_BACKEND,
+        NO_CODE_CACHE,
+        NO_SNAPSHOT,
+        STDIO_BACKLOG,
+        STDIO_POLICY,
         THREAD_POOL_SIZE,
         V8_FLAGS,
         VERSION
@@ -1,32 +1,39 @@
 #include "env/environment.h"
 
 #include "libplatform/libplatform.h"
+#include "api/api.h"
 #include "env/cmdline.h"
+#include "env/snapshot.h"
 #include "loop/event_loop.h"
 #include "module/es_module.h"
 #include "sys/fs.h"
 #include "sys/io.h"
 #include "sys/path.h"
 #include "sys/process.h"
+#include "util/buffer_allocator.h"
 #include "util/scope_guard.h"
 #include "util/v8_utils.h"
 #include "web/web.h"
+#include "web/worker.h"
 
 KUN_V8_USINGS;
 
 using v8::PromiseRejectMessage;
 using v8::StackTrace;
 using kun::BString;
+using kun::BufferAllocator;
 using kun::Environment;
 using kun::EsModule;
 using kun::EventLoop;
+using kun::OutputBuffer;
+using kun::Snapshot;
 using kun::sys::eprintln;
 using kun::sys::getAppDir;
 using kun::sys::joinPath;
 using kun::sys::makeDirs;
+using kun::sys::println;
 using kun::util::formatException;
 using kun::util::toBString;
-using kun::util::toV8String;
 
 namespace {
 
@@ -58,8 +65,10 @@ Environment::Environment(Cmdline* cmdline): cmdline(cmdline) {
     auto appDir = getAppDir().unwrap();
     kunDir = joinPath(appDir, ".kun");
     depsDir = joinPath(kunDir, "deps");
+    cacheDir = joinPath(kunDir, "cache");
     makeDirs(kunDir).expect("Failed to make dir '{}'", kunDir);
     makeDirs(depsDir).expect("Failed to make dir '{}'", depsDir);
+    makeDirs(cacheDir).expect("Failed to make dir '{}'", cacheDir);
 }
 
 void Environment::run(ExposedScope exposedScope) {
@@ -70,12 +79,52 @@ void Environment::run(ExposedScope exposedScope) {
         v8::V8::SetFlagsFromString(v8Flags.c_str());
     }
     v8::V8::Initialize();
-    auto abAllocator = ArrayBuffer::Allocator::NewDefaultAllocator();
     ON_SCOPE_EXIT {
-        delete abAllocator;
+        v8::V8::Dispose();
+        v8::V8::DisposePlatform();
+    };
+    Snapshot snapshot(this);
+    if (cmdline->hasOption(Cmdline::BUILD_SNAPSHOT)) {
+        auto snapshotPath = snapshot.getPath();
+        if (snapshot.build()) {
+            println("Snapshot written to '{}'", snapshotPath);
+        } else {
+            eprintln("ERROR: Failed to build snapshot '{}'", snapshotPath);
+        }
+        return;
+    }
+    auto fromSnapshot =
+        exposedScope == ExposedScope::MAIN &&
+        !cmdline->hasOption(Cmdline::NO_SNAPSHOT) &&
+        snapshot.load();
+    runIsolate(exposedScope, cmdline->getScriptPath(), &snapshot, fromSnapshot);
+}
+
+void Environment::runWorker(std::shared_ptr<web::WorkerState> workerState) {
+    this->workerState = std::move(workerState);
+    runIsolate(ExposedScope::WORKER, this->workerState->scriptPath, nullptr, false);
+}
+
+void Environment::runIsolate(
+    ExposedScope exposedScope,
+    const BString& scriptPath,
+    Snapshot* snapshot,
+    bool fromSnapshot
+) {
+    OutputBuffer::setCurrent(&outputBuffer);
+    ON_SCOPE_EXIT {
+        outputBuffer.flush();
+        OutputBuffer::setCurrent(nullptr);
     };
     Isolate::CreateParams createParams;
-    createParams.array_buffer_allocator = abAllocator;
+    createParams.array_buffer_allocator_shared = std::make_shared<BufferAllocator>();
+    createParams.allow_atomics_wait = exposedScope == ExposedScope::WORKER;
+    if (snapshot != nullptr) {
+        createParams.external_references = snapshot->getReferences();
+    }
+    if (fromSnapshot) {
+        createParams.snapshot_blob = snapshot->getStartupData();
+    }
     auto isolate = Isolate::New(createParams);
     {
         Isolate::Scope isolateScope(isolate);
@@ -86,30 +135,50 @@ void Environment::run(ExposedScope exposedScope) {
         isolate->SetHostImportModuleDynamicallyCallback(esm::importModuleDynamicallyCallback);
         isolate->SetHostInitializeImportMetaObjectCallback(esm::importMetaObjectCallback);
         {
-            auto objTmpl = ObjectTemplate::New(isolate);
-            auto context = Context::New(isolate, nullptr, objTmpl);
+            Local<Context> context;
+            if (fromSnapshot) {
+                context = Context::FromSnapshot(isolate, Snapshot::MAIN_CONTEXT).ToLocalChecked();
+            } else {
+                auto objTmpl = ObjectTemplate::New(isolate);
+                context = Context::New(isolate, nullptr, objTmpl);
+            }
             Context::Scope contextScope(context);
             context->SetAlignedPointerInEmbedderData(1, this);
-            auto globalThis = context->Global();
-            globalThis->DefineOwnProperty(
-                context,
-                toV8String(isolate, KUN_NAME),
-                Object::New(isolate),
-                v8::ReadOnly
-            ).Check();
             this->isolate = isolate;
             this->context.Reset(isolate, context);
-            web::expose(context, exposedScope);
+            if (fromSnapshot) {
+                web::deserialize(context);
+            } else {
+                setupContext(context, exposedScope);
+            }
             EsModule esModule(this);
             EventLoop eventLoop(this);
             this->esModule = &esModule;
             this->eventLoop = &eventLoop;
-            auto scriptPath = cmdline->getScriptPath();
-            if (!scriptPath.empty()) {
+            if (exposedScope == ExposedScope::MAIN && cmdline->hasOption(Cmdline::COMPILE)) {
+                auto imagePath = cmdline->get<BString>(Cmdline::COMPILE).unwrap();
+                if (scriptPath.empty()) {
+                    eprintln("ERROR: '--compile' requires a script");
+                } else if (esModule.compile(scriptPath, imagePath)) {
+                    println("Image written to '{}'", imagePath);
+                } else {
+                    eprintln("ERROR: Failed to compile image '{}'", imagePath);
+                }
+            } else if (
+                !scriptPath.empty() &&
+                (workerState == nullptr || workerState->start(this))
+            ) {
                 if (esModule.execute(scriptPath)) {
                     eventLoop.run();
                 }
             }
+            if (workerState != nullptr) {
+                workerState->stop();
+            }
+            for (const auto& worker : workers) {
+                worker->shutdown();
+            }
+            workers.clear();
             this->isolate = nullptr;
             this->context.Reset();
         }
@@ -118,8 +187,6 @@ void Environment::run(ExposedScope exposedScope) {
     isolate->LowMemoryNotification();
     isolate->ClearKeptObjects();
     isolate->Dispose();
-    v8::V8::Dispose();
-    v8::V8::DisposePlatform();
 }
 
 void Environment::runMicrotask() {
@@ -140,4 +207,9 @@ void Environment::runMicrotask() {
     unhandledRejections.clear();
 }
 
+void Environment::setupContext(Local<Context> context, ExposedScope exposedScope) {
+    api::expose(context, exposedScope);
+    web::expose(context, exposedScope);
+}
+
 }
@@ -3,20 +3,32 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
 #include "v8.h"
 #include "util/bstring.h"
 #include "util/constants.h"
+#include "util/output_buffer.h"
+#include "util/utils.h"
 
 namespace kun {
 
 class Cmdline;
 class EsModule;
 class EventLoop;
+class Snapshot;
 class WebTimer;
 
+namespace web {
+
+class AbortTimeout;
+class WorkerState;
+
+}
+
 class Environment {
 public:
     Environment(const Environment&) = delete;
@@ -33,8 +45,20 @@ public:
 
     void run(ExposedScope exposedScope);
 
+    void runWorker(std::shared_ptr<web::WorkerState> workerState);
+
     void runMicrotask();
 
+    void flushOutput() {
+        outputBuffer.flush();
+    }
+
+    OutputBuffer* getOutputBuffer() {
+        return &outputBuffer;
+    }
+
+    static void setupContext(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
     Cmdline* getCmdline() const {
         return cmdline;
     }
@@ -92,6 +116,49 @@ public:
         return nullptr;
     }
 
+    web::AbortTimeout* findAbortTimeout(uint64_t deadline) const {
+        auto iter = abortTimeoutMap.find(deadline);
+        return iter != abortTimeoutMap.end() ? iter->second : nullptr;
+    }
+
+    void addAbortTimeout(uint64_t deadline, web::AbortTimeout* abortTimeout) {
+        abortTimeoutMap.emplace(deadline, abortTimeout);
+    }
+
+    void removeAbortTimeout(uint64_t deadline) {
+        abortTimeoutMap.erase(deadline);
+    }
+
+    web::WorkerState* getWorkerState() const {
+        return workerState.get();
+    }
+
+    void addWorker(std::shared_ptr<web::WorkerState> worker) {
+        workers.emplace_back(std::move(worker));
+    }
+
+    void removeWorker(web::WorkerState* worker) {
+        auto iter = std::find_if(
+            workers.begin(),
+            workers.end(),
+            [worker](const std::shared_ptr<web::WorkerState>& p) { return p.get() == worker; }
+        );
+        if (iter != workers.end()) {
+            workers.erase(iter);
+        }
+    }
+
+    uint32_t internEventType(const BString& type) {
+        const auto atom = static_cast<uint32_t>(eventTypes.size() + 1);
+        auto pair = eventTypes.emplace(type, atom);
+        return pair.first->second;
+    }
+
+    uint32_t findEventType(const BString& type) const {
+        auto iter = eventTypes.find(type);
+        return iter != eventTypes.end() ? iter->second : 0;
+    }
+
     BString getKunDir() const {
         return BString::view(kunDir);
     }
@@ -100,11 +167,22 @@ public:
         return BString::view(depsDir);
     }
 
+    BString getCacheDir() const {
+        return BString::view(cacheDir);
+    }
+
     static Environment* from(v8::Local<v8::Context> context) {
         return static_cast<Environment*>(context->GetAlignedPointerFromEmbedderData(1));
     }
 
 private:
+    void runIsolate(
+        ExposedScope exposedScope,
+        const BString& scriptPath,
+        Snapshot* snapshot,
+        bool fromSnapshot
+    );
+
     Cmdline* cmdline;
     EsModule* esModule;
     EventLoop* eventLoop;
@@ -112,9 +190,15 @@ private:
     v8::Global<v8::Context> context;
     std::vector<v8::Global<v8::Value>> unhandledRejections;
     std::unordered_map<uint32_t, WebTimer*> webTimerMap;
+    std::unordered_map<uint64_t, web::AbortTimeout*> abortTimeoutMap;
+    std::unordered_map<BString, uint32_t, BStringHash> eventTypes;
+    std::shared_ptr<web::WorkerState> workerState;
+    std::vector<std::shared_ptr<web::WorkerState>> workers;
+    OutputBuffer outputBuffer;
     uint32_t webTimerId{1};
     BString kunDir;
     BString depsDir;
+    BString cacheDir;
 };
 
 }
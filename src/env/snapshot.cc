@@ -0,0 +1,141 @@
+#include "env/snapshot.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "api/api.h"
+#include "env/cmdline.h"
+#include "sys/fs.h"
+#include "sys/path.h"
+#include "util/constants.h"
+#include "util/scope_guard.h"
+#include "util/utils.h"
+#include "web/web.h"
+
+KUN_V8_USINGS;
+
+using v8::SnapshotCreator;
+using v8::StartupData;
+using kun::BString;
+using kun::Cmdline;
+using kun::ExposedScope;
+using kun::sys::joinPath;
+using kun::sys::readFile;
+using kun::sys::replaceFile;
+using kun::util::hashBytes;
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x534e554b;
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t hash;
+    uint64_t dataLength;
+};
+
+}
+
+namespace kun {
+
+Snapshot::Snapshot(Environment* env) : env(env) {
+    api::registerReferences(references);
+    web::registerReferences(references);
+    std::vector<int64_t> refOffsets;
+    refOffsets.reserve(references.size());
+    for (auto ref : references) {
+        refOffsets.emplace_back(static_cast<int64_t>(ref - references.front()));
+    }
+    references.push_back(0);
+    path = joinPath(env->getCacheDir(), "snapshot.blob");
+    auto v8Version = v8::V8::GetVersion();
+    auto v8Flags = env->getCmdline()->get<BString>(Cmdline::V8_FLAGS).unwrap();
+    auto refCount = static_cast<uint64_t>(references.size());
+    hash = hashBytes(KUN_VERSION);
+    hash = hashBytes(v8Version, strlen(v8Version), hash);
+    hash = hashBytes(v8Flags, hash);
+    hash = hashBytes(reinterpret_cast<const char*>(&refCount), sizeof(refCount), hash);
+    hash = hashBytes(
+        reinterpret_cast<const char*>(refOffsets.data()),
+        sizeof(int64_t) * refOffsets.size(),
+        hash
+    );
+}
+
+bool Snapshot::build() {
+    auto abAllocator = ArrayBuffer::Allocator::NewDefaultAllocator();
+    ON_SCOPE_EXIT {
+        delete abAllocator;
+    };
+    Isolate::CreateParams createParams;
+    createParams.array_buffer_allocator = abAllocator;
+    createParams.external_references = references.data();
+    StartupData blob{nullptr, 0};
+    {
+        SnapshotCreator snapshotCreator(createParams);
+        auto isolate = snapshotCreator.GetIsolate();
+        {
+            HandleScope handleScope(isolate);
+            snapshotCreator.SetDefaultContext(Context::New(isolate));
+            auto context = Context::New(isolate, nullptr, ObjectTemplate::New(isolate));
+            Context::Scope contextScope(context);
+            Environment::setupContext(context, ExposedScope::MAIN);
+            web::serialize(context);
+            snapshotCreator.AddContext(context);
+        }
+        blob = snapshotCreator.CreateBlob(SnapshotCreator::FunctionCodeHandling::kKeep);
+    }
+    ON_SCOPE_EXIT {
+        delete[] blob.data;
+    };
+    if (blob.data == nullptr || blob.raw_size <= 0) {
+        return false;
+    }
+    const auto dataLength = static_cast<size_t>(blob.raw_size);
+    SnapshotHeader header;
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.hash = hash;
+    header.dataLength = dataLength;
+    BString str;
+    str.reserve(sizeof(header) + dataLength);
+    str.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    str.append(blob.data, dataLength);
+    return static_cast<bool>(replaceFile(path, str));
+}
+
+bool Snapshot::load() {
+    if (auto result = readFile(path)) {
+        content = result.unwrap();
+    } else {
+        return false;
+    }
+    if (content.length() <= sizeof(SnapshotHeader)) {
+        return false;
+    }
+    SnapshotHeader header;
+    memcpy(&header, content.data(), sizeof(header));
+    const auto dataLength = content.length() - sizeof(header);
+    if (
+        header.magic != SNAPSHOT_MAGIC ||
+        header.version != SNAPSHOT_VERSION ||
+        header.hash != hash ||
+        header.dataLength != dataLength
+    ) {
+        return false;
+    }
+    startupData.data = content.data() + sizeof(header);
+    startupData.raw_size = static_cast<int>(dataLength);
+    if (!startupData.IsValid()) {
+        startupData.data = nullptr;
+        startupData.raw_size = 0;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,58 @@
+#ifndef KUN_ENV_SNAPSHOT_H
+#define KUN_ENV_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "v8.h"
+#include "env/environment.h"
+#include "util/bstring.h"
+
+namespace kun {
+
+class Snapshot {
+public:
+    Snapshot(const Snapshot&) = delete;
+
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    Snapshot(Snapshot&&) = delete;
+
+    Snapshot& operator=(Snapshot&&) = delete;
+
+    explicit Snapshot(Environment* env);
+
+    ~Snapshot() = default;
+
+    bool build();
+
+    bool load();
+
+    const intptr_t* getReferences() const {
+        return references.data();
+    }
+
+    const v8::StartupData* getStartupData() const {
+        return &startupData;
+    }
+
+    BString getPath() const {
+        return BString::view(path);
+    }
+
+    static constexpr size_t MAIN_CONTEXT = 0;
+
+private:
+    Environment* env;
+    std::vector<intptr_t> references;
+    BString path;
+    BString content;
+    v8::StartupData startupData{nullptr, 0};
+    uint64_t hash{0};
+};
+
+}
+
+#endif
@@ -69,12 +69,18 @@ void AsyncHandler::onReadable() {
         KUN_LOG_ERR(errCode);
     }
     #endif
+    threadPool.resetNotified();
+    runResolvedRequests();
+    env->runMicrotask();
+}
+
+void AsyncHandler::runResolvedRequests() {
     auto isolate = env->getIsolate();
     HandleScope handleScope(isolate);
     auto context = env->getContext();
-    auto requests = threadPool.getResolvedRequests();
-    for (auto& req : requests) {
-        req.resolve(context);
+    while (auto req = threadPool.peekResolvedRequest()) {
+        req->resolve(context);
+        threadPool.popResolvedRequest();
     }
 }
 
@@ -18,6 +18,8 @@ public:
 
     void notify();
 
+    void runResolvedRequests();
+
     Environment* getEnvironment() const {
         return env;
     }
@@ -26,6 +28,14 @@ public:
         threadPool.submit(std::move(req));
     }
 
+    void post(AsyncRequest&& req) {
+        threadPool.pushResolvedRequest(std::move(req));
+    }
+
+    void waitResolvedRequests() {
+        threadPool.waitResolvedRequest();
+    }
+
     bool tryClose() {
         return threadPool.tryClose();
     }
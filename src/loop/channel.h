@@ -14,6 +14,7 @@ namespace kun {
 enum class ChannelType {
     READ = 1,
     WRITE = 2,
+    READ_WRITE = 3,
     TIMER = 4
 };
 
@@ -1,53 +1,92 @@
 #include "loop/thread_pool.h"
 
-#include <stddef.h>
-
 #include "env/cmdline.h"
 #include "env/environment.h"
 #include "loop/async_handler.h"
 
+using kun::AsyncRequest;
 using kun::ThreadPool;
 
 namespace {
 
-void handleAsyncRequest(ThreadPool* threadPool) {
-    bool isFirst = true;
-    while (true) {
-        std::unique_lock<std::mutex> lock(threadPool->pendingMutex);
-        auto& pendingCond = threadPool->pendingCond;
-        auto& pendingRequests = threadPool->pendingRequests;
-        if (isFirst) {
-            threadPool->busyCount++;
+AsyncRequest* stealRequest(ThreadPool* threadPool, size_t index) {
+    const auto& requestDeques = threadPool->requestDeques;
+    auto n = requestDeques.size();
+    for (size_t i = 1; i < n; i++) {
+        auto req = requestDeques[(index + i) % n]->steal();
+        if (req != nullptr) {
+            return req;
         }
-        while (pendingRequests.empty()) {
-            if (threadPool->closed) {
-                break;
-            }
-            threadPool->busyCount--;
-            pendingCond.wait(lock);
-            threadPool->busyCount++;
+    }
+    return nullptr;
+}
+
+bool hasStealableRequest(ThreadPool* threadPool) {
+    for (const auto& requestDeque : threadPool->requestDeques) {
+        if (!requestDeque->empty()) {
+            return true;
         }
-        if (threadPool->closed) {
+    }
+    return false;
+}
+
+AsyncRequest* takePendingRequests(ThreadPool* threadPool, ThreadPool::RequestDeque& requestDeque) {
+    auto& pendingRequests = threadPool->pendingRequests;
+    auto req = pendingRequests.front();
+    pendingRequests.pop_front();
+    auto n = pendingRequests.size() / threadPool->threadCount;
+    if (n > requestDeque.capacity() / 2) {
+        n = requestDeque.capacity() / 2;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!requestDeque.push(pendingRequests.front())) {
             break;
         }
-        auto asyncRequest = std::move(pendingRequests.front());
         pendingRequests.pop_front();
-        if (!pendingRequests.empty()) {
-            pendingCond.notify_one();
+    }
+    if (
+        threadPool->busyCount < threadPool->threadCount &&
+        (!pendingRequests.empty() || !requestDeque.empty())
+    ) {
+        threadPool->pendingCond.notify_one();
+    }
+    return req;
+}
+
+void handleAsyncRequest(ThreadPool* threadPool, size_t index) {
+    auto& requestDeque = *threadPool->requestDeques[index];
+    {
+        std::lock_guard<std::mutex> lockGuard(threadPool->pendingMutex);
+        threadPool->busyCount++;
+    }
+    while (true) {
+        auto req = requestDeque.pop();
+        if (req == nullptr) {
+            req = stealRequest(threadPool, index);
         }
-        lock.unlock();
-        asyncRequest.handle();
-        {
-            std::lock_guard<std::mutex> lockGuard(threadPool->resolvedMutex);
-            threadPool->resolvedRequests.emplace_back(std::move(asyncRequest));
-            if (!threadPool->notified) {
-                threadPool->asyncHandler->notify();
-                threadPool->notified = true;
+        if (req == nullptr) {
+            std::unique_lock<std::mutex> lock(threadPool->pendingMutex);
+            auto& pendingRequests = threadPool->pendingRequests;
+            while (
+                !threadPool->closed &&
+                pendingRequests.empty() &&
+                !hasStealableRequest(threadPool)
+            ) {
+                threadPool->busyCount--;
+                threadPool->pendingCond.wait(lock);
+                threadPool->busyCount++;
             }
+            if (threadPool->closed) {
+                break;
+            }
+            if (pendingRequests.empty()) {
+                continue;
+            }
+            req = takePendingRequests(threadPool, requestDeque);
         }
-        if (isFirst) {
-            isFirst = false;
-        }
+        req->handle();
+        threadPool->pushResolvedRequest(std::move(*req));
+        delete req;
     }
 }
 
@@ -59,26 +98,52 @@ ThreadPool::ThreadPool(AsyncHandler* asyncHandler) : asyncHandler(asyncHandler)
     auto env = asyncHandler->getEnvironment();
     auto cmdline = env->getCmdline();
     auto size = cmdline->get<size_t>(Cmdline::THREAD_POOL_SIZE).unwrap();
+    threadCount = size;
+    requestDeques.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        requestDeques.emplace_back(std::make_unique<RequestDeque>());
+    }
     threads.reserve(size);
     for (size_t i = 0; i < size; i++) {
-        threads.emplace_back(handleAsyncRequest, this);
+        threads.emplace_back(handleAsyncRequest, this, i);
     }
 }
 
-std::list<AsyncRequest> ThreadPool::getResolvedRequests() {
-    std::list<AsyncRequest> requests;
-    {
+ThreadPool::~ThreadPool() {
+    for (auto req : pendingRequests) {
+        delete req;
+    }
+}
+
+void ThreadPool::pushResolvedRequest(AsyncRequest&& req) {
+    resolvedRequests.push(std::move(req));
+    if (!notified.exchange(true)) {
+        asyncHandler->notify();
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (resolvedWaiters.load(std::memory_order_relaxed) > 0) {
         std::lock_guard<std::mutex> lockGuard(resolvedMutex);
-        requests.swap(resolvedRequests);
-        notified = false;
+        resolvedCond.notify_one();
     }
-    return requests;
+}
+
+void ThreadPool::waitResolvedRequest() {
+    std::unique_lock<std::mutex> lock(resolvedMutex);
+    resolvedWaiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (resolvedRequests.empty()) {
+        resolvedCond.wait(lock);
+    }
+    resolvedWaiters.fetch_sub(1);
 }
 
 void ThreadPool::submit(AsyncRequest&& req) {
+    auto p = new AsyncRequest(std::move(req));
     std::lock_guard<std::mutex> lockGuard(pendingMutex);
-    pendingRequests.emplace_back(std::move(req));
-    pendingCond.notify_one();
+    pendingRequests.emplace_back(p);
+    if (busyCount < threadCount) {
+        pendingCond.notify_one();
+    }
 }
 
 bool ThreadPool::tryClose() {
@@ -90,11 +155,7 @@ bool ThreadPool::tryClose() {
         }
         idle = pendingRequests.empty() && busyCount == 0;
     }
-    bool hasReq = false;
-    if (idle) {
-        std::lock_guard<std::mutex> lockGuard(resolvedMutex);
-        hasReq = !resolvedRequests.empty();
-    }
+    bool hasReq = idle && !resolvedRequests.empty();
     if (idle && !hasReq) {
         std::lock_guard<std::mutex> lockGuard(pendingMutex);
         closed = true;
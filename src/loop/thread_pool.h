@@ -1,13 +1,19 @@
 #ifndef KUN_LOOP_THREAD_POOL_H
 #define KUN_LOOP_THREAD_POOL_H
 
+#include <stddef.h>
+
+#include <atomic>
 #include <condition_variable>
-#include <list>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 
 #include "loop/async_request.h"
+#include "util/mpsc_queue.h"
+#include "util/work_deque.h"
 
 namespace kun {
 
@@ -15,6 +21,8 @@ class AsyncHandler;
 
 class ThreadPool {
 public:
+    using RequestDeque = WorkDeque<AsyncRequest, 256>;
+
     ThreadPool(const ThreadPool&) = delete;
 
     ThreadPool& operator=(const ThreadPool&) = delete;
@@ -25,9 +33,23 @@ public:
 
     explicit ThreadPool(AsyncHandler* asyncHandler);
 
-    ~ThreadPool() = default;
+    ~ThreadPool();
+
+    AsyncRequest* peekResolvedRequest() {
+        return resolvedRequests.front();
+    }
+
+    void popResolvedRequest() {
+        resolvedRequests.pop();
+    }
+
+    void resetNotified() {
+        notified.store(false);
+    }
+
+    void pushResolvedRequest(AsyncRequest&& req);
 
-    std::list<AsyncRequest> getResolvedRequests();
+    void waitResolvedRequest();
 
     void submit(AsyncRequest&& req);
 
@@ -35,13 +57,17 @@ public:
 
     AsyncHandler* const asyncHandler;
     std::vector<std::thread> threads;
-    std::list<AsyncRequest> pendingRequests;
-    std::list<AsyncRequest> resolvedRequests;
+    std::vector<std::unique_ptr<RequestDeque>> requestDeques;
+    std::deque<AsyncRequest*> pendingRequests;
+    MpscQueue<AsyncRequest, 1024> resolvedRequests;
     std::condition_variable pendingCond;
     std::mutex pendingMutex;
+    std::condition_variable resolvedCond;
     std::mutex resolvedMutex;
-    int busyCount{0};
-    bool notified{false};
+    std::atomic<size_t> resolvedWaiters{0};
+    size_t threadCount{0};
+    size_t busyCount{0};
+    std::atomic<bool> notified{false};
     bool closed{false};
 };
 
@@ -1,16 +1,11 @@
 #ifndef KUN_LOOP_TIMER_H
 #define KUN_LOOP_TIMER_H
 
-#include <errno.h>
 #include <stdint.h>
 
-#if defined(KUN_PLATFORM_LINUX)
-#include <sys/timerfd.h>
-#endif
-
 #include "loop/channel.h"
 #include "util/constants.h"
-#include "util/utils.h"
+#include "util/types.h"
 
 namespace kun {
 
@@ -28,12 +23,7 @@ public:
         timeUnit(timeUnit),
         repeat(repeat)
     {
-        #ifdef KUN_PLATFORM_LINUX
-        fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
-        if (fd == -1) {
-            KUN_LOG_ERR(errno);
-        }
-        #endif
+
     }
 
     virtual ~Timer() = 0;
@@ -42,12 +32,18 @@ public:
         return value * static_cast<int>(this->timeUnit) / static_cast<int>(timeUnit);
     }
 
+    bool isActive() const {
+        return slot != nullptr;
+    }
+
     const uint64_t value;
     const TimeUnit timeUnit;
     const bool repeat;
-    #ifdef KUN_PLATFORM_WIN32
-    bool removed{false};
-    #endif
+    uint64_t expiry{0};
+    uint64_t sequence{0};
+    Timer* prev{nullptr};
+    Timer* next{nullptr};
+    Timer** slot{nullptr};
 };
 
 inline Timer::~Timer() {
@@ -0,0 +1,173 @@
+#include "loop/timer_wheel.h"
+
+#include <limits.h>
+
+namespace kun {
+
+void TimerWheel::add(Timer* timer, uint64_t now) {
+    if (timer->isActive()) {
+        remove(timer);
+    }
+    if (count == 0 && base < now) {
+        base = now;
+    }
+    auto ns = timer->getValue(TimeUnit::NANOSECOND);
+    auto ms = (ns + 999999) / 1000000;
+    if (ms == 0) {
+        ms = 1;
+    }
+    timer->expiry = now + ms;
+    timer->sequence = sequence++;
+    link(timer);
+    count++;
+}
+
+void TimerWheel::remove(Timer* timer) {
+    if (!timer->isActive()) {
+        return;
+    }
+    auto head = *timer->slot;
+    if (timer == head) {
+        *timer->slot = timer->next;
+    } else {
+        timer->prev->next = timer->next;
+    }
+    if (timer->next != nullptr) {
+        timer->next->prev = timer->prev;
+    } else if (timer != head) {
+        head->prev = timer->prev;
+    }
+    timer->prev = nullptr;
+    timer->next = nullptr;
+    timer->slot = nullptr;
+    if (count > 0) {
+        count--;
+    }
+}
+
+void TimerWheel::expire(uint64_t now) {
+    while (count > 0 && base <= now) {
+        auto index = base & ROOT_MASK;
+        if (index == 0) {
+            for (int i = 0; i < LEVELS; i++) {
+                auto j = (base >> getShift(i)) & LEVEL_MASK;
+                cascade(i, j);
+                if (j != 0) {
+                    break;
+                }
+            }
+        }
+        Timer* expired = root[index];
+        root[index] = nullptr;
+        for (auto p = expired; p != nullptr; p = p->next) {
+            p->slot = &expired;
+        }
+        base++;
+        while (expired != nullptr) {
+            auto timer = expired;
+            remove(timer);
+            if (timer->repeat) {
+                add(timer, now);
+            }
+            timer->onReadable();
+        }
+    }
+    if (count == 0) {
+        base = now + 1;
+    }
+}
+
+int TimerWheel::nextTimeout(uint64_t now) const {
+    if (count == 0) {
+        return -1;
+    }
+    auto next = UINT64_MAX;
+    for (uint64_t i = 0; i < ROOT_SIZE; i++) {
+        if (root[(base + i) & ROOT_MASK] != nullptr) {
+            next = base + i;
+            break;
+        }
+    }
+    for (int i = 0; i < LEVELS; i++) {
+        const auto shift = getShift(i);
+        const auto first = (base + (static_cast<uint64_t>(1) << shift) - 1) >> shift;
+        for (uint64_t j = 0; j < LEVEL_SIZE; j++) {
+            auto block = first + j;
+            if (levels[i][block & LEVEL_MASK] != nullptr) {
+                auto tick = block << shift;
+                if (tick < next) {
+                    next = tick;
+                }
+                break;
+            }
+        }
+    }
+    if (next <= now) {
+        return 0;
+    }
+    auto ms = next - now;
+    return ms < INT_MAX ? static_cast<int>(ms) : INT_MAX;
+}
+
+void TimerWheel::link(Timer* timer) {
+    auto expiry = timer->expiry;
+    uint64_t ticks = expiry > base ? expiry - base : 0;
+    if (ticks > MAX_TICKS) {
+        ticks = MAX_TICKS;
+        expiry = base + ticks;
+        timer->expiry = expiry;
+    }
+    Timer** slot = nullptr;
+    if (expiry < base) {
+        slot = &root[base & ROOT_MASK];
+    } else if (ticks < ROOT_SIZE) {
+        slot = &root[expiry & ROOT_MASK];
+    } else {
+        for (int i = 0; i < LEVELS; i++) {
+            const auto shift = getShift(i);
+            if (i + 1 == LEVELS || ticks < (static_cast<uint64_t>(1) << (shift + LEVEL_BITS))) {
+                slot = &levels[i][(expiry >> shift) & LEVEL_MASK];
+                break;
+            }
+        }
+    }
+    timer->slot = slot;
+    auto head = *slot;
+    if (head == nullptr) {
+        timer->prev = timer;
+        timer->next = nullptr;
+        *slot = timer;
+        return;
+    }
+    auto p = head->prev;
+    while (p->sequence > timer->sequence && p != head) {
+        p = p->prev;
+    }
+    if (p->sequence > timer->sequence) {
+        timer->prev = head->prev;
+        timer->next = head;
+        head->prev = timer;
+        *slot = timer;
+        return;
+    }
+    timer->prev = p;
+    timer->next = p->next;
+    if (p->next != nullptr) {
+        p->next->prev = timer;
+    } else {
+        head->prev = timer;
+    }
+    p->next = timer;
+}
+
+void TimerWheel::cascade(int level, uint64_t index) {
+    Timer* timer = levels[level][index];
+    levels[level][index] = nullptr;
+    while (timer != nullptr) {
+        auto next = timer->next;
+        link(timer);
+        timer = next;
+    }
+}
+
+}
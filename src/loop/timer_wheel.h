@@ -0,0 +1,68 @@
+#ifndef KUN_LOOP_TIMER_WHEEL_H
+#define KUN_LOOP_TIMER_WHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "loop/timer.h"
+
+namespace kun {
+
+class TimerWheel {
+public:
+    TimerWheel(const TimerWheel&) = delete;
+
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    TimerWheel(TimerWheel&&) = delete;
+
+    TimerWheel& operator=(TimerWheel&&) = delete;
+
+    TimerWheel() = default;
+
+    ~TimerWheel() = default;
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void add(Timer* timer, uint64_t now);
+
+    void remove(Timer* timer);
+
+    void expire(uint64_t now);
+
+    int nextTimeout(uint64_t now) const;
+
+private:
+    void link(Timer* timer);
+
+    void cascade(int level, uint64_t index);
+
+    static constexpr int ROOT_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int LEVELS = 4;
+    static constexpr uint64_t ROOT_SIZE = static_cast<uint64_t>(1) << ROOT_BITS;
+    static constexpr uint64_t LEVEL_SIZE = static_cast<uint64_t>(1) << LEVEL_BITS;
+    static constexpr uint64_t ROOT_MASK = ROOT_SIZE - 1;
+    static constexpr uint64_t LEVEL_MASK = LEVEL_SIZE - 1;
+    static constexpr uint64_t MAX_TICKS = 0xffffffff;
+
+    static constexpr int getShift(int level) {
+        return ROOT_BITS + level * LEVEL_BITS;
+    }
+
+    Timer* root[ROOT_SIZE]{};
+    Timer* levels[LEVELS][LEVEL_SIZE]{};
+    uint64_t base{0};
+    uint64_t sequence{0};
+    size_t count{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include "module/code_cache.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <memory>
+
+#include "env/cmdline.h"
+#include "sys/fs.h"
+#include "sys/path.h"
+#include "util/constants.h"
+#include "util/utils.h"
+
+KUN_V8_USINGS;
+
+using v8::Module;
+using v8::ScriptCompiler;
+using kun::BString;
+using kun::Cmdline;
+using kun::sys::joinPath;
+using kun::sys::readDir;
+using kun::sys::readFile;
+using kun::sys::replaceFile;
+using kun::util::hashBytes;
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x434e554b;
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t v8Hash;
+    uint64_t pathHash;
+    uint64_t sourceHash;
+    uint64_t sourceLength;
+    uint64_t dataLength;
+};
+
+BString getCacheName(uint64_t pathHash) {
+    constexpr auto digits = "0123456789abcdef";
+    char name[22];
+    for (int i = 0; i < 16; i++) {
+        name[15 - i] = digits[(pathHash >> (i << 2)) & 0xf];
+    }
+    memcpy(name + 16, ".cache", 6);
+    return BString(name, sizeof(name));
+}
+
+}
+
+namespace kun {
+
+CodeCache::CodeCache(Environment* env) : env(env) {
+    auto cmdline = env->getCmdline();
+    enabled = !cmdline->hasOption(Cmdline::NO_CODE_CACHE);
+    if (enabled) {
+        auto version = v8::V8::GetVersion();
+        v8Hash = hashBytes(version, strlen(version));
+        auto v8Flags = cmdline->get<BString>(Cmdline::V8_FLAGS).unwrap();
+        v8Hash = hashBytes(v8Flags, v8Hash);
+        pendingCaches.reserve(64);
+    }
+}
+
+ScriptCompiler::CachedData* CodeCache::load(const BString& path, const BString& source) const {
+    if (!enabled) {
+        return nullptr;
+    }
+    auto pathHash = hashBytes(path);
+    BString content;
+    if (auto result = readFile(getCachePath(pathHash))) {
+        content = result.unwrap();
+    } else {
+        return nullptr;
+    }
+    if (content.length() <= sizeof(CacheHeader)) {
+        return nullptr;
+    }
+    CacheHeader header;
+    memcpy(&header, content.data(), sizeof(header));
+    const auto dataLength = content.length() - sizeof(header);
+    if (
+        header.magic != CACHE_MAGIC ||
+        header.version != CACHE_VERSION ||
+        header.v8Hash != v8Hash ||
+        header.pathHash != pathHash ||
+        header.sourceLength != source.length() ||
+        header.dataLength != dataLength ||
+        header.sourceHash != hashBytes(source)
+    ) {
+        return nullptr;
+    }
+    auto buf = new uint8_t[dataLength];
+    memcpy(buf, content.data() + sizeof(header), dataLength);
+    return new ScriptCompiler::CachedData(
+        buf,
+        static_cast<int>(dataLength),
+        ScriptCompiler::CachedData::BufferOwned
+    );
+}
+
+void CodeCache::push(const BString& path, const BString& source, Local<Module> module) {
+    if (!enabled || !module->IsSourceTextModule()) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    PendingCache pendingCache;
+    pendingCache.pathHash = hashBytes(path);
+    pendingCache.cachePath = getCachePath(pendingCache.pathHash);
+    pendingCache.sourceHash = hashBytes(source);
+    pendingCache.sourceLength = source.length();
+    pendingCache.script.Reset(isolate, module->GetUnboundModuleScript());
+    pendingCaches.emplace_back(std::move(pendingCache));
+}
+
+void CodeCache::flush() {
+    if (pendingCaches.empty()) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    for (const auto& pendingCache : pendingCaches) {
+        auto script = pendingCache.script.Get(isolate);
+        std::unique_ptr<ScriptCompiler::CachedData> cachedData(
+            ScriptCompiler::CreateCodeCache(script)
+        );
+        if (cachedData == nullptr || cachedData->length <= 0) {
+            continue;
+        }
+        const auto dataLength = static_cast<size_t>(cachedData->length);
+        CacheHeader header;
+        header.magic = CACHE_MAGIC;
+        header.version = CACHE_VERSION;
+        header.v8Hash = v8Hash;
+        header.pathHash = pendingCache.pathHash;
+        header.sourceHash = pendingCache.sourceHash;
+        header.sourceLength = pendingCache.sourceLength;
+        header.dataLength = dataLength;
+        BString content;
+        content.reserve(sizeof(header) + dataLength);
+        content.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        content.append(reinterpret_cast<const char*>(cachedData->data), dataLength);
+        replaceFile(pendingCache.cachePath, content);
+    }
+    pendingCaches.clear();
+}
+
+bool CodeCache::hasEntry(const BString& path) {
+    if (!enabled) {
+        return false;
+    }
+    if (!scanned) {
+        scanned = true;
+        if (auto result = readDir(env->getCacheDir())) {
+            auto entries = result.unwrap();
+            entryNames.reserve(entries.size());
+            for (auto& entry : entries) {
+                if (entry.name.endsWith(".cache")) {
+                    entryNames.emplace(std::move(entry.name));
+                }
+            }
+        }
+    }
+    return entryNames.find(getCacheName(hashBytes(path))) != entryNames.end();
+}
+
+BString CodeCache::getCachePath(uint64_t pathHash) const {
+    return joinPath(env->getCacheDir(), getCacheName(pathHash));
+}
+
+}
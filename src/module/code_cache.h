@@ -0,0 +1,75 @@
+#ifndef KUN_MODULE_CODE_CACHE_H
+#define KUN_MODULE_CODE_CACHE_H
+
+#include <stdint.h>
+
+#include <unordered_set>
+#include <vector>
+
+#include "v8.h"
+#include "env/environment.h"
+#include "util/bstring.h"
+
+namespace kun {
+
+class CodeCache {
+public:
+    CodeCache(const CodeCache&) = delete;
+
+    CodeCache& operator=(const CodeCache&) = delete;
+
+    CodeCache(CodeCache&&) = delete;
+
+    CodeCache& operator=(CodeCache&&) = delete;
+
+    explicit CodeCache(Environment* env);
+
+    ~CodeCache() = default;
+
+    v8::ScriptCompiler::CachedData* load(const BString& path, const BString& source) const;
+
+    void push(const BString& path, const BString& source, v8::Local<v8::Module> module);
+
+    void flush();
+
+    bool hasEntry(const BString& path);
+
+    bool isEnabled() const {
+        return enabled;
+    }
+
+private:
+    class PendingCache {
+    public:
+        PendingCache(const PendingCache&) = delete;
+
+        PendingCache& operator=(const PendingCache&) = delete;
+
+        PendingCache(PendingCache&&) = default;
+
+        PendingCache& operator=(PendingCache&&) = default;
+
+        PendingCache() = default;
+
+        ~PendingCache() = default;
+
+        BString cachePath;
+        uint64_t pathHash;
+        uint64_t sourceHash;
+        uint64_t sourceLength;
+        v8::Global<v8::UnboundModuleScript> script;
+    };
+
+    BString getCachePath(uint64_t pathHash) const;
+
+    Environment* env;
+    std::vector<PendingCache> pendingCaches;
+    std::unordered_set<BString, BStringHash> entryNames;
+    uint64_t v8Hash{0};
+    bool enabled{false};
+    bool scanned{false};
+};
+
+}
+
+#endif
@@ -1,11 +1,24 @@
 #include "module/es_module.h"
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 #include "v8.h"
+#include "loop/async_request.h"
+#include "loop/event_loop.h"
 #include "sys/fs.h"
 #include "sys/io.h"
 #include "sys/path.h"
 #include "util/constants.h"
+#include "util/file_info.h"
 #include "util/scope_guard.h"
+#include "util/utf8.h"
 #include "util/utils.h"
 #include "util/v8_utils.h"
 
@@ -22,18 +35,30 @@ using v8::Module;
 using v8::ModuleRequest;
 using v8::ScriptCompiler;
 using v8::ScriptOrigin;
+using v8::ScriptType;
 using v8::StackTrace;
 using v8::TryCatch;
+using v8::ValueDeserializer;
+using v8::ValueSerializer;
+using kun::AsyncRequest;
 using kun::BString;
+using kun::BStringHash;
 using kun::Environment;
 using kun::EsModule;
+using kun::ImageModule;
+using kun::ImageModuleType;
+using kun::MappedFile;
+using kun::ModuleImage;
 using kun::sys::cleanPath;
 using kun::sys::dirname;
 using kun::sys::eprintln;
 using kun::sys::isAbsolutePath;
 using kun::sys::joinPath;
+using kun::sys::mapFile;
 using kun::sys::pathExists;
 using kun::sys::readFile;
+using kun::sys::writeFile;
+using kun::findNonAscii;
 using kun::util::formatException;
 using kun::util::formatSourceLine;
 using kun::util::formatStackTrace;
@@ -177,39 +202,269 @@ inline bool isLocalPath(const BString& path) {
     return isAbsolutePath(path) || path.startsWith("./") || path.startsWith("../");
 }
 
+inline BString resolveLocalPath(const BString& referrerPath, const BString& specifier) {
+    if (isAbsolutePath(specifier)) {
+        return cleanPath(specifier);
+    }
+    auto referrerDir = dirname(referrerPath);
+    return joinPath(referrerDir, specifier);
+}
+
+constexpr size_t MIN_MAPPED_SOURCE_SIZE = 64 * 1024;
+
+class ExternalSource : public String::ExternalOneByteStringResource {
+public:
+    ExternalSource(const ExternalSource&) = delete;
+
+    ExternalSource& operator=(const ExternalSource&) = delete;
+
+    ExternalSource(ExternalSource&&) = delete;
+
+    ExternalSource& operator=(ExternalSource&&) = delete;
+
+    ExternalSource(std::shared_ptr<const MappedFile>&& mapping, const BString& content) :
+        mapping(std::move(mapping)),
+        source(content.data()),
+        sourceLength(content.length())
+    {
+
+    }
+
+    ~ExternalSource() = default;
+
+    const char* data() const override {
+        return source;
+    }
+
+    size_t length() const override {
+        return sourceLength;
+    }
+
+private:
+    std::shared_ptr<const MappedFile> mapping;
+    const char* const source;
+    const size_t sourceLength;
+};
+
+std::shared_ptr<const MappedFile> findSourceMapping(
+    const EsModule* esModule,
+    const BString& content
+) {
+    const auto len = content.length();
+    if (len < MIN_MAPPED_SOURCE_SIZE) {
+        return nullptr;
+    }
+    auto mapping = esModule->findImageMapping(content);
+    if (mapping == nullptr || findNonAscii(content.data(), len) != len) {
+        return nullptr;
+    }
+    return mapping;
+}
+
+Local<String> newSourceString(Isolate* isolate, const EsModule* esModule, const BString& content) {
+    if (auto mapping = findSourceMapping(esModule, content)) {
+        auto resource = new ExternalSource(std::move(mapping), content);
+        Local<String> str;
+        if (String::NewExternalOneByte(isolate, resource).ToLocal(&str)) {
+            return str;
+        }
+        str = toV8String(isolate, content);
+        delete resource;
+        return str;
+    }
+    return toV8String(isolate, content);
+}
+
+ScriptOrigin createModuleOrigin(Isolate* isolate, const BString& path) {
+    return ScriptOrigin(
+        isolate,
+        toV8String(isolate, path),
+        0,
+        0,
+        false,
+        -1,
+        Local<Value>(),
+        false,
+        false,
+        true,
+        Local<Data>()
+    );
+}
+
+MaybeLocal<Module> compileModule(
+    Local<Context> context,
+    const BString& path,
+    const BString& content,
+    ScriptCompiler::CachedData* cachedData
+) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto env = Environment::from(context);
+    auto esModule = env->getEsModule();
+    auto codeCache = esModule->getCodeCache();
+    auto scriptOrigin = createModuleOrigin(isolate, path);
+    ScriptCompiler::Source source(
+        newSourceString(isolate, esModule, content),
+        scriptOrigin,
+        cachedData
+    );
+    auto options = cachedData != nullptr ?
+        ScriptCompiler::kConsumeCodeCache :
+        ScriptCompiler::kNoCompileOptions;
+    Local<Module> module;
+    if (!ScriptCompiler::CompileModule(isolate, &source, options).ToLocal(&module)) {
+        return MaybeLocal<Module>();
+    }
+    if (cachedData == nullptr || cachedData->rejected) {
+        codeCache->push(path, content, module);
+    }
+    return handleScope.Escape(module);
+}
+
+MaybeLocal<Module> compileModule(
+    Local<Context> context,
+    const BString& path,
+    const BString& content
+) {
+    auto env = Environment::from(context);
+    auto esModule = env->getEsModule();
+    return compileModule(context, path, content, esModule->loadCachedData(path, content));
+}
+
+MaybeLocal<Value> deserializeJsonValue(Local<Context> context, const BString& data) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    ValueDeserializer deserializer(
+        isolate,
+        reinterpret_cast<const uint8_t*>(data.data()),
+        data.length()
+    );
+    Local<Value> value;
+    if (
+        !deserializer.ReadHeader(context).FromMaybe(false) ||
+        !deserializer.ReadValue(context).ToLocal(&value)
+    ) {
+        return MaybeLocal<Value>();
+    }
+    return handleScope.Escape(value);
+}
+
+bool serializeJsonValue(
+    Local<Context> context,
+    const BString& path,
+    const BString& content,
+    BString& data
+) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    TryCatch tryCatch(isolate);
+    Local<Value> value;
+    if (!JSON::Parse(context, toV8String(isolate, content)).ToLocal(&value)) {
+        auto errStr = tryCatch.HasCaught() ?
+            formatJsonError(context, tryCatch.Exception(), path) :
+            BString();
+        if (!errStr.empty()) {
+            eprintln(errStr);
+        } else {
+            eprintln("ERROR: Malformed JSON '{}'", path);
+        }
+        return false;
+    }
+    ValueSerializer serializer(isolate);
+    serializer.WriteHeader();
+    if (!serializer.WriteValue(context, value).FromMaybe(false)) {
+        eprintln("ERROR: Failed to serialize JSON '{}'", path);
+        return false;
+    }
+    auto [buf, size] = serializer.Release();
+    data.append(reinterpret_cast<const char*>(buf), size);
+    ::free(buf);
+    return true;
+}
+
+MaybeLocal<Value> parseJsonModule(Local<Context> context, const BString& path) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto env = Environment::from(context);
+    auto esModule = env->getEsModule();
+    Local<Value> value;
+    auto imageModule = esModule->findImageModule(path);
+    if (
+        imageModule != nullptr &&
+        imageModule->type == ImageModuleType::JSON &&
+        deserializeJsonValue(context, imageModule->data).ToLocal(&value)
+    ) {
+        return handleScope.Escape(value);
+    }
+    MappedFile file;
+    BString content;
+    if (esModule->takeJsonFile(path, file)) {
+        content = file.view();
+    } else if (auto result = esModule->readModule(path, file)) {
+        content = result.unwrap();
+    } else {
+        throwError(isolate, BString::format("JSON not found '{}'", path));
+        return MaybeLocal<Value>();
+    }
+    BString errStr;
+    {
+        TryCatch tryCatch(isolate);
+        if (JSON::Parse(context, newSourceString(isolate, esModule, content)).ToLocal(&value)) {
+            return handleScope.Escape(value);
+        }
+        if (tryCatch.HasCaught()) {
+            errStr = formatJsonError(context, tryCatch.Exception(), path);
+        }
+    }
+    if (errStr.empty()) {
+        errStr = BString::format("Malformed JSON '{}'", path);
+    }
+    throwSyntaxError(isolate, errStr);
+    return MaybeLocal<Value>();
+}
+
 MaybeLocal<Value> jsonModuleEvaluationSteps(Local<Context> context, Local<Module> module) {
     auto isolate = context->GetIsolate();
     EscapableHandleScope handleScope(isolate);
-    auto resolver = Promise::Resolver::New(context).ToLocalChecked();
-    auto promise = resolver->GetPromise();
     auto env = Environment::from(context);
     auto esModule = env->getEsModule();
     BString modulePath;
     if (auto result = esModule->findModulePath(module)) {
         modulePath = result.unwrap();
     } else {
-        auto v8Str = toV8String(isolate, "JSON not found");
-        resolver->Reject(context, Exception::Error(v8Str)).Check();
-        return handleScope.Escape(promise);
+        throwError(isolate, "JSON not found");
+        return MaybeLocal<Value>();
     }
-    auto content = readFile(modulePath).expect("JSON not found '{}'", modulePath);
-    TryCatch tryCatch(isolate);
     Local<Value> value;
-    if (JSON::Parse(context, toV8String(isolate, content)).ToLocal(&value)) {
-        resolver->Resolve(context, v8::Undefined(isolate)).Check();
-        return handleScope.Escape(promise);
-    }
-    if (tryCatch.HasCaught()) {
-        auto exception = tryCatch.Exception();
-        auto errStr = formatJsonError(context, exception, modulePath);
-        auto v8Str = toV8String(isolate, errStr);
-        resolver->Reject(context, Exception::SyntaxError(v8Str)).Check();
-    } else {
-        auto errStr = BString::format("Malformed JSON '{}'", modulePath);
-        auto v8Str = toV8String(isolate, errStr);
-        resolver->Reject(context, Exception::SyntaxError(v8Str)).Check();
+    if (
+        !parseJsonModule(context, modulePath).ToLocal(&value) ||
+        !module->SetSyntheticModuleExport(
+            isolate,
+            toV8String(isolate, "default"),
+            value
+        ).FromMaybe(false)
+    ) {
+        return MaybeLocal<Value>();
     }
-    return handleScope.Escape(promise);
+    auto resolver = Promise::Resolver::New(context).ToLocalChecked();
+    resolver->Resolve(context, v8::Undefined(isolate)).Check();
+    return handleScope.Escape(resolver->GetPromise());
+}
+
+Local<Module> createJsonModule(Isolate* isolate, EsModule* esModule, const BString& path) {
+    EscapableHandleScope handleScope(isolate);
+    auto moduleName = toV8String(isolate, path);
+    const MemorySpan<const Local<String>> exportNames(
+        {toV8String(isolate, "default")}
+    );
+    auto module = Module::CreateSyntheticModule(
+        isolate,
+        moduleName,
+        exportNames,
+        jsonModuleEvaluationSteps
+    );
+    esModule->setModulePath(module, path);
+    return handleScope.Escape(module);
 }
 
 MaybeLocal<Module> resolveModuleCallback(
@@ -232,8 +487,7 @@ MaybeLocal<Module> resolveModuleCallback(
     BString modulePath;
     auto specifierStr = toBString(context, specifier);
     if (isLocalPath(specifierStr)) {
-        auto referrerDir = dirname(referrerPath);
-        modulePath = joinPath(referrerDir, specifierStr);
+        modulePath = resolveLocalPath(referrerPath, specifierStr);
     } else {
         if (auto result = esModule->findDepsPath(specifierStr)) {
             modulePath = result.unwrap();
@@ -249,10 +503,21 @@ MaybeLocal<Module> resolveModuleCallback(
             return MaybeLocal<Module>();
         }
     }
+    if (Local<Module> module; esModule->findModule(modulePath).ToLocal(&module)) {
+        return handleScope.Escape(module);
+    }
+    auto attrType = findAttrType(context, importAttrs, true);
+    const auto json = attrType == "json";
+    MappedFile file;
     BString content;
-    if (auto result = readFile(modulePath)) {
+    bool found = false;
+    if (json) {
+        found = esModule->findImageModule(modulePath) != nullptr || pathExists(modulePath);
+    } else if (auto result = esModule->readModule(modulePath, file)) {
         content = result.unwrap();
-    } else {
+        found = true;
+    }
+    if (!found) {
         auto location = findLocation(context, specifier, importAttrs, referrer);
         auto line = location.GetLineNumber() + 1;
         auto column = location.GetColumnNumber() + 1;
@@ -263,38 +528,13 @@ MaybeLocal<Module> resolveModuleCallback(
         throwError(isolate, errStr);
         return MaybeLocal<Module>();
     }
-    auto attrType = findAttrType(context, importAttrs, true);
-    if (attrType == "json") {
-        auto moduleName = toV8String(isolate, modulePath);
-        const MemorySpan<const Local<String>> exportNames(
-            {toV8String(isolate, "default")}
-        );
-        auto module = Module::CreateSyntheticModule(
-            isolate,
-            moduleName,
-            exportNames,
-            jsonModuleEvaluationSteps
-        );
-        esModule->setModulePath(module, std::move(modulePath));
+    if (json) {
+        auto module = createJsonModule(isolate, esModule, modulePath);
         return handleScope.Escape(module);
     }
-    ScriptOrigin scriptOrigin(
-        isolate,
-        toV8String(isolate, modulePath),
-        0,
-        0,
-        false,
-        -1,
-        Local<Value>(),
-        false,
-        false,
-        true,
-        Local<Data>()
-    );
-    ScriptCompiler::Source source(toV8String(isolate, content), scriptOrigin);
     TryCatch tryCatch(isolate);
     Local<Module> module;
-    if (ScriptCompiler::CompileModule(isolate, &source).ToLocal(&module)) {
+    if (compileModule(context, modulePath, content).ToLocal(&module)) {
         esModule->setModulePath(module, std::move(modulePath));
         return handleScope.Escape(module);
     }
@@ -312,11 +552,407 @@ MaybeLocal<Module> resolveModuleCallback(
     return MaybeLocal<Module>();
 }
 
-void doImportModuleDynamically(void* ptr) {
-    auto data = static_cast<DynamicModuleData*>(ptr);
+void evaluateDynamicModule(
+    Local<Context> context,
+    Local<Module> module,
+    Local<Promise::Resolver> resolver,
+    Local<Value> exception
+) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    if (module->GetStatus() == Module::kErrored) {
+        resolver->Reject(context, module->GetException()).Check();
+        return;
+    }
+    TryCatch tryCatch(isolate);
+    if (
+        module->GetStatus() >= Module::kInstantiated ||
+        module->InstantiateModule(context, resolveModuleCallback).FromMaybe(false)
+    ) {
+        resolver->Resolve(context, module->GetModuleNamespace()).Check();
+        Local<Value> value;
+        if (!module->Evaluate(context).ToLocal(&value)) {
+            auto errStr = formatException(context, exception);
+            eprintln(errStr);
+        }
+        Environment::from(context)->getEsModule()->getCodeCache()->flush();
+        return;
+    }
+    if (tryCatch.HasCaught()) {
+        resolver->Reject(context, tryCatch.Exception()).Check();
+    } else {
+        resolver->Reject(context, exception).Check();
+    }
+}
+
+void evaluateJsonModule(
+    Local<Context> context,
+    Local<Module> module,
+    Local<Promise::Resolver> resolver,
+    Local<Value> exception
+) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    TryCatch tryCatch(isolate);
+    if (
+        module->GetStatus() < Module::kInstantiated &&
+        !module->InstantiateModule(context, resolveModuleCallback).FromMaybe(false)
+    ) {
+        if (tryCatch.HasCaught()) {
+            resolver->Reject(context, tryCatch.Exception()).Check();
+        } else {
+            resolver->Reject(context, exception).Check();
+        }
+        return;
+    }
+    if (module->GetStatus() < Module::kEvaluated) {
+        Local<Value> value;
+        if (!module->Evaluate(context).ToLocal(&value) && tryCatch.HasCaught()) {
+            exception = tryCatch.Exception();
+        }
+    }
+    if (module->GetStatus() == Module::kErrored) {
+        resolver->Reject(context, module->GetException()).Check();
+    } else if (module->GetStatus() == Module::kEvaluated) {
+        resolver->Resolve(context, module->GetModuleNamespace()).Check();
+    } else {
+        resolver->Reject(context, exception).Check();
+    }
+}
+
+class ModulePrefetcher;
+
+class PrefetchedModule {
+public:
+    PrefetchedModule(const PrefetchedModule&) = delete;
+
+    PrefetchedModule& operator=(const PrefetchedModule&) = delete;
+
+    PrefetchedModule(PrefetchedModule&&) = delete;
+
+    PrefetchedModule& operator=(PrefetchedModule&&) = delete;
+
+    PrefetchedModule(
+        ModulePrefetcher* prefetcher,
+        const EsModule* esModule,
+        BString&& path,
+        bool json
+    ) :
+        prefetcher(prefetcher),
+        esModule(esModule),
+        path(std::move(path)),
+        json(json)
+    {
+
+    }
+
+    ~PrefetchedModule() = default;
+
+    ModulePrefetcher* const prefetcher;
+    const EsModule* const esModule;
+    const BString path;
+    const bool json;
+    MappedFile file;
+    BString content;
+    std::unique_ptr<ScriptCompiler::CachedData> cachedData;
+    std::unique_ptr<ScriptCompiler::StreamedSource> streamedSource;
+    std::unique_ptr<ScriptCompiler::ScriptStreamingTask> streamingTask;
+    bool loaded{false};
+    bool streamed{false};
+};
+
+class PrefetchSourceStream : public ScriptCompiler::ExternalSourceStream {
+public:
+    PrefetchSourceStream(const PrefetchSourceStream&) = delete;
+
+    PrefetchSourceStream& operator=(const PrefetchSourceStream&) = delete;
+
+    PrefetchSourceStream(PrefetchSourceStream&&) = delete;
+
+    PrefetchSourceStream& operator=(PrefetchSourceStream&&) = delete;
+
+    explicit PrefetchSourceStream(const PrefetchedModule* prefetched) : prefetched(prefetched) {
+
+    }
+
+    ~PrefetchSourceStream() = default;
+
+    size_t GetMoreData(const uint8_t** src) override {
+        const auto& content = prefetched->content;
+        const auto len = content.length();
+        if (consumed || len == 0) {
+            return 0;
+        }
+        consumed = true;
+        auto buf = new uint8_t[len];
+        memcpy(buf, content.data(), len);
+        *src = buf;
+        return len;
+    }
+
+private:
+    const PrefetchedModule* const prefetched;
+    bool consumed{false};
+};
+
+class ModulePrefetcher {
+public:
+    ModulePrefetcher(const ModulePrefetcher&) = delete;
+
+    ModulePrefetcher& operator=(const ModulePrefetcher&) = delete;
+
+    ModulePrefetcher(ModulePrefetcher&&) = delete;
+
+    ModulePrefetcher& operator=(ModulePrefetcher&&) = delete;
+
+    explicit ModulePrefetcher(Environment* env) : env(env) {
+        visitedPaths.reserve(256);
+    }
+
+    ModulePrefetcher(Environment* env, std::unique_ptr<DynamicModuleData> data) :
+        env(env),
+        data(std::move(data))
+    {
+        visitedPaths.reserve(16);
+    }
+
+    ~ModulePrefetcher() = default;
+
+    bool isDynamic() const {
+        return data != nullptr;
+    }
+
+    bool isDone() const {
+        return resolvedCount == submittedCount;
+    }
+
+    void prefetch(Local<Context> context, Local<Module> module, const BString& path);
+
+    void load(BString&& path, bool json);
+
+    void finish(Local<Context> context);
+
+    void onResolved(Local<Context> context, PrefetchedModule* prefetched);
+
+private:
+    void scan(Local<Context> context, Local<Module> module, const BString& path);
+
+    void submit(BString&& path, bool json);
+
+    Environment* env;
+    std::unique_ptr<DynamicModuleData> data;
+    BString rootPath;
+    bool json{false};
+    bool jsonLoaded{false};
+    std::unordered_set<BString, BStringHash> visitedPaths;
+    size_t resolvedCount{0};
+    size_t submittedCount{0};
+};
+
+void handlePrefetchModule(AsyncRequest& req) {
+    auto prefetched = req.get<PrefetchedModule*>(0);
+    if (auto result = prefetched->esModule->readModule(prefetched->path, prefetched->file)) {
+        prefetched->content = result.unwrap();
+        if (!prefetched->json) {
+            prefetched->cachedData.reset(
+                prefetched->esModule->loadCachedData(prefetched->path, prefetched->content)
+            );
+        }
+        if (prefetched->cachedData == nullptr && prefetched->streamingTask != nullptr) {
+            prefetched->streamingTask->Run();
+            prefetched->streamed = true;
+        }
+        prefetched->loaded = true;
+    }
+}
+
+void resolvePrefetchModule(Local<Context> context, AsyncRequest& req) {
+    auto prefetched = req.get<PrefetchedModule*>(0);
+    auto prefetcher = prefetched->prefetcher;
+    prefetcher->onResolved(context, prefetched);
+    if (prefetcher->isDynamic() && prefetcher->isDone()) {
+        ON_SCOPE_EXIT {
+            delete prefetcher;
+        };
+        prefetcher->finish(context);
+    }
+}
+
+MaybeLocal<Module> compilePrefetchedModule(Local<Context> context, PrefetchedModule& prefetched) {
+    if (!prefetched.streamed) {
+        return compileModule(
+            context,
+            prefetched.path,
+            prefetched.content,
+            prefetched.cachedData.release()
+        );
+    }
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto env = Environment::from(context);
+    auto esModule = env->getEsModule();
+    auto codeCache = esModule->getCodeCache();
+    auto scriptOrigin = createModuleOrigin(isolate, prefetched.path);
+    Local<Module> module;
+    if (
+        !ScriptCompiler::CompileModule(
+            context,
+            prefetched.streamedSource.get(),
+            newSourceString(isolate, esModule, prefetched.content),
+            scriptOrigin
+        ).ToLocal(&module)
+    ) {
+        return MaybeLocal<Module>();
+    }
+    codeCache->push(prefetched.path, prefetched.content, module);
+    return handleScope.Escape(module);
+}
+
+void ModulePrefetcher::prefetch(Local<Context> context, Local<Module> module, const BString& path) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    visitedPaths.emplace(path);
+    scan(context, module, path);
+    auto eventLoop = env->getEventLoop();
+    while (resolvedCount < submittedCount) {
+        eventLoop->waitAsyncRequests();
+        eventLoop->runAsyncRequests();
+    }
+}
+
+void ModulePrefetcher::load(BString&& path, bool json) {
+    env->getEventLoop()->ref();
+    rootPath = path;
+    this->json = json;
+    visitedPaths.emplace(path);
+    submit(std::move(path), json);
+}
+
+void ModulePrefetcher::finish(Local<Context> context) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    env->getEventLoop()->unref();
+    auto resolver = data->resolver.Get(isolate);
+    auto exception = data->exception.Get(isolate);
+    auto esModule = env->getEsModule();
+    Local<Module> module;
+    if (json) {
+        if (esModule->findModule(rootPath).ToLocal(&module)) {
+            evaluateJsonModule(context, module, resolver, exception);
+        } else if (jsonLoaded) {
+            module = createJsonModule(isolate, esModule, rootPath);
+            evaluateJsonModule(context, module, resolver, exception);
+        } else {
+            resolver->Reject(context, exception).Check();
+        }
+        return;
+    }
+    if (esModule->findModule(rootPath).ToLocal(&module)) {
+        evaluateDynamicModule(context, module, resolver, exception);
+    } else {
+        resolver->Reject(context, exception).Check();
+    }
+}
+
+void ModulePrefetcher::onResolved(Local<Context> context, PrefetchedModule* prefetched) {
     ON_SCOPE_EXIT {
-        delete data;
+        delete prefetched;
     };
+    resolvedCount++;
+    if (!prefetched->loaded) {
+        return;
+    }
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto esModule = env->getEsModule();
+    Local<Module> module;
+    if (prefetched->json) {
+        if (prefetched->path == rootPath) {
+            jsonLoaded = true;
+        }
+        if (
+            prefetched->file.size() > 0 &&
+            (
+                !esModule->findModule(prefetched->path).ToLocal(&module) ||
+                module->GetStatus() < Module::kEvaluated
+            )
+        ) {
+            esModule->setJsonFile(prefetched->path, std::move(prefetched->file));
+        }
+        return;
+    }
+    if (esModule->findModule(prefetched->path).ToLocal(&module)) {
+        return;
+    }
+    TryCatch tryCatch(isolate);
+    if (!compilePrefetchedModule(context, *prefetched).ToLocal(&module)) {
+        if (isDynamic() && tryCatch.HasCaught() && prefetched->path == rootPath) {
+            data->exception.Reset(isolate, tryCatch.Exception());
+        }
+        return;
+    }
+    esModule->setModulePath(module, prefetched->path);
+    scan(context, module, prefetched->path);
+}
+
+void ModulePrefetcher::scan(Local<Context> context, Local<Module> module, const BString& path) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto esModule = env->getEsModule();
+    auto requests = module->GetModuleRequests();
+    for (int i = 0; i < requests->Length(); i++) {
+        auto req = requests->Get(context, i).As<ModuleRequest>();
+        auto json = findAttrType(context, req->GetImportAttributes(), true) == "json";
+        BString modulePath;
+        auto specifier = toBString(context, req->GetSpecifier());
+        if (isLocalPath(specifier)) {
+            modulePath = resolveLocalPath(path, specifier);
+        } else if (auto result = esModule->findDepsPath(specifier)) {
+            modulePath = result.unwrap();
+        } else {
+            continue;
+        }
+        if (
+            visitedPaths.find(modulePath) != visitedPaths.end() ||
+            !esModule->findModule(modulePath).IsEmpty() ||
+            (json && esModule->findImageModule(modulePath) != nullptr)
+        ) {
+            continue;
+        }
+        visitedPaths.emplace(modulePath);
+        submit(std::move(modulePath), json);
+    }
+}
+
+void ModulePrefetcher::submit(BString&& path, bool json) {
+    auto isolate = env->getIsolate();
+    auto esModule = env->getEsModule();
+    auto prefetched = new PrefetchedModule(this, esModule, std::move(path), json);
+    if (
+        !json &&
+        esModule->findImageModule(prefetched->path) == nullptr &&
+        !esModule->getCodeCache()->hasEntry(prefetched->path)
+    ) {
+        prefetched->streamedSource = std::make_unique<ScriptCompiler::StreamedSource>(
+            std::make_unique<PrefetchSourceStream>(prefetched),
+            ScriptCompiler::StreamedSource::UTF8
+        );
+        prefetched->streamingTask.reset(
+            ScriptCompiler::StartStreaming(
+                isolate,
+                prefetched->streamedSource.get(),
+                ScriptType::kModule
+            )
+        );
+    }
+    AsyncRequest req(handlePrefetchModule, resolvePrefetchModule);
+    req.set(0, prefetched);
+    env->getEventLoop()->submitAsyncRequest(std::move(req));
+    submittedCount++;
+}
+
+void doImportModuleDynamically(void* ptr) {
+    std::unique_ptr<DynamicModuleData> data(static_cast<DynamicModuleData*>(ptr));
     auto isolate = data->isolate;
     HandleScope handleScope(isolate);
     auto context = data->context.Get(isolate);
@@ -331,8 +967,7 @@ void doImportModuleDynamically(void* ptr) {
     auto specifierStr = toBString(context, specifier);
     if (isLocalPath(specifierStr)) {
         auto referrerPath = toBString(context, resourceName);
-        auto referrerDir = dirname(referrerPath);
-        modulePath = joinPath(referrerDir, specifierStr);
+        modulePath = resolveLocalPath(referrerPath, specifierStr);
     } else {
         if (auto result = esModule->findDepsPath(specifierStr)) {
             modulePath = result.unwrap();
@@ -341,82 +976,18 @@ void doImportModuleDynamically(void* ptr) {
             return;
         }
     }
-    BString content;
-    if (auto result = readFile(modulePath)) {
-        content = result.unwrap();
-    } else {
-        resolver->Reject(context, exception).Check();
-        return;
-    }
-    auto attrType = findAttrType(context, importAttrs, false);
-    if (attrType == "json") {
-        TryCatch tryCatch(isolate);
-        Local<Value> value;
-        if (!JSON::Parse(context, toV8String(isolate, content)).ToLocal(&value)) {
-            if (tryCatch.HasCaught()) {
-                auto errStr = formatJsonError(context, tryCatch.Exception(), modulePath);
-                auto v8Str = toV8String(isolate, errStr);
-                resolver->Reject(context, Exception::SyntaxError(v8Str)).Check();
-            } else {
-                resolver->Reject(context, exception).Check();
-            }
-            return;
-        }
-        auto obj = Object::New(isolate);
-        obj->DefineOwnProperty(
-            context,
-            toV8String(isolate, "default"),
-            value,
-            static_cast<PropertyAttribute>(v8::DontDelete)
-        ).Check();
-        obj->DefineOwnProperty(
-            context,
-            Symbol::GetToStringTag(isolate),
-            toV8String(isolate, "Module"),
-            static_cast<PropertyAttribute>(v8::ReadOnly | v8::DontEnum | v8::DontDelete)
-        ).Check();
-        resolver->Resolve(context, obj).Check();
-        return;
-    }
-    ScriptOrigin scriptOrigin(
-        isolate,
-        toV8String(isolate, modulePath),
-        0,
-        0,
-        false,
-        -1,
-        Local<Value>(),
-        false,
-        false,
-        true,
-        Local<Data>()
-    );
-    ScriptCompiler::Source source(toV8String(isolate, content), scriptOrigin);
-    TryCatch tryCatch(isolate);
+    auto json = findAttrType(context, importAttrs, false) == "json";
     Local<Module> module;
-    if (!ScriptCompiler::CompileModule(isolate, &source).ToLocal(&module)) {
-        if (tryCatch.HasCaught()) {
-            resolver->Reject(context, tryCatch.Exception()).Check();
+    if (esModule->findModule(modulePath).ToLocal(&module)) {
+        if (json) {
+            evaluateJsonModule(context, module, resolver, exception);
         } else {
-            resolver->Reject(context, exception).Check();
-        }
-        return;
-    }
-    esModule->setModulePath(module, std::move(modulePath));
-    if (module->InstantiateModule(context, resolveModuleCallback).FromMaybe(false)) {
-        resolver->Resolve(context, module->GetModuleNamespace()).Check();
-        Local<Value> value;
-        if (!module->Evaluate(context).ToLocal(&value)) {
-            auto errStr = formatException(context, exception);
-            eprintln(errStr);
+            evaluateDynamicModule(context, module, resolver, exception);
         }
         return;
     }
-    if (tryCatch.HasCaught()) {
-        resolver->Reject(context, tryCatch.Exception()).Check();
-    } else {
-        resolver->Reject(context, exception).Check();
-    }
+    auto prefetcher = new ModulePrefetcher(env, std::move(data));
+    prefetcher->load(std::move(modulePath), json);
 }
 
 void importMetaObjectResolve(const FunctionCallbackInfo<Value>& info) {
@@ -464,8 +1035,9 @@ void importMetaObjectResolve(const FunctionCallbackInfo<Value>& info) {
 
 namespace kun {
 
-EsModule::EsModule(Environment* env) : env(env) {
+EsModule::EsModule(Environment* env) : env(env), codeCache(env) {
     modulePathMap.reserve(256);
+    moduleMap.reserve(256);
     depsPathMap.reserve(256);
 }
 
@@ -473,63 +1045,136 @@ bool EsModule::execute(const BString& path) {
     auto isolate = env->getIsolate();
     HandleScope handleScope(isolate);
     auto context = env->getContext();
-    auto moduleDir = dirname(path);
-    auto depsJsonPath = joinPath(moduleDir, "deps.json");
-    if (!loadDeps(depsJsonPath)) {
+    Local<Module> module;
+    if (!instantiate(path).ToLocal(&module)) {
         return false;
     }
-    auto content = readFile(path).expect("Module not found '{}'", path);
-    ScriptOrigin scriptOrigin(
-        isolate,
-        toV8String(isolate, path),
-        0,
-        0,
-        false,
-        -1,
-        Local<Value>(),
-        false,
-        false,
-        true,
-        Local<Data>()
-    );
-    ScriptCompiler::Source source(toV8String(isolate, content), scriptOrigin);
+    Local<Promise> promise;
+    if (Local<Value> value; module->Evaluate(context).ToLocal(&value)) {
+        promise = value.As<Promise>();
+    } else {
+        KUN_LOG_ERR("Failed to evaluate module '{}'", path);
+    }
+    env->runMicrotask();
+    codeCache.flush();
+    auto stalled = module->GetStalledTopLevelAwaitMessages(isolate);
+    const auto& messages = stalled.second;
+    for (const auto& message : messages) {
+        auto errStr = formatMessage(context, message);
+        if (!errStr.empty()) {
+            eprintln(errStr);
+        }
+    }
+    return !promise.IsEmpty() && promise->State() == Promise::kFulfilled;
+}
+
+bool EsModule::compile(const BString& path, const BString& imagePath) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (ModuleImage::isImagePath(path)) {
+        eprintln("ERROR: '{}' is already an image", path);
+        return false;
+    }
+    if (instantiate(path).IsEmpty()) {
+        return false;
+    }
+    std::vector<BString> modulePaths;
+    modulePaths.reserve(moduleMap.size());
+    modulePaths.emplace_back(path);
+    for (const auto& [modulePath, module] : moduleMap) {
+        if (modulePath != path) {
+            modulePaths.emplace_back(modulePath);
+        }
+    }
+    std::vector<ImageModule> modules;
+    modules.reserve(modulePaths.size());
+    for (const auto& modulePath : modulePaths) {
+        auto module = findModule(modulePath).ToLocalChecked();
+        ImageModule imageModule;
+        imageModule.path = modulePath;
+        if (auto result = readFile(modulePath)) {
+            imageModule.source = result.unwrap();
+        } else {
+            eprintln("ERROR: Module not found '{}'", modulePath);
+            return false;
+        }
+        if (module->IsSyntheticModule()) {
+            imageModule.type = ImageModuleType::JSON;
+            if (!serializeJsonValue(context, modulePath, imageModule.source, imageModule.data)) {
+                return false;
+            }
+        } else if (codeCache.isEnabled()) {
+            std::unique_ptr<ScriptCompiler::CachedData> cachedData(
+                ScriptCompiler::CreateCodeCache(module->GetUnboundModuleScript())
+            );
+            if (cachedData != nullptr && cachedData->length > 0) {
+                imageModule.data.append(
+                    reinterpret_cast<const char*>(cachedData->data),
+                    static_cast<size_t>(cachedData->length)
+                );
+            }
+        }
+        modules.emplace_back(std::move(imageModule));
+    }
+    std::vector<std::pair<BString, BString>> deps;
+    deps.reserve(depsPathMap.size());
+    for (const auto& [name, moduleDir] : depsPathMap) {
+        deps.emplace_back(name, moduleDir);
+    }
+    return ModuleImage::write(imagePath, modules, deps);
+}
+
+MaybeLocal<Module> EsModule::instantiate(const BString& path) {
+    auto isolate = env->getIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto context = env->getContext();
+    BString entryPath;
+    if (ModuleImage::isImagePath(path)) {
+        if (!image.load(path)) {
+            eprintln("ERROR: Failed to load image '{}'", path);
+            return MaybeLocal<Module>();
+        }
+        for (const auto& [name, moduleDir] : image.getDeps()) {
+            depsPathMap.emplace(name, moduleDir);
+        }
+        entryPath = image.getEntryPath();
+    } else {
+        auto moduleDir = dirname(path);
+        auto depsJsonPath = joinPath(moduleDir, "deps.json");
+        if (!loadDeps(depsJsonPath)) {
+            return MaybeLocal<Module>();
+        }
+        entryPath = BString::view(path);
+    }
+    MappedFile file;
+    auto content = readModule(entryPath, file).expect("Module not found '{}'", entryPath);
     TryCatch tryCatch(isolate);
     Local<Module> module;
-    if (!ScriptCompiler::CompileModule(isolate, &source).ToLocal(&module)) {
+    if (!compileModule(context, entryPath, content).ToLocal(&module)) {
         if (tryCatch.HasCaught()) {
             auto errStr = formatException(context, tryCatch.Exception());
             eprintln(errStr);
         } else {
-            eprintln("ERROR: Failed to compile module '{}'", path);
+            eprintln("ERROR: Failed to compile module '{}'", entryPath);
         }
-        return false;
+        return MaybeLocal<Module>();
+    }
+    setModulePath(module, entryPath);
+    {
+        ModulePrefetcher prefetcher(env);
+        prefetcher.prefetch(context, module, entryPath);
     }
-    modulePathMap.emplace(module->GetIdentityHash(), path);
     if (module->InstantiateModule(context, resolveModuleCallback).FromMaybe(false)) {
-        Local<Promise> promise;
-        if (Local<Value> value; module->Evaluate(context).ToLocal(&value)) {
-            promise = value.As<Promise>();
-        } else {
-            KUN_LOG_ERR("Failed to evaluate module '{}'", path);
-        }
-        env->runMicrotask();
-        auto stalled = module->GetStalledTopLevelAwaitMessages(isolate);
-        const auto& messages = stalled.second;
-        for (const auto& message : messages) {
-            auto errStr = formatMessage(context, message);
-            if (!errStr.empty()) {
-                eprintln(errStr);
-            }
-        }
-        return !promise.IsEmpty() && promise->State() == Promise::kFulfilled;
+        return handleScope.Escape(module);
     }
     if (tryCatch.HasCaught()) {
         auto errStr = formatException(context, tryCatch.Exception());
         eprintln(errStr);
     } else {
-        eprintln("ERROR: Failed to execute module '{}'", path);
+        eprintln("ERROR: Failed to execute module '{}'", entryPath);
     }
-    return false;
+    return MaybeLocal<Module>();
 }
 
 bool EsModule::loadDeps(const BString& path) {
@@ -596,14 +1241,64 @@ bool EsModule::loadDeps(const BString& path) {
     return true;
 }
 
+Result<BString> EsModule::readModule(const BString& path, MappedFile& file) const {
+    if (auto imageModule = image.findModule(path)) {
+        return BString::view(imageModule->source);
+    }
+    if (auto result = mapFile(path, MIN_MAPPED_SOURCE_SIZE)) {
+        file = result.unwrap();
+        return file.view();
+    } else {
+        return result.err();
+    }
+}
+
+ScriptCompiler::CachedData* EsModule::loadCachedData(
+    const BString& path,
+    const BString& source
+) const {
+    auto imageModule = image.findModule(path);
+    if (
+        imageModule != nullptr &&
+        imageModule->type == ImageModuleType::SCRIPT &&
+        !imageModule->data.empty() &&
+        imageModule->source.length() == source.length()
+    ) {
+        return new ScriptCompiler::CachedData(
+            reinterpret_cast<const uint8_t*>(imageModule->data.data()),
+            static_cast<int>(imageModule->data.length()),
+            ScriptCompiler::CachedData::BufferNotOwned
+        );
+    }
+    return codeCache.load(path, source);
+}
+
 void EsModule::setModulePath(Local<Module> module, const BString& path) {
+    auto isolate = env->getIsolate();
+    moduleMap.insert_or_assign(path, Global<Module>(isolate, module));
     modulePathMap.insert_or_assign(module->GetIdentityHash(), path);
 }
 
 void EsModule::setModulePath(Local<Module> module, BString&& path) {
+    auto isolate = env->getIsolate();
+    moduleMap.insert_or_assign(path, Global<Module>(isolate, module));
     modulePathMap.insert_or_assign(module->GetIdentityHash(), std::move(path));
 }
 
+void EsModule::setJsonFile(const BString& path, MappedFile&& file) {
+    jsonFileMap.insert_or_assign(path, std::move(file));
+}
+
+bool EsModule::takeJsonFile(const BString& path, MappedFile& file) {
+    auto iter = jsonFileMap.find(path);
+    if (iter == jsonFileMap.end()) {
+        return false;
+    }
+    file = std::move(iter->second);
+    jsonFileMap.erase(iter);
+    return true;
+}
+
 Result<BString> EsModule::findModulePath(Local<Module> module) const {
     auto iter = modulePathMap.find(module->GetIdentityHash());
     if (iter != modulePathMap.end()) {
@@ -612,6 +1307,14 @@ Result<BString> EsModule::findModulePath(Local<Module> module) const {
     return SysErr("Module not found");
 }
 
+MaybeLocal<Module> EsModule::findModule(const BString& path) const {
+    auto iter = moduleMap.find(path);
+    if (iter != moduleMap.end()) {
+        return iter->second.Get(env->getIsolate());
+    }
+    return MaybeLocal<Module>();
+}
+
 Result<BString> EsModule::findDepsPath(const BString& specifier) const {
     auto index = specifier.find("/");
     if (index == BString::END) {
@@ -628,7 +1331,7 @@ Result<BString> EsModule::findDepsPath(const BString& specifier) const {
         return SysErr("Dependency not found");
     }
     auto path = joinPath(iter->second, suffix);
-    if (!pathExists(path)) {
+    if (image.findModule(path) == nullptr && !pathExists(path)) {
         return SysErr("Dependency not exists");
     }
     return path;
@@ -1,10 +1,15 @@
 #ifndef KUN_MODULE_ES_MODULE_H
 #define KUN_MODULE_ES_MODULE_H
 
+#include <memory>
 #include <unordered_map>
 
+#include "v8.h"
 #include "env/environment.h"
+#include "module/code_cache.h"
+#include "module/module_image.h"
 #include "util/bstring.h"
+#include "util/file_info.h"
 #include "util/result.h"
 
 namespace kun {
@@ -25,24 +30,57 @@ public:
 
     bool execute(const BString& path);
 
+    bool compile(const BString& path, const BString& imagePath);
+
     bool loadDeps(const BString& path);
 
+    Result<BString> readModule(const BString& path, MappedFile& file) const;
+
+    v8::ScriptCompiler::CachedData* loadCachedData(
+        const BString& path,
+        const BString& source
+    ) const;
+
+    const ImageModule* findImageModule(const BString& path) const {
+        return image.findModule(path);
+    }
+
+    std::shared_ptr<const MappedFile> findImageMapping(const BString& str) const {
+        return image.findMapping(str);
+    }
+
     void setModulePath(v8::Local<v8::Module> module, const BString& path);
 
     void setModulePath(v8::Local<v8::Module> module, BString&& path);
 
+    void setJsonFile(const BString& path, MappedFile&& file);
+
+    bool takeJsonFile(const BString& path, MappedFile& file);
+
     Result<BString> findModulePath(v8::Local<v8::Module> module) const;
 
+    v8::MaybeLocal<v8::Module> findModule(const BString& path) const;
+
     Result<BString> findDepsPath(const BString& specifier) const;
 
     Environment* getEnvironment() const {
         return env;
     }
 
+    CodeCache* getCodeCache() {
+        return &codeCache;
+    }
+
 private:
+    v8::MaybeLocal<v8::Module> instantiate(const BString& path);
+
     Environment* env;
+    CodeCache codeCache;
+    ModuleImage image;
     std::unordered_map<int, BString> modulePathMap;
+    std::unordered_map<BString, v8::Global<v8::Module>, BStringHash> moduleMap;
     std::unordered_map<BString, BString, BStringHash> depsPathMap;
+    std::unordered_map<BString, MappedFile, BStringHash> jsonFileMap;
 };
 
 namespace esm {
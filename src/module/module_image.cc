@@ -0,0 +1,229 @@
+#include "module/module_image.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+
+#include "sys/fs.h"
+
+using kun::BString;
+using kun::ImageModule;
+using kun::ImageModuleType;
+using kun::sys::mapFile;
+using kun::sys::replaceFile;
+
+namespace {
+
+constexpr uint32_t IMAGE_MAGIC = 0x474d494b;
+constexpr uint32_t IMAGE_VERSION = 1;
+
+struct ImageHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t moduleCount;
+    uint32_t depsCount;
+};
+
+struct ImageModuleEntry {
+    uint64_t pathOffset;
+    uint64_t pathLength;
+    uint64_t sourceOffset;
+    uint64_t sourceLength;
+    uint64_t dataOffset;
+    uint64_t dataLength;
+    uint32_t type;
+    uint32_t reserved;
+};
+
+struct ImageDepsEntry {
+    uint64_t nameOffset;
+    uint64_t nameLength;
+    uint64_t dirOffset;
+    uint64_t dirLength;
+};
+
+inline size_t alignOffset(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+uint64_t appendSection(BString& content, const BString& section) {
+    auto offset = alignOffset(content.length());
+    if (offset > content.length()) {
+        constexpr char zeros[8] = {};
+        content.append(zeros, offset - content.length());
+    }
+    content.append(section.data(), section.length());
+    return offset;
+}
+
+bool viewSection(
+    const char* base,
+    size_t size,
+    uint64_t offset,
+    uint64_t length,
+    BString& section
+) {
+    if (offset > size || length > size - offset) {
+        return false;
+    }
+    section = length > 0 ? BString::view(base + offset, length) : BString();
+    return true;
+}
+
+}
+
+namespace kun {
+
+bool ModuleImage::load(const BString& path) {
+    if (auto result = mapFile(path)) {
+        mappedFile = std::make_shared<MappedFile>(result.unwrap());
+    } else {
+        return false;
+    }
+    auto base = mappedFile->data();
+    auto size = mappedFile->size();
+    if (size < sizeof(ImageHeader)) {
+        return false;
+    }
+    ImageHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (
+        header.magic != IMAGE_MAGIC ||
+        header.version != IMAGE_VERSION ||
+        header.moduleCount == 0
+    ) {
+        return false;
+    }
+    const auto moduleTableSize = sizeof(ImageModuleEntry) * header.moduleCount;
+    const auto depsTableSize = sizeof(ImageDepsEntry) * header.depsCount;
+    if (size - sizeof(header) < moduleTableSize + depsTableSize) {
+        return false;
+    }
+    auto p = base + sizeof(header);
+    modules.reserve(header.moduleCount);
+    moduleIndexMap.reserve(header.moduleCount);
+    for (uint32_t i = 0; i < header.moduleCount; i++) {
+        ImageModuleEntry entry;
+        memcpy(&entry, p, sizeof(entry));
+        p += sizeof(entry);
+        ImageModule module;
+        if (
+            !viewSection(base, size, entry.pathOffset, entry.pathLength, module.path) ||
+            !viewSection(base, size, entry.sourceOffset, entry.sourceLength, module.source) ||
+            !viewSection(base, size, entry.dataOffset, entry.dataLength, module.data) ||
+            entry.type > static_cast<uint32_t>(ImageModuleType::JSON)
+        ) {
+            modules.clear();
+            moduleIndexMap.clear();
+            return false;
+        }
+        module.type = static_cast<ImageModuleType>(entry.type);
+        moduleIndexMap.emplace(module.path, modules.size());
+        modules.emplace_back(std::move(module));
+    }
+    deps.reserve(header.depsCount);
+    for (uint32_t i = 0; i < header.depsCount; i++) {
+        ImageDepsEntry entry;
+        memcpy(&entry, p, sizeof(entry));
+        p += sizeof(entry);
+        BString name;
+        BString dir;
+        if (
+            !viewSection(base, size, entry.nameOffset, entry.nameLength, name) ||
+            !viewSection(base, size, entry.dirOffset, entry.dirLength, dir)
+        ) {
+            modules.clear();
+            moduleIndexMap.clear();
+            deps.clear();
+            return false;
+        }
+        deps.emplace_back(std::move(name), std::move(dir));
+    }
+    return true;
+}
+
+const ImageModule* ModuleImage::findModule(const BString& path) const {
+    auto iter = moduleIndexMap.find(path);
+    if (iter != moduleIndexMap.end()) {
+        return &modules[iter->second];
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const MappedFile> ModuleImage::findMapping(const BString& str) const {
+    if (mappedFile == nullptr || str.empty()) {
+        return nullptr;
+    }
+    const auto size = mappedFile->size();
+    const auto len = str.length();
+    auto base = reinterpret_cast<uintptr_t>(mappedFile->data());
+    auto begin = reinterpret_cast<uintptr_t>(str.data());
+    if (len > size || begin < base || begin - base > size - len) {
+        return nullptr;
+    }
+    return mappedFile;
+}
+
+Result<bool> ModuleImage::write(
+    const BString& path,
+    const std::vector<ImageModule>& modules,
+    const std::vector<std::pair<BString, BString>>& deps
+) {
+    ImageHeader header;
+    header.magic = IMAGE_MAGIC;
+    header.version = IMAGE_VERSION;
+    header.moduleCount = static_cast<uint32_t>(modules.size());
+    header.depsCount = static_cast<uint32_t>(deps.size());
+    const auto tableSize =
+        sizeof(header) +
+        sizeof(ImageModuleEntry) * modules.size() +
+        sizeof(ImageDepsEntry) * deps.size();
+    std::vector<ImageModuleEntry> moduleEntries;
+    moduleEntries.reserve(modules.size());
+    std::vector<ImageDepsEntry> depsEntries;
+    depsEntries.reserve(deps.size());
+    auto contentSize = tableSize;
+    for (const auto& module : modules) {
+        contentSize += module.path.length() + module.source.length() + module.data.length() + 24;
+    }
+    for (const auto& [name, dir] : deps) {
+        contentSize += name.length() + dir.length() + 16;
+    }
+    BString content;
+    content.reserve(contentSize);
+    content.resize(tableSize);
+    for (const auto& module : modules) {
+        ImageModuleEntry entry;
+        entry.pathLength = module.path.length();
+        entry.pathOffset = appendSection(content, module.path);
+        entry.sourceLength = module.source.length();
+        entry.sourceOffset = appendSection(content, module.source);
+        entry.dataLength = module.data.length();
+        entry.dataOffset = appendSection(content, module.data);
+        entry.type = static_cast<uint32_t>(module.type);
+        entry.reserved = 0;
+        moduleEntries.emplace_back(entry);
+    }
+    for (const auto& [name, dir] : deps) {
+        ImageDepsEntry entry;
+        entry.nameLength = name.length();
+        entry.nameOffset = appendSection(content, name);
+        entry.dirLength = dir.length();
+        entry.dirOffset = appendSection(content, dir);
+        depsEntries.emplace_back(entry);
+    }
+    auto p = content.data();
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    if (!moduleEntries.empty()) {
+        memcpy(p, moduleEntries.data(), sizeof(ImageModuleEntry) * moduleEntries.size());
+        p += sizeof(ImageModuleEntry) * moduleEntries.size();
+    }
+    if (!depsEntries.empty()) {
+        memcpy(p, depsEntries.data(), sizeof(ImageDepsEntry) * depsEntries.size());
+    }
+    return replaceFile(path, content);
+}
+
+}
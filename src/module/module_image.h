@@ -0,0 +1,81 @@
+#ifndef KUN_MODULE_MODULE_IMAGE_H
+#define KUN_MODULE_MODULE_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "util/bstring.h"
+#include "util/file_info.h"
+#include "util/result.h"
+
+namespace kun {
+
+enum class ImageModuleType : uint32_t {
+    SCRIPT = 0,
+    JSON
+};
+
+class ImageModule {
+public:
+    BString path;
+    BString source;
+    BString data;
+    ImageModuleType type{ImageModuleType::SCRIPT};
+};
+
+class ModuleImage {
+public:
+    ModuleImage(const ModuleImage&) = delete;
+
+    ModuleImage& operator=(const ModuleImage&) = delete;
+
+    ModuleImage(ModuleImage&&) = delete;
+
+    ModuleImage& operator=(ModuleImage&&) = delete;
+
+    ModuleImage() = default;
+
+    ~ModuleImage() = default;
+
+    bool load(const BString& path);
+
+    const ImageModule* findModule(const BString& path) const;
+
+    std::shared_ptr<const MappedFile> findMapping(const BString& str) const;
+
+    BString getEntryPath() const {
+        return modules.empty() ? BString() : BString::view(modules.front().path);
+    }
+
+    const std::vector<std::pair<BString, BString>>& getDeps() const {
+        return deps;
+    }
+
+    bool isLoaded() const {
+        return !modules.empty();
+    }
+
+    static bool isImagePath(const BString& path) {
+        return path.endsWith(".kimg");
+    }
+
+    static Result<bool> write(
+        const BString& path,
+        const std::vector<ImageModule>& modules,
+        const std::vector<std::pair<BString, BString>>& deps
+    );
+
+private:
+    std::shared_ptr<MappedFile> mappedFile;
+    std::vector<ImageModule> modules;
+    std::unordered_map<BString, size_t, BStringHash> moduleIndexMap;
+    std::vector<std::pair<BString, BString>> deps;
+};
+
+}
+
+#endif
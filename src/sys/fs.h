@@ -15,6 +15,18 @@ inline Result<BString> readFile(const BString& path) {
     return KUN_SYS::readFile(path);
 }
 
+inline Result<MappedFile> mapFile(const BString& path, size_t minMapSize = 0) {
+    return KUN_SYS::mapFile(path, minMapSize);
+}
+
+inline Result<bool> writeFile(const BString& path, const BString& content) {
+    return KUN_SYS::writeFile(path, content);
+}
+
+inline Result<bool> replaceFile(const BString& path, const BString& content) {
+    return KUN_SYS::replaceFile(path, content);
+}
+
 inline Result<bool> makeDirs(const BString& path) {
     return KUN_SYS::makeDirs(path);
 }
@@ -23,6 +35,22 @@ inline Result<bool> removeDir(const BString& path) {
     return KUN_SYS::removeDir(path);
 }
 
+inline Result<FileStat> getFileStat(const BString& path) {
+    return KUN_SYS::getFileStat(path);
+}
+
+inline Result<std::vector<DirEntry>> readDir(const BString& path) {
+    return KUN_SYS::readDir(path);
+}
+
+inline Result<bool> makeDir(const BString& path) {
+    return KUN_SYS::makeDir(path);
+}
+
+inline Result<bool> removePath(const BString& path) {
+    return KUN_SYS::removePath(path);
+}
+
 }
 
 #endif
@@ -1,7 +1,9 @@
 #ifndef KUN_SYS_IO_H
 #define KUN_SYS_IO_H
 
+#include "util/bstring.h"
 #include "util/constants.h"
+#include "util/output_buffer.h"
 #include "util/types.h"
 
 #if defined(KUN_PLATFORM_UNIX)
@@ -12,26 +14,44 @@
 
 namespace kun::sys {
 
+template<int N, typename... TS>
+inline void fprint(bool newline, const BString& fmt, TS&&... args) {
+    BString str;
+    if constexpr (sizeof...(args) == 0) {
+        str = BString::view(fmt);
+    } else {
+        str = BString::format(fmt, std::forward<TS>(args)...);
+    }
+    if (auto outputBuffer = OutputBuffer::current()) {
+        outputBuffer->write(N, str.data(), str.length());
+        if (newline) {
+            outputBuffer->write(N, "\n", 1);
+        }
+    } else if (newline) {
+        KUN_SYS::writeStdio<N>(str.data(), str.length(), "\n", 1);
+    } else {
+        KUN_SYS::writeStdio<N>(str.data(), str.length());
+    }
+}
+
 template<typename... TS>
 inline void print(const BString& fmt, TS&&... args) {
-    KUN_SYS::fprint<1>(fmt, std::forward<TS>(args)...);
+    fprint<1>(false, fmt, std::forward<TS>(args)...);
 }
 
 template<typename... TS>
 inline void println(const BString& fmt, TS&&... args) {
-    KUN_SYS::fprint<1>(fmt, std::forward<TS>(args)...);
-    KUN_SYS::fprint<1>("\n");
+    fprint<1>(true, fmt, std::forward<TS>(args)...);
 }
 
 template<typename... TS>
 inline void eprint(const BString& fmt, TS&&... args) {
-    KUN_SYS::fprint<2>(fmt, std::forward<TS>(args)...);
+    fprint<2>(false, fmt, std::forward<TS>(args)...);
 }
 
 template<typename... TS>
 inline void eprintln(const BString& fmt, TS&&... args) {
-    KUN_SYS::fprint<2>(fmt, std::forward<TS>(args)...);
-    KUN_SYS::fprint<2>("\n");
+    fprint<2>(true, fmt, std::forward<TS>(args)...);
 }
 
 inline Result<bool> setNonblocking(KUN_FD_TYPE fd) {
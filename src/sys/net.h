@@ -0,0 +1,32 @@
+#ifndef KUN_SYS_NET_H
+#define KUN_SYS_NET_H
+
+#include "util/constants.h"
+
+#ifdef KUN_PLATFORM_UNIX
+
+#include "unix/net.h"
+
+namespace kun::sys {
+
+inline Result<int> createSocket(int family) {
+    return KUN_SYS::createSocket(family);
+}
+
+inline Result<int> listenTcp(const BString& hostname, int port) {
+    return KUN_SYS::listenTcp(hostname, port);
+}
+
+inline Result<int> acceptTcp(int fd) {
+    return KUN_SYS::acceptTcp(fd);
+}
+
+inline Result<bool> setNoDelay(int fd) {
+    return KUN_SYS::setNoDelay(fd);
+}
+
+}
+
+#endif
+
+#endif
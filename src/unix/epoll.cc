@@ -4,11 +4,27 @@
 
 #include <errno.h>
 #include <unistd.h>
-#include <sys/timerfd.h>
 
+#include "env/cmdline.h"
 #include "loop/timer.h"
+#include "sys/io.h"
+#include "sys/time.h"
 #include "util/utils.h"
 
+using kun::BString;
+using kun::Cmdline;
+using kun::sys::eprintln;
+using kun::sys::nanosecond;
+
+namespace {
+
+inline uint64_t currentTime() {
+    auto ts = nanosecond().unwrap();
+    return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+}
+
 namespace kun {
 
 EventLoop::EventLoop(Environment* env) : env(env), asyncHandler(env) {
@@ -17,26 +33,62 @@ EventLoop::EventLoop(Environment* env) : env(env), asyncHandler(env) {
         if (!addChannel(&asyncHandler)) {
             KUN_LOG_ERR("Failed to add AsyncHandler");
         }
+        auto cmdline = env->getCmdline();
+        auto ioBackend = cmdline->get<BString>(Cmdline::IO_BACKEND).unwrap();
+        if (ioBackend == "uring") {
+            ioUring = std::make_unique<IoUring>(env, this);
+            if (!ioUring->isValid()) {
+                eprintln("io_uring is unavailable, falling back to the thread pool");
+                ioUring.reset();
+            }
+        }
+        auto maxBacklog = cmdline->get<size_t>(Cmdline::STDIO_BACKLOG).unwrap();
+        auto stdioPolicy = cmdline->get<BString>(Cmdline::STDIO_POLICY).unwrap();
+        auto outputBuffer = env->getOutputBuffer();
+        for (int stream = 1; stream <= 2; stream++) {
+            if (StdioWriter::isNonblockingPipe(stream)) {
+                auto& stdioWriter = stdioWriters[stream - 1];
+                stdioWriter = std::make_unique<StdioWriter>(
+                    this,
+                    stream,
+                    maxBacklog,
+                    stdioPolicy == "drop"
+                );
+                outputBuffer->setStdioWriter(stream, stdioWriter.get());
+            }
+        }
     } else {
         KUN_LOG_ERR(errno);
     }
 }
 
 EventLoop::~EventLoop() {
+    env->flushOutput();
+    for (int stream = 1; stream <= 2; stream++) {
+        if (stdioWriters[stream - 1]) {
+            env->getOutputBuffer()->setStdioWriter(stream, nullptr);
+            stdioWriters[stream - 1].reset();
+        }
+    }
     if (backendFd != -1 && ::close(backendFd) == -1) {
         KUN_LOG_ERR(errno);
     }
 }
 
 void EventLoop::run() {
-    if (backendFd == -1 || channelCount <= 1) {
+    if (backendFd == -1 || (channelCount <= 1 && timerWheel.empty() && refCount == 0)) {
         return;
     }
     constexpr int maxEvents = 1024;
     struct epoll_event epollEvents[maxEvents];
     int nfds = 0;
     while (true) {
-        nfds = ::epoll_wait(backendFd, epollEvents, maxEvents, -1);
+        if (ioUring) {
+            ioUring->flush();
+        }
+        env->flushOutput();
+        auto timeout = timerWheel.nextTimeout(currentTime());
+        nfds = ::epoll_wait(backendFd, epollEvents, maxEvents, timeout);
         if (nfds == -1) {
             if (errno == EINTR) {
                 continue;
@@ -44,28 +96,31 @@ void EventLoop::run() {
             KUN_LOG_ERR(errno);
             break;
         }
+        readyEvents = epollEvents;
+        readyCount = nfds;
         for (int i = 0; i < nfds; i++) {
             auto events = epollEvents[i].events;
             auto channel = static_cast<Channel*>(epollEvents[i].data.ptr);
-            if (channel->type == ChannelType::TIMER) {
-                auto timer = static_cast<Timer*>(channel);
-                uint64_t value;
-                if (::read(timer->fd, &value, sizeof(value)) == -1) {
-                    KUN_LOG_ERR(errno);
+            if (channel == nullptr) {
+                continue;
+            }
+            if (events & (EPOLLIN | EPOLLOUT)) {
+                if (events & EPOLLIN) {
+                    channel->onReadable();
                 }
-                if (!timer->repeat) {
-                    removeChannel(timer);
+                if ((events & EPOLLOUT) && epollEvents[i].data.ptr != nullptr) {
+                    channel->onWritable();
                 }
-            }
-            if (events & EPOLLIN) {
-                channel->onReadable();
-            } else if (events & EPOLLOUT) {
-                channel->onWritable();
             } else if (events & (EPOLLERR | EPOLLHUP)) {
                 channel->onError();
             }
         }
-        if (channelCount <= 1) {
+        readyEvents = nullptr;
+        readyCount = 0;
+        if (!timerWheel.empty()) {
+            timerWheel.expire(currentTime());
+        }
+        if (stopped || (channelCount <= 1 && timerWheel.empty() && refCount == 0)) {
             if (asyncHandler.tryClose()) {
                 break;
             }
@@ -74,6 +129,11 @@ void EventLoop::run() {
 }
 
 bool EventLoop::addChannel(Channel* channel) {
+    if (channel->type == ChannelType::TIMER) {
+        auto timer = static_cast<Timer*>(channel);
+        timerWheel.add(timer, currentTime());
+        return true;
+    }
     if (channel->fd == KUN_INVALID_FD) {
         KUN_LOG_ERR("invalid fd");
         return false;
@@ -83,22 +143,8 @@ bool EventLoop::addChannel(Channel* channel) {
         ev.events = EPOLLET | EPOLLIN;
     } else if (channel->type == ChannelType::WRITE) {
         ev.events = EPOLLET | EPOLLOUT;
-    } else if (channel->type == ChannelType::TIMER) {
-        ev.events = EPOLLET | EPOLLIN;
-        auto timer = static_cast<Timer*>(channel);
-        const auto repeat = timer->repeat;
-        auto value = timer->getValue(TimeUnit::NANOSECOND);
-        auto s = static_cast<time_t>(value / 1000000000);
-        auto ns = static_cast<long>(value - s * 1000000000);
-        struct itimerspec newValue;
-        newValue.it_interval.tv_sec = repeat ? s : 0;
-        newValue.it_interval.tv_nsec = repeat ? ns : 0;
-        newValue.it_value.tv_sec = s;
-        newValue.it_value.tv_nsec = ns;
-        if (::timerfd_settime(timer->fd, 0, &newValue, nullptr) == -1) {
-            KUN_LOG_ERR(errno);
-            return false;
-        }
+    } else if (channel->type == ChannelType::READ_WRITE) {
+        ev.events = EPOLLET | EPOLLIN | EPOLLOUT;
     } else {
         KUN_LOG_ERR("invalid channel type");
         return false;
@@ -122,6 +168,8 @@ bool EventLoop::modifyChannel(Channel* channel) {
         ev.events = EPOLLET | EPOLLIN;
     } else if (channel->type == ChannelType::WRITE) {
         ev.events = EPOLLET | EPOLLOUT;
+    } else if (channel->type == ChannelType::READ_WRITE) {
+        ev.events = EPOLLET | EPOLLIN | EPOLLOUT;
     } else {
         KUN_LOG_ERR("invalid channel type");
         return false;
@@ -135,6 +183,11 @@ bool EventLoop::modifyChannel(Channel* channel) {
 }
 
 bool EventLoop::removeChannel(Channel* channel) {
+    if (channel->type == ChannelType::TIMER) {
+        auto timer = static_cast<Timer*>(channel);
+        timerWheel.remove(timer);
+        return true;
+    }
     if (channel->fd == KUN_INVALID_FD) {
         KUN_LOG_ERR("invalid fd");
         return false;
@@ -146,6 +199,11 @@ bool EventLoop::removeChannel(Channel* channel) {
         KUN_LOG_ERR(errno);
         return false;
     }
+    for (int i = 0; i < readyCount; i++) {
+        if (readyEvents[i].data.ptr == channel) {
+            readyEvents[i].data.ptr = nullptr;
+        }
+    }
     if (channelCount > 0) {
         channelCount--;
     }
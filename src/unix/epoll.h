@@ -8,9 +8,14 @@
 #include <stdint.h>
 #include <sys/epoll.h>
 
+#include <memory>
+
 #include "env/environment.h"
 #include "loop/async_handler.h"
 #include "loop/channel.h"
+#include "loop/timer_wheel.h"
+#include "unix/io_uring.h"
+#include "unix/stdio_writer.h"
 
 namespace kun {
 
@@ -40,11 +45,48 @@ public:
         asyncHandler.submit(std::move(req));
     }
 
+    void postAsyncRequest(AsyncRequest&& req) {
+        asyncHandler.post(std::move(req));
+    }
+
+    void runAsyncRequests() {
+        asyncHandler.runResolvedRequests();
+    }
+
+    void waitAsyncRequests() {
+        asyncHandler.waitResolvedRequests();
+    }
+
+    void ref() {
+        ++refCount;
+    }
+
+    void unref() {
+        if (refCount > 0) {
+            --refCount;
+        }
+    }
+
+    void stop() {
+        stopped = true;
+    }
+
+    IoUring* getIoUring() const {
+        return ioUring.get();
+    }
+
 private:
     Environment* env;
     AsyncHandler asyncHandler;
+    TimerWheel timerWheel;
+    uint32_t refCount{0};
+    bool stopped{false};
+    std::unique_ptr<IoUring> ioUring;
+    std::unique_ptr<StdioWriter> stdioWriters[2];
     uint32_t channelCount{0};
     int backendFd;
+    struct epoll_event* readyEvents{nullptr};
+    int readyCount{0};
 };
 
 }
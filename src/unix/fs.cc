@@ -5,11 +5,15 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stdio.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 
+#include <atomic>
 #include <vector>
 
 #include "sys/path.h"
@@ -19,6 +23,29 @@
 
 using kun::sys::joinPath;
 
+namespace {
+
+inline kun::FileType toFileType(mode_t mode) {
+    if (S_ISREG(mode)) {
+        return kun::FileType::FILE;
+    }
+    if (S_ISDIR(mode)) {
+        return kun::FileType::DIRECTORY;
+    }
+    if (S_ISLNK(mode)) {
+        return kun::FileType::SYMLINK;
+    }
+    return kun::FileType::UNKNOWN;
+}
+
+inline double toMillisecond(const struct timespec& ts) {
+    return static_cast<double>(ts.tv_sec) * 1000 + static_cast<double>(ts.tv_nsec) / 1000000;
+}
+
+std::atomic<uint64_t> tempFileCount{0};
+
+}
+
 namespace KUN_SYS {
 
 Result<BString> readFile(const BString& path) {
@@ -63,6 +90,104 @@ Result<BString> readFile(const BString& path) {
     return result;
 }
 
+Result<MappedFile> mapFile(const BString& path, size_t minMapSize) {
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return SysErr(errno);
+    }
+    ON_SCOPE_EXIT {
+        if (::close(fd) == -1) {
+            KUN_LOG_ERR(errno);
+        }
+    };
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+        return SysErr(errno);
+    }
+    if (!S_ISREG(st.st_mode)) {
+        return SysErr(SysErr::NOT_REGULAR_FILE);
+    }
+    if (st.st_size <= 0) {
+        return MappedFile();
+    }
+    auto len = static_cast<size_t>(st.st_size);
+    if (len < minMapSize) {
+        auto buf = static_cast<char*>(::malloc(len));
+        if (buf == nullptr) {
+            return SysErr(ENOMEM);
+        }
+        size_t nread = 0;
+        while (nread < len) {
+            auto rc = ::read(fd, buf + nread, len - nread);
+            if (rc > 0) {
+                nread += static_cast<size_t>(rc);
+                continue;
+            }
+            if (rc == -1 && (errno == EAGAIN || errno == EINTR)) {
+                continue;
+            }
+            if (rc == -1) {
+                auto errCode = errno;
+                ::free(buf);
+                return SysErr(errCode);
+            }
+            break;
+        }
+        return MappedFile(buf, nread, false);
+    }
+    auto addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        return SysErr(errno);
+    }
+    return MappedFile(addr, len, true);
+}
+
+Result<bool> writeFile(const BString& path, const BString& content) {
+    auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return SysErr(errno);
+    }
+    ON_SCOPE_EXIT {
+        if (::close(fd) == -1) {
+            KUN_LOG_ERR(errno);
+        }
+    };
+    const char* p = content.data();
+    auto end = p + content.length();
+    while (p < end) {
+        size_t len = end - p;
+        auto rc = ::write(fd, p, len);
+        if (rc > 0) {
+            p += rc;
+            continue;
+        }
+        if (rc == -1 && (errno == EAGAIN || errno == EINTR)) {
+            continue;
+        }
+        return SysErr(rc == -1 ? errno : SysErr::WRITE_ERROR);
+    }
+    return true;
+}
+
+Result<bool> replaceFile(const BString& path, const BString& content) {
+    auto tempPath = BString::format(
+        "{}.{}.{}.tmp",
+        path,
+        static_cast<int64_t>(::getpid()),
+        tempFileCount.fetch_add(1, std::memory_order_relaxed)
+    );
+    if (auto result = writeFile(tempPath, content); !result) {
+        ::unlink(tempPath.c_str());
+        return result.err();
+    }
+    if (::rename(tempPath.c_str(), path.c_str()) == -1) {
+        auto errCode = errno;
+        ::unlink(tempPath.c_str());
+        return SysErr(errCode);
+    }
+    return true;
+}
+
 Result<bool> makeDirs(const BString& path) {
     auto len = path.length();
     auto begin = path.data();
@@ -88,6 +213,13 @@ Result<bool> makeDirs(const BString& path) {
 }
 
 Result<bool> removeDir(const BString& path) {
+    struct stat rootSt;
+    if (::lstat(path.c_str(), &rootSt) == -1) {
+        return SysErr(errno);
+    }
+    if (!S_ISDIR(rootSt.st_mode)) {
+        return SysErr(SysErr::NOT_DIRECTORY);
+    }
     std::vector<BString> dirs;
     dirs.reserve(128);
     dirs.emplace_back(BString::view(path));
@@ -114,15 +246,13 @@ Result<bool> removeDir(const BString& path) {
             }
             auto filePath = joinPath(dir, name);
             struct stat st;
-            if (::stat(filePath.c_str(), &st) == -1) {
+            if (::lstat(filePath.c_str(), &st) == -1) {
                 return SysErr(errno);
             }
             if (S_ISDIR(st.st_mode)) {
                 dirs.emplace_back(std::move(filePath));
-            } else if (S_ISREG(st.st_mode)) {
-                if (::unlink(filePath.c_str()) == -1) {
-                    return SysErr(errno);
-                }
+            } else if (::unlink(filePath.c_str()) == -1) {
+                return SysErr(errno);
             }
         }
     }
@@ -135,6 +265,92 @@ Result<bool> removeDir(const BString& path) {
     return true;
 }
 
+Result<FileStat> getFileStat(const BString& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) == -1) {
+        return SysErr(errno);
+    }
+    FileStat fileStat;
+    fileStat.type = toFileType(st.st_mode);
+    fileStat.size = static_cast<uint64_t>(st.st_size);
+    fileStat.mode = static_cast<uint32_t>(st.st_mode & 07777);
+    #if defined(KUN_PLATFORM_DARWIN)
+    fileStat.atime = toMillisecond(st.st_atimespec);
+    fileStat.mtime = toMillisecond(st.st_mtimespec);
+    #else
+    fileStat.atime = toMillisecond(st.st_atim);
+    fileStat.mtime = toMillisecond(st.st_mtim);
+    #endif
+    return fileStat;
+}
+
+Result<std::vector<DirEntry>> readDir(const BString& path) {
+    DIR* dp = ::opendir(path.c_str());
+    if (dp == nullptr) {
+        return SysErr(errno);
+    }
+    ON_SCOPE_EXIT {
+        if (::closedir(dp) == -1) {
+            KUN_LOG_ERR(errno);
+        }
+    };
+    std::vector<DirEntry> entries;
+    entries.reserve(64);
+    struct dirent* de = nullptr;
+    while ((de = ::readdir(dp)) != nullptr) {
+        auto name = BString::view(de->d_name, strlen(de->d_name));
+        if (name == "." || name == "..") {
+            continue;
+        }
+        auto fileType = FileType::UNKNOWN;
+        if (de->d_type == DT_REG) {
+            fileType = FileType::FILE;
+        } else if (de->d_type == DT_DIR) {
+            fileType = FileType::DIRECTORY;
+        } else if (de->d_type == DT_LNK) {
+            fileType = FileType::SYMLINK;
+        } else if (de->d_type == DT_UNKNOWN) {
+            struct stat st;
+            auto filePath = joinPath(path, name);
+            if (::lstat(filePath.c_str(), &st) == 0) {
+                fileType = toFileType(st.st_mode);
+            }
+        }
+        entries.emplace_back(BString(name.data(), name.length()), fileType);
+    }
+    return entries;
+}
+
+Result<bool> makeDir(const BString& path) {
+    if (::mkdir(path.c_str(), 0777) == -1) {
+        return SysErr(errno);
+    }
+    return true;
+}
+
+Result<bool> removePath(const BString& path) {
+    if (::remove(path.c_str()) == -1) {
+        return SysErr(errno);
+    }
+    return true;
+}
+
+}
+
+namespace kun {
+
+void MappedFile::reset() {
+    if (addr != nullptr) {
+        if (!mapped) {
+            ::free(addr);
+        } else if (::munmap(addr, length) == -1) {
+            KUN_LOG_ERR(errno);
+        }
+    }
+    addr = nullptr;
+    length = 0;
+}
+
 }
 
 #endif
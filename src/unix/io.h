@@ -5,8 +5,10 @@
 
 #ifdef KUN_PLATFORM_UNIX
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stddef.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "util/bstring.h"
@@ -14,32 +16,48 @@
 
 namespace KUN_SYS {
 
-template<int N, typename... TS>
-inline void fprint(const BString& fmt, TS&&... args) {
+template<int N>
+inline void writeStdio(
+    const char* head,
+    size_t headLength,
+    const char* tail = nullptr,
+    size_t tailLength = 0
+) {
     static_assert(N == 1 || N == 2);
-    BString str;
-    if constexpr (sizeof...(args) == 0) {
-        str = BString::view(fmt);
-    } else {
-        str = BString::format(fmt, std::forward<TS>(args)...);
-    }
     constexpr int fd = N == 1 ? STDOUT_FILENO : STDERR_FILENO;
-    const char* p = str.data();
-    auto end = p + str.length();
-    while (true) {
-        size_t len = end - p;
-        auto rc = ::write(fd, p, len);
-        if (rc > 0 && static_cast<size_t>(rc) < len) {
-            p += rc;
-            continue;
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<char*>(head);
+    iov[0].iov_len = headLength;
+    iov[1].iov_base = const_cast<char*>(tail);
+    iov[1].iov_len = tailLength;
+    int index = headLength > 0 ? 0 : 1;
+    while (index < 2 && iov[index].iov_len > 0) {
+        auto rc = ::writev(fd, iov + index, 2 - index);
+        if (rc == -1) {
+            if (errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        auto n = static_cast<size_t>(rc);
+        while (index < 2 && n >= iov[index].iov_len) {
+            n -= iov[index].iov_len;
+            ++index;
         }
-        if (rc == -1 && (errno == EAGAIN || errno == EINTR)) {
-            continue;
+        if (index < 2) {
+            iov[index].iov_base = static_cast<char*>(iov[index].iov_base) + n;
+            iov[index].iov_len -= n;
         }
-        break;
     }
 }
 
+template<int N>
+inline bool isStdioTerminal() {
+    static_assert(N == 1 || N == 2);
+    constexpr int fd = N == 1 ? STDOUT_FILENO : STDERR_FILENO;
+    return ::isatty(fd) == 1;
+}
+
 inline Result<bool> setNonblocking(int fd) {
     int flags = ::fcntl(fd, F_GETFL);
     if (flags >= 0) {
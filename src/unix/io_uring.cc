@@ -0,0 +1,447 @@
+#include "unix/io_uring.h"
+
+#ifdef KUN_PLATFORM_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "v8.h"
+#include "loop/event_loop.h"
+#include "util/scope_guard.h"
+#include "util/sys_err.h"
+#include "util/utils.h"
+
+KUN_V8_USINGS;
+
+namespace {
+
+constexpr unsigned MAX_RW_LENGTH = 1U << 30;
+
+inline int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+inline int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(
+        __NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0
+    ));
+}
+
+inline int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned nrArgs) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+inline unsigned loadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void storeRelease(unsigned* p, unsigned value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+bool probeOps(int fd) {
+    constexpr unsigned PROBE_OPS = 256;
+    std::vector<char> buf(sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op), 0);
+    auto probe = reinterpret_cast<io_uring_probe*>(buf.data());
+    if (ioUringRegister(fd, IORING_REGISTER_PROBE, probe, PROBE_OPS) == -1) {
+        return false;
+    }
+    constexpr unsigned requiredOps[] = {
+        IORING_OP_OPENAT,
+        IORING_OP_STATX,
+        IORING_OP_READ,
+        IORING_OP_WRITE,
+        IORING_OP_CLOSE
+    };
+    for (auto op : requiredOps) {
+        if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+inline T* offsetOf(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+}
+
+namespace kun {
+
+class IoUring::Task {
+public:
+    Task(const Task&) = delete;
+
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&&) = delete;
+
+    Task& operator=(Task&&) = delete;
+
+    Task(IoUringOp op, AsyncRequest&& req) : op(op), req(std::move(req)) {}
+
+    ~Task() = default;
+
+    enum class Step {
+        OPEN,
+        STATX,
+        READ,
+        WRITE,
+        CLOSE
+    };
+
+    IoUringOp op;
+    AsyncRequest req;
+    Step step{Step::OPEN};
+    int fileFd{-1};
+    int errCode{0};
+    char* path{nullptr};
+    char* data{nullptr};
+    size_t size{0};
+    size_t offset{0};
+    struct statx stx;
+};
+
+IoUring::IoUring(Environment* env, EventLoop* eventLoop) :
+    Channel(KUN_INVALID_FD, ChannelType::READ),
+    env(env),
+    eventLoop(eventLoop)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    auto ringFd = ioUringSetup(ENTRIES, &params);
+    if (ringFd == -1) {
+        KUN_LOG_ERR(errno);
+        return;
+    }
+    if (!probeOps(ringFd)) {
+        ::close(ringFd);
+        return;
+    }
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        if (cqRingSize > sqRingSize) {
+            sqRingSize = cqRingSize;
+        }
+        cqRingSize = sqRingSize;
+    }
+    sqRing = ::mmap(
+        nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING
+    );
+    if (sqRing == MAP_FAILED) {
+        KUN_LOG_ERR(errno);
+        sqRing = nullptr;
+        ::close(ringFd);
+        return;
+    }
+    if (singleMmap) {
+        cqRing = sqRing;
+    } else {
+        cqRing = ::mmap(
+            nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING
+        );
+        if (cqRing == MAP_FAILED) {
+            KUN_LOG_ERR(errno);
+            cqRing = nullptr;
+            ::munmap(sqRing, sqRingSize);
+            sqRing = nullptr;
+            ::close(ringFd);
+            return;
+        }
+    }
+    auto sqesPtr = ::mmap(
+        nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES
+    );
+    if (sqesPtr == MAP_FAILED) {
+        KUN_LOG_ERR(errno);
+        if (cqRing != sqRing) {
+            ::munmap(cqRing, cqRingSize);
+        }
+        ::munmap(sqRing, sqRingSize);
+        sqRing = nullptr;
+        cqRing = nullptr;
+        ::close(ringFd);
+        return;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqesPtr);
+    sqHead = offsetOf<unsigned>(sqRing, params.sq_off.head);
+    sqTail = offsetOf<unsigned>(sqRing, params.sq_off.tail);
+    sqArray = offsetOf<unsigned>(sqRing, params.sq_off.array);
+    sqMask = *offsetOf<unsigned>(sqRing, params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    cqHead = offsetOf<unsigned>(cqRing, params.cq_off.head);
+    cqTail = offsetOf<unsigned>(cqRing, params.cq_off.tail);
+    cqes = offsetOf<io_uring_cqe>(cqRing, params.cq_off.cqes);
+    cqMask = *offsetOf<unsigned>(cqRing, params.cq_off.ring_mask);
+    cqEntries = params.cq_entries;
+    localTail = *sqTail;
+    fd = ringFd;
+}
+
+IoUring::~IoUring() {
+    for (auto task : backlog) {
+        delete[] task->path;
+        delete[] task->data;
+        delete task;
+    }
+    if (sqes != nullptr) {
+        ::munmap(sqes, sqEntries * sizeof(io_uring_sqe));
+    }
+    if (cqRing != nullptr && cqRing != sqRing) {
+        ::munmap(cqRing, cqRingSize);
+    }
+    if (sqRing != nullptr) {
+        ::munmap(sqRing, sqRingSize);
+    }
+}
+
+void IoUring::submit(IoUringOp op, AsyncRequest&& req) {
+    auto task = new Task(op, std::move(req));
+    task->path = task->req.get<char*>(0);
+    if (op == IoUringOp::WRITE_FILE) {
+        task->data = task->req.get<char*>(1);
+        task->size = task->req.get<size_t>(2);
+    }
+    if (taskCount++ == 0) {
+        eventLoop->addChannel(this);
+    }
+    issue(task);
+}
+
+void IoUring::flush() {
+    while (unsubmitted > 0) {
+        auto rc = ioUringEnter(fd, unsubmitted, 0, 0);
+        if (rc >= 0) {
+            unsubmitted -= static_cast<unsigned>(rc);
+            if (rc == 0) {
+                break;
+            }
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EBUSY) {
+            KUN_LOG_ERR(errno);
+        }
+        break;
+    }
+}
+
+void IoUring::onReadable() {
+    while (true) {
+        auto head = *cqHead;
+        auto tail = loadAcquire(cqTail);
+        if (head == tail) {
+            break;
+        }
+        while (head != tail) {
+            const auto& cqe = cqes[head & cqMask];
+            auto task = reinterpret_cast<Task*>(static_cast<uintptr_t>(cqe.user_data));
+            auto res = cqe.res;
+            head++;
+            storeRelease(cqHead, head);
+            inflight--;
+            complete(task, res);
+        }
+        while (!backlog.empty() && inflight < cqEntries) {
+            auto task = backlog.front();
+            backlog.pop_front();
+            if (!issue(task)) {
+                break;
+            }
+        }
+    }
+}
+
+bool IoUring::issue(Task* task) {
+    if (inflight >= cqEntries) {
+        backlog.push_back(task);
+        return false;
+    }
+    if (localTail - loadAcquire(sqHead) >= sqEntries) {
+        flush();
+        if (localTail - loadAcquire(sqHead) >= sqEntries) {
+            backlog.push_back(task);
+            return false;
+        }
+    }
+    auto index = localTail & sqMask;
+    auto sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(task));
+    switch (task->step) {
+        case Task::Step::OPEN:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = reinterpret_cast<uintptr_t>(task->path);
+            if (task->op == IoUringOp::READ_FILE) {
+                sqe->open_flags = O_RDONLY | O_CLOEXEC;
+            } else {
+                sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+                sqe->len = 0644;
+            }
+            break;
+        case Task::Step::STATX:
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = task->fileFd;
+            sqe->addr = reinterpret_cast<uintptr_t>("");
+            sqe->len = STATX_TYPE | STATX_SIZE;
+            sqe->statx_flags = AT_EMPTY_PATH;
+            sqe->off = reinterpret_cast<uintptr_t>(&task->stx);
+            break;
+        case Task::Step::READ: {
+            auto remaining = task->size - task->offset;
+            auto len = remaining < MAX_RW_LENGTH ? static_cast<unsigned>(remaining) : MAX_RW_LENGTH;
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = task->fileFd;
+            sqe->addr = reinterpret_cast<uintptr_t>(task->data + task->offset);
+            sqe->len = len;
+            sqe->off = task->offset;
+            break;
+        }
+        case Task::Step::WRITE: {
+            auto remaining = task->size - task->offset;
+            auto len = remaining < MAX_RW_LENGTH ? static_cast<unsigned>(remaining) : MAX_RW_LENGTH;
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->fd = task->fileFd;
+            sqe->addr = reinterpret_cast<uintptr_t>(task->data + task->offset);
+            sqe->len = len;
+            sqe->off = task->offset;
+            break;
+        }
+        case Task::Step::CLOSE:
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = task->fileFd;
+            break;
+    }
+    sqArray[index] = index;
+    localTail++;
+    storeRelease(sqTail, localTail);
+    unsubmitted++;
+    inflight++;
+    return true;
+}
+
+void IoUring::complete(Task* task, int res) {
+    switch (task->step) {
+        case Task::Step::OPEN:
+            if (res < 0) {
+                task->errCode = -res;
+                finish(task);
+                return;
+            }
+            task->fileFd = res;
+            if (task->op == IoUringOp::READ_FILE) {
+                task->step = Task::Step::STATX;
+            } else {
+                task->step = task->size > 0 ? Task::Step::WRITE : Task::Step::CLOSE;
+            }
+            break;
+        case Task::Step::STATX:
+            if (res < 0) {
+                task->errCode = -res;
+                task->step = Task::Step::CLOSE;
+                break;
+            }
+            if (!S_ISREG(task->stx.stx_mode)) {
+                task->errCode = SysErr::NOT_REGULAR_FILE;
+                task->step = Task::Step::CLOSE;
+                break;
+            }
+            task->size = static_cast<size_t>(task->stx.stx_size);
+            task->data = new char[task->size + 1];
+            task->step = task->size > 0 ? Task::Step::READ : Task::Step::CLOSE;
+            break;
+        case Task::Step::READ:
+            if (res < 0) {
+                if (res != -EINTR && res != -EAGAIN) {
+                    task->errCode = -res;
+                    task->step = Task::Step::CLOSE;
+                }
+                break;
+            }
+            if (res == 0) {
+                task->size = task->offset;
+            } else {
+                task->offset += static_cast<size_t>(res);
+            }
+            if (task->offset >= task->size) {
+                task->step = Task::Step::CLOSE;
+            }
+            break;
+        case Task::Step::WRITE:
+            if (res < 0) {
+                if (res != -EINTR && res != -EAGAIN) {
+                    task->errCode = -res;
+                    task->step = Task::Step::CLOSE;
+                }
+                break;
+            }
+            task->offset += static_cast<size_t>(res);
+            if (task->offset >= task->size) {
+                task->step = Task::Step::CLOSE;
+            }
+            break;
+        case Task::Step::CLOSE:
+            if (res < 0) {
+                KUN_LOG_ERR(-res);
+            }
+            task->fileFd = -1;
+            finish(task);
+            return;
+    }
+    issue(task);
+}
+
+void IoUring::finish(Task* task) {
+    ON_SCOPE_EXIT {
+        delete task;
+        if (--taskCount == 0) {
+            eventLoop->removeChannel(this);
+        }
+    };
+    delete[] task->path;
+    auto& req = task->req;
+    if (task->op == IoUringOp::READ_FILE) {
+        if (task->errCode == 0) {
+            req.set(0, task->data);
+            req.set(1, task->size);
+        } else {
+            delete[] task->data;
+            req.set(0, nullptr);
+            req.set(1, task->errCode);
+        }
+    } else {
+        delete[] task->data;
+        if (task->errCode == 0) {
+            req.set(0, 0);
+        } else {
+            req.set(0, -1);
+            req.set(1, task->errCode);
+        }
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    req.resolve(context);
+    env->runMicrotask();
+}
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef KUN_UNIX_IO_URING_H
+#define KUN_UNIX_IO_URING_H
+
+#include "util/constants.h"
+
+#ifdef KUN_PLATFORM_LINUX
+
+#include <linux/io_uring.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+
+#include "env/environment.h"
+#include "loop/async_request.h"
+#include "loop/channel.h"
+
+namespace kun {
+
+class EventLoop;
+
+enum class IoUringOp {
+    READ_FILE,
+    WRITE_FILE
+};
+
+class IoUring : public Channel {
+public:
+    IoUring(const IoUring&) = delete;
+
+    IoUring& operator=(const IoUring&) = delete;
+
+    IoUring(IoUring&&) = delete;
+
+    IoUring& operator=(IoUring&&) = delete;
+
+    IoUring(Environment* env, EventLoop* eventLoop);
+
+    ~IoUring() override;
+
+    bool isValid() const {
+        return fd != KUN_INVALID_FD;
+    }
+
+    void submit(IoUringOp op, AsyncRequest&& req);
+
+    void flush();
+
+    void onReadable() override final;
+
+private:
+    class Task;
+
+    bool issue(Task* task);
+
+    void complete(Task* task, int res);
+
+    void finish(Task* task);
+
+    static constexpr unsigned ENTRIES = 256;
+
+    Environment* env;
+    EventLoop* eventLoop;
+    void* sqRing{nullptr};
+    void* cqRing{nullptr};
+    size_t sqRingSize{0};
+    size_t cqRingSize{0};
+    io_uring_sqe* sqes{nullptr};
+    io_uring_cqe* cqes{nullptr};
+    unsigned* sqHead{nullptr};
+    unsigned* sqTail{nullptr};
+    unsigned* sqArray{nullptr};
+    unsigned* cqHead{nullptr};
+    unsigned* cqTail{nullptr};
+    unsigned sqMask{0};
+    unsigned cqMask{0};
+    unsigned sqEntries{0};
+    unsigned cqEntries{0};
+    unsigned localTail{0};
+    unsigned unsubmitted{0};
+    unsigned inflight{0};
+    size_t taskCount{0};
+    std::deque<Task*> backlog;
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+#include "unix/net.h"
+
+#ifdef KUN_PLATFORM_UNIX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sys/io.h"
+#include "util/scope_guard.h"
+#include "util/sys_err.h"
+
+namespace KUN_SYS {
+
+Result<int> createSocket(int family) {
+    auto fd = ::socket(family, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return SysErr(errno);
+    }
+    if (::fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+        auto errCode = errno;
+        ::close(fd);
+        return SysErr(errCode);
+    }
+    if (auto result = kun::sys::setNonblocking(fd); !result) {
+        ::close(fd);
+        return result.err();
+    }
+    return fd;
+}
+
+Result<int> listenTcp(const BString& hostname, int port) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    auto service = BString::format("{}", port);
+    struct addrinfo* ai = nullptr;
+    auto rc = ::getaddrinfo(hostname.c_str(), service.c_str(), &hints, &ai);
+    if (rc != 0) {
+        return SysErr(rc == EAI_SYSTEM ? errno : SysErr::INVALID_ARGUMENT);
+    }
+    ON_SCOPE_EXIT {
+        ::freeaddrinfo(ai);
+    };
+    auto result = createSocket(ai->ai_family);
+    if (!result) {
+        return result.err();
+    }
+    auto fd = result.unwrap();
+    int value = 1;
+    if (
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value)) == -1 ||
+        ::bind(fd, ai->ai_addr, ai->ai_addrlen) == -1 ||
+        ::listen(fd, SOMAXCONN) == -1
+    ) {
+        auto errCode = errno;
+        ::close(fd);
+        return SysErr(errCode);
+    }
+    return fd;
+}
+
+Result<int> acceptTcp(int fd) {
+    #ifdef KUN_PLATFORM_LINUX
+    auto connFd = ::accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (connFd == -1) {
+        return SysErr(errno);
+    }
+    #else
+    auto connFd = ::accept(fd, nullptr, nullptr);
+    if (connFd == -1) {
+        return SysErr(errno);
+    }
+    if (::fcntl(connFd, F_SETFD, FD_CLOEXEC) == -1) {
+        auto errCode = errno;
+        ::close(connFd);
+        return SysErr(errCode);
+    }
+    if (auto result = kun::sys::setNonblocking(connFd); !result) {
+        ::close(connFd);
+        return result.err();
+    }
+    #endif
+    setNoDelay(connFd);
+    return connFd;
+}
+
+Result<bool> setNoDelay(int fd) {
+    int value = 1;
+    if (::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) == -1) {
+        return SysErr(errno);
+    }
+    return true;
+}
+
+}
+
+#endif
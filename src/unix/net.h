@@ -0,0 +1,25 @@
+#ifndef KUN_UNIX_NET_H
+#define KUN_UNIX_NET_H
+
+#include "util/constants.h"
+
+#ifdef KUN_PLATFORM_UNIX
+
+#include "util/bstring.h"
+#include "util/result.h"
+
+namespace KUN_SYS {
+
+Result<int> createSocket(int family);
+
+Result<int> listenTcp(const BString& hostname, int port);
+
+Result<int> acceptTcp(int fd);
+
+Result<bool> setNoDelay(int fd);
+
+}
+
+#endif
+
+#endif
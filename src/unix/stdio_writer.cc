@@ -0,0 +1,180 @@
+#include "unix/stdio_writer.h"
+
+#ifdef KUN_PLATFORM_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "loop/event_loop.h"
+
+namespace kun {
+
+StdioWriter::StdioWriter(EventLoop* eventLoop, int fd, size_t maxBacklog, bool dropWhenFull) :
+    Channel(fd, ChannelType::WRITE),
+    eventLoop(eventLoop),
+    maxBacklog(maxBacklog),
+    dropWhenFull(dropWhenFull)
+{
+
+}
+
+StdioWriter::~StdioWriter() {
+    drain();
+    fd = KUN_INVALID_FD;
+}
+
+void StdioWriter::write(
+    const char* head,
+    size_t headLength,
+    const char* tail,
+    size_t tailLength
+) {
+    if (broken) {
+        return;
+    }
+    if (backlogBegin == backlogEnd) {
+        struct iovec iov[2];
+        iov[0].iov_base = const_cast<char*>(head);
+        iov[0].iov_len = headLength;
+        iov[1].iov_base = const_cast<char*>(tail);
+        iov[1].iov_len = tailLength;
+        ssize_t rc;
+        do {
+            rc = ::writev(fd, iov, 2);
+        } while (rc == -1 && errno == EINTR);
+        if (rc == -1) {
+            if (errno != EAGAIN) {
+                broken = true;
+                return;
+            }
+            rc = 0;
+        }
+        auto n = static_cast<size_t>(rc);
+        if (n >= headLength) {
+            n -= headLength;
+            headLength = 0;
+            tail += n;
+            tailLength -= n;
+        } else {
+            head += n;
+            headLength -= n;
+        }
+        if (headLength == 0 && tailLength == 0) {
+            return;
+        }
+    }
+    if (dropWhenFull && backlogEnd - backlogBegin + headLength + tailLength > maxBacklog) {
+        return;
+    }
+    append(head, headLength);
+    append(tail, tailLength);
+    if (backlogEnd - backlogBegin > maxBacklog) {
+        drain();
+    } else if (!registered) {
+        registered = eventLoop->addChannel(this);
+    }
+}
+
+void StdioWriter::onWritable() {
+    if (writeBacklog() || broken) {
+        if (registered && eventLoop->removeChannel(this)) {
+            registered = false;
+        }
+    }
+}
+
+void StdioWriter::onError() {
+    broken = true;
+    backlogBegin = backlogEnd = 0;
+    if (registered && eventLoop->removeChannel(this)) {
+        registered = false;
+    }
+}
+
+void StdioWriter::drain() {
+    while (!broken && backlogBegin != backlogEnd) {
+        if (!writeBacklog()) {
+            waitWritable();
+        }
+    }
+    if (registered && eventLoop->removeChannel(this)) {
+        registered = false;
+    }
+}
+
+bool StdioWriter::isNonblockingPipe(int fd) {
+    struct stat st;
+    if (::fstat(fd, &st) == -1 || !(S_ISFIFO(st.st_mode) || S_ISSOCK(st.st_mode))) {
+        return false;
+    }
+    int flags = ::fcntl(fd, F_GETFL);
+    return flags != -1 && (flags & O_NONBLOCK) != 0;
+}
+
+bool StdioWriter::writeBacklog() {
+    while (backlogBegin != backlogEnd) {
+        auto rc = ::write(fd, backlog.get() + backlogBegin, backlogEnd - backlogBegin);
+        if (rc == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN) {
+                broken = true;
+                backlogBegin = backlogEnd = 0;
+                return true;
+            }
+            return false;
+        }
+        backlogBegin += static_cast<size_t>(rc);
+    }
+    backlogBegin = backlogEnd = 0;
+    return true;
+}
+
+void StdioWriter::append(const char* s, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (backlogEnd + len > backlogCapacity) {
+        auto used = backlogEnd - backlogBegin;
+        if (used + len <= backlogCapacity) {
+            memmove(backlog.get(), backlog.get() + backlogBegin, used);
+        } else {
+            auto capacity = std::max<size_t>(backlogCapacity * 2, used + len);
+            capacity = std::max<size_t>(capacity, 64 * 1024);
+            auto p = new char[capacity];
+            if (used > 0) {
+                memcpy(p, backlog.get() + backlogBegin, used);
+            }
+            backlog.reset(p);
+            backlogCapacity = capacity;
+        }
+        backlogBegin = 0;
+        backlogEnd = used;
+    }
+    memcpy(backlog.get() + backlogEnd, s, len);
+    backlogEnd += len;
+}
+
+void StdioWriter::waitWritable() {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    while (::poll(&pfd, 1, -1) == -1 && errno == EINTR) {}
+    if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+        broken = true;
+        backlogBegin = backlogEnd = 0;
+    }
+}
+
+}
+
+#endif
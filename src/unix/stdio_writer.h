@@ -0,0 +1,64 @@
+#ifndef KUN_UNIX_STDIO_WRITER_H
+#define KUN_UNIX_STDIO_WRITER_H
+
+#include "util/constants.h"
+
+#ifdef KUN_PLATFORM_LINUX
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "loop/channel.h"
+
+namespace kun {
+
+class EventLoop;
+
+class StdioWriter : public Channel {
+public:
+    StdioWriter(const StdioWriter&) = delete;
+
+    StdioWriter& operator=(const StdioWriter&) = delete;
+
+    StdioWriter(StdioWriter&&) = delete;
+
+    StdioWriter& operator=(StdioWriter&&) = delete;
+
+    StdioWriter(EventLoop* eventLoop, int fd, size_t maxBacklog, bool dropWhenFull);
+
+    ~StdioWriter() override;
+
+    void write(const char* head, size_t headLength, const char* tail, size_t tailLength);
+
+    void onWritable() override final;
+
+    void onError() override final;
+
+    void drain();
+
+    static bool isNonblockingPipe(int fd);
+
+private:
+    bool writeBacklog();
+
+    void append(const char* s, size_t len);
+
+    void waitWritable();
+
+    EventLoop* eventLoop;
+    std::unique_ptr<char[]> backlog;
+    size_t backlogCapacity{0};
+    size_t backlogBegin{0};
+    size_t backlogEnd{0};
+    const size_t maxBacklog;
+    const bool dropWhenFull;
+    bool registered{false};
+    bool broken{false};
+};
+
+}
+
+#endif
+
+#endif
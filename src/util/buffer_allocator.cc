@@ -0,0 +1,87 @@
+#include "util/buffer_allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/utils.h"
+
+namespace kun {
+
+BufferAllocator::~BufferAllocator() {
+    for (auto slab : slabs) {
+        free(slab);
+    }
+}
+
+void* BufferAllocator::Allocate(size_t length) {
+    if (length > MAX_BLOCK_SIZE) {
+        return calloc(length, 1);
+    }
+    auto data = AllocateUninitialized(length);
+    if (data != nullptr) {
+        memset(data, 0, length);
+    }
+    return data;
+}
+
+void* BufferAllocator::AllocateUninitialized(size_t length) {
+    if (length > MAX_BLOCK_SIZE) {
+        return malloc(length);
+    }
+    auto index = getPoolIndex(length);
+    auto& pool = pools[index];
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.freeList == nullptr) {
+        refill(pool, static_cast<size_t>(1) << (index + MIN_BLOCK_SHIFT));
+        if (pool.freeList == nullptr) {
+            return nullptr;
+        }
+    }
+    auto block = pool.freeList;
+    pool.freeList = block->next;
+    return block;
+}
+
+void BufferAllocator::Free(void* data, size_t length) {
+    if (data == nullptr) {
+        return;
+    }
+    if (length > MAX_BLOCK_SIZE) {
+        free(data);
+        return;
+    }
+    auto& pool = pools[getPoolIndex(length)];
+    auto block = static_cast<FreeBlock*>(data);
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    block->next = pool.freeList;
+    pool.freeList = block;
+}
+
+size_t BufferAllocator::getPoolIndex(size_t length) {
+    size_t index = 0;
+    size_t blockSize = static_cast<size_t>(1) << MIN_BLOCK_SHIFT;
+    while (blockSize < length) {
+        blockSize <<= 1;
+        index++;
+    }
+    return index;
+}
+
+void BufferAllocator::refill(Pool& pool, size_t blockSize) {
+    auto slab = static_cast<char*>(malloc(SLAB_SIZE));
+    if (slab == nullptr) {
+        KUN_LOG_ERR("'BufferAllocator' out of memory");
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(slabMutex);
+        slabs.push_back(slab);
+    }
+    for (size_t offset = SLAB_SIZE; offset >= blockSize; offset -= blockSize) {
+        auto block = reinterpret_cast<FreeBlock*>(slab + offset - blockSize);
+        block->next = pool.freeList;
+        pool.freeList = block;
+    }
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef KUN_UTIL_BUFFER_ALLOCATOR_H
+#define KUN_UTIL_BUFFER_ALLOCATOR_H
+
+#include <stddef.h>
+
+#include <mutex>
+#include <vector>
+
+#include "v8.h"
+
+namespace kun {
+
+class BufferAllocator : public v8::ArrayBuffer::Allocator {
+public:
+    BufferAllocator(const BufferAllocator&) = delete;
+
+    BufferAllocator& operator=(const BufferAllocator&) = delete;
+
+    BufferAllocator(BufferAllocator&&) = delete;
+
+    BufferAllocator& operator=(BufferAllocator&&) = delete;
+
+    BufferAllocator() = default;
+
+    ~BufferAllocator() override;
+
+    void* Allocate(size_t length) override;
+
+    void* AllocateUninitialized(size_t length) override;
+
+    void Free(void* data, size_t length) override;
+
+private:
+    static constexpr size_t MIN_BLOCK_SHIFT = 4;
+    static constexpr size_t MAX_BLOCK_SHIFT = 12;
+    static constexpr size_t MAX_BLOCK_SIZE = static_cast<size_t>(1) << MAX_BLOCK_SHIFT;
+    static constexpr size_t SLAB_SIZE = 64 * 1024;
+
+    class FreeBlock {
+    public:
+        FreeBlock* next;
+    };
+
+    class Pool {
+    public:
+        std::mutex mutex;
+        FreeBlock* freeList{nullptr};
+    };
+
+    static size_t getPoolIndex(size_t length);
+
+    void refill(Pool& pool, size_t blockSize);
+
+    Pool pools[MAX_BLOCK_SHIFT - MIN_BLOCK_SHIFT + 1];
+    std::mutex slabMutex;
+    std::vector<void*> slabs;
+};
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef KUN_UTIL_FILE_INFO_H
+#define KUN_UTIL_FILE_INFO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/bstring.h"
+
+namespace kun {
+
+enum class FileType {
+    UNKNOWN = 0,
+    FILE,
+    DIRECTORY,
+    SYMLINK
+};
+
+class FileStat {
+public:
+    FileType type{FileType::UNKNOWN};
+    uint64_t size{0};
+    uint32_t mode{0};
+    double atime{0};
+    double mtime{0};
+};
+
+class DirEntry {
+public:
+    DirEntry(BString&& name, FileType type) : name(std::move(name)), type(type) {}
+
+    BString name;
+    FileType type;
+};
+
+class MappedFile {
+public:
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& file) noexcept :
+        addr(file.addr),
+        length(file.length),
+        mapped(file.mapped)
+    {
+        file.addr = nullptr;
+        file.length = 0;
+        file.mapped = false;
+    }
+
+    MappedFile& operator=(MappedFile&& file) noexcept {
+        if (this != &file) {
+            reset();
+            addr = file.addr;
+            length = file.length;
+            mapped = file.mapped;
+            file.addr = nullptr;
+            file.length = 0;
+            file.mapped = false;
+        }
+        return *this;
+    }
+
+    MappedFile() = default;
+
+    MappedFile(void* addr, size_t length, bool mapped) :
+        addr(addr),
+        length(length),
+        mapped(mapped)
+    {
+
+    }
+
+    ~MappedFile() {
+        reset();
+    }
+
+    const char* data() const {
+        return static_cast<const char*>(addr);
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    bool isMapped() const {
+        return mapped;
+    }
+
+    BString view() const {
+        return length > 0 ? BString::view(data(), length) : BString();
+    }
+
+    void reset();
+
+private:
+    void* addr{nullptr};
+    size_t length{0};
+    bool mapped{false};
+};
+
+}
+
+#endif
@@ -0,0 +1,272 @@
+#include "util/http_parser.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace {
+
+using kun::BString;
+using kun::HttpHeader;
+using kun::HttpParseStatus;
+using kun::HttpRequestHead;
+
+constexpr size_t MAX_CHUNK_SIZE = static_cast<size_t>(1) << 40;
+
+bool isTokenChar(unsigned char c) {
+    if (c >= 'a' && c <= 'z') {
+        return true;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return true;
+    }
+    if (c >= '0' && c <= '9') {
+        return true;
+    }
+    return c != 0 && strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+}
+
+bool isToken(const char* p, const char* end) {
+    if (p == end) {
+        return false;
+    }
+    while (p < end) {
+        if (!isTokenChar(static_cast<unsigned char>(*p++))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int toHexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+const char* findLine(const char* p, const char* end, const char*& lineEnd) {
+    auto lf = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (lf == nullptr) {
+        return nullptr;
+    }
+    lineEnd = lf > p && lf[-1] == '\r' ? lf - 1 : lf;
+    return lf + 1;
+}
+
+BString trimView(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t')) {
+        end--;
+    }
+    return BString::view(p, end - p);
+}
+
+template<typename F>
+void forEachToken(const BString& value, F&& f) {
+    auto p = value.data();
+    auto end = p + value.length();
+    while (p < end) {
+        auto comma = static_cast<const char*>(memchr(p, ',', end - p));
+        auto tokenEnd = comma != nullptr ? comma : end;
+        f(trimView(p, tokenEnd));
+        p = comma != nullptr ? comma + 1 : end;
+    }
+}
+
+bool parseContentLength(const BString& value, size_t& contentLength) {
+    if (value.empty()) {
+        return false;
+    }
+    size_t n = 0;
+    auto p = value.data();
+    auto end = p + value.length();
+    while (p < end) {
+        auto c = *p++;
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        if (n > (SIZE_MAX - 9) / 10) {
+            return false;
+        }
+        n = n * 10 + static_cast<size_t>(c - '0');
+    }
+    contentLength = n;
+    return true;
+}
+
+bool applyHeader(HttpRequestHead& head, const HttpHeader& header) {
+    const auto& name = header.name;
+    const auto& value = header.value;
+    if (name.length() == 14 && name.equalFold("content-length")) {
+        size_t contentLength = 0;
+        if (!parseContentLength(value, contentLength)) {
+            return false;
+        }
+        if (head.hasContentLength && head.contentLength != contentLength) {
+            return false;
+        }
+        head.hasContentLength = true;
+        head.contentLength = contentLength;
+    } else if (name.length() == 17 && name.equalFold("transfer-encoding")) {
+        bool chunked = false;
+        forEachToken(value, [&chunked](const BString& token) {
+            chunked = token.equalFold("chunked");
+        });
+        if (!chunked) {
+            return false;
+        }
+        head.chunked = true;
+    } else if (name.length() == 10 && name.equalFold("connection")) {
+        forEachToken(value, [&head](const BString& token) {
+            if (token.equalFold("close")) {
+                head.keepAlive = false;
+            } else if (token.equalFold("keep-alive")) {
+                head.keepAlive = true;
+            }
+        });
+    }
+    return true;
+}
+
+}
+
+namespace kun {
+
+HttpParseStatus parseHttpRequestHead(const char* data, size_t len, HttpRequestHead& head) {
+    head.reset();
+    auto p = data;
+    auto end = data + len;
+    while (p < end && (*p == '\r' || *p == '\n')) {
+        p++;
+    }
+    const char* lineEnd = nullptr;
+    auto next = findLine(p, end, lineEnd);
+    if (next == nullptr) {
+        return HttpParseStatus::INCOMPLETE;
+    }
+    auto sp1 = static_cast<const char*>(memchr(p, ' ', lineEnd - p));
+    if (sp1 == nullptr || !isToken(p, sp1)) {
+        return HttpParseStatus::ERROR;
+    }
+    auto targetBegin = sp1 + 1;
+    auto sp2 = static_cast<const char*>(memchr(targetBegin, ' ', lineEnd - targetBegin));
+    if (sp2 == nullptr || sp2 == targetBegin) {
+        return HttpParseStatus::ERROR;
+    }
+    auto version = sp2 + 1;
+    if (
+        lineEnd - version != 8 ||
+        memcmp(version, "HTTP/1.", 7) != 0 ||
+        (version[7] != '0' && version[7] != '1')
+    ) {
+        return HttpParseStatus::ERROR;
+    }
+    head.method = BString::view(p, sp1 - p);
+    head.target = BString::view(targetBegin, sp2 - targetBegin);
+    head.versionMinor = version[7] - '0';
+    head.keepAlive = head.versionMinor == 1;
+    p = next;
+    while (true) {
+        next = findLine(p, end, lineEnd);
+        if (next == nullptr) {
+            return HttpParseStatus::INCOMPLETE;
+        }
+        if (lineEnd == p) {
+            p = next;
+            break;
+        }
+        if (*p == ' ' || *p == '\t') {
+            return HttpParseStatus::ERROR;
+        }
+        auto colon = static_cast<const char*>(memchr(p, ':', lineEnd - p));
+        if (colon == nullptr || !isToken(p, colon)) {
+            return HttpParseStatus::ERROR;
+        }
+        head.headers.push_back({BString::view(p, colon - p), trimView(colon + 1, lineEnd)});
+        if (!applyHeader(head, head.headers.back())) {
+            return HttpParseStatus::ERROR;
+        }
+        p = next;
+    }
+    if (head.chunked && head.hasContentLength) {
+        return HttpParseStatus::ERROR;
+    }
+    head.headLength = p - data;
+    return HttpParseStatus::COMPLETE;
+}
+
+HttpParseStatus parseHttpChunkedBody(
+    const char* data,
+    size_t len,
+    BString& body,
+    size_t& consumed
+) {
+    if (consumed > len) {
+        return HttpParseStatus::ERROR;
+    }
+    auto p = data + consumed;
+    auto end = data + len;
+    while (true) {
+        const char* lineEnd = nullptr;
+        auto next = findLine(p, end, lineEnd);
+        if (next == nullptr) {
+            return HttpParseStatus::INCOMPLETE;
+        }
+        size_t size = 0;
+        auto q = p;
+        while (q < lineEnd) {
+            auto digit = toHexDigit(*q);
+            if (digit == -1) {
+                break;
+            }
+            size = (size << 4) | static_cast<size_t>(digit);
+            if (size > MAX_CHUNK_SIZE) {
+                return HttpParseStatus::ERROR;
+            }
+            q++;
+        }
+        if (q == p || (q < lineEnd && *q != ';' && *q != ' ' && *q != '\t')) {
+            return HttpParseStatus::ERROR;
+        }
+        p = next;
+        if (size == 0) {
+            while (true) {
+                next = findLine(p, end, lineEnd);
+                if (next == nullptr) {
+                    return HttpParseStatus::INCOMPLETE;
+                }
+                if (lineEnd == p) {
+                    consumed = next - data;
+                    return HttpParseStatus::COMPLETE;
+                }
+                p = next;
+            }
+        }
+        if (static_cast<size_t>(end - p) < size + 1) {
+            return HttpParseStatus::INCOMPLETE;
+        }
+        auto chunkEnd = p + size;
+        if (*chunkEnd == '\r') {
+            chunkEnd++;
+            if (chunkEnd == end) {
+                return HttpParseStatus::INCOMPLETE;
+            }
+        }
+        if (*chunkEnd != '\n') {
+            return HttpParseStatus::ERROR;
+        }
+        body.append(p, size);
+        p = chunkEnd + 1;
+        consumed = p - data;
+    }
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef KUN_UTIL_HTTP_PARSER_H
+#define KUN_UTIL_HTTP_PARSER_H
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "util/bstring.h"
+
+namespace kun {
+
+enum class HttpParseStatus {
+    COMPLETE = 0,
+    INCOMPLETE,
+    ERROR
+};
+
+class HttpHeader {
+public:
+    BString name;
+    BString value;
+};
+
+class HttpRequestHead {
+public:
+    void reset() {
+        method = BString();
+        target = BString();
+        headers.clear();
+        versionMinor = 1;
+        contentLength = 0;
+        headLength = 0;
+        hasContentLength = false;
+        chunked = false;
+        keepAlive = true;
+    }
+
+    BString method;
+    BString target;
+    std::vector<HttpHeader> headers;
+    int versionMinor{1};
+    size_t contentLength{0};
+    size_t headLength{0};
+    bool hasContentLength{false};
+    bool chunked{false};
+    bool keepAlive{true};
+};
+
+HttpParseStatus parseHttpRequestHead(const char* data, size_t len, HttpRequestHead& head);
+
+HttpParseStatus parseHttpChunkedBody(
+    const char* data,
+    size_t len,
+    BString& body,
+    size_t& consumed
+);
+
+}
+
+#endif
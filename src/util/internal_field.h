@@ -6,13 +6,27 @@
 
 namespace kun {
 
+namespace api {
+
+class HttpServer;
+class TcpConn;
+class TcpListener;
+
+}
+
 namespace web {
 
 class AbortSignal;
 class Console;
 class Event;
 class EventTarget;
+class ReadableStream;
 class TextDecoder;
+class TextDecoderStream;
+class TextEncoderStream;
+class TransformStream;
+class Worker;
+class WritableStream;
 
 }
 
@@ -83,16 +97,33 @@ private:
         CONSOLE = 0,
         EVENT,
         EVENT_TARGET,
-        TEXT_DECODER
+        HTTP_SERVER,
+        READABLE_STREAM,
+        TCP_CONN,
+        TCP_LISTENER,
+        TEXT_DECODER,
+        TEXT_DECODER_STREAM,
+        TEXT_ENCODER_STREAM,
+        TRANSFORM_STREAM,
+        WRITABLE_STREAM
     };
 
     template<typename U>
     static constexpr auto getType = InternalField<U>::template from<
+        TypeValue<api::HttpServer, HTTP_SERVER>,
+        TypeValue<api::TcpConn, TCP_CONN>,
+        TypeValue<api::TcpListener, TCP_LISTENER>,
         TypeValue<web::AbortSignal, EVENT_TARGET>,
         TypeValue<web::Console, CONSOLE>,
         TypeValue<web::Event, EVENT>,
         TypeValue<web::EventTarget, EVENT_TARGET>,
-        TypeValue<web::TextDecoder, TEXT_DECODER>
+        TypeValue<web::ReadableStream, READABLE_STREAM>,
+        TypeValue<web::TextDecoder, TEXT_DECODER>,
+        TypeValue<web::TextDecoderStream, TEXT_DECODER_STREAM>,
+        TypeValue<web::TextEncoderStream, TEXT_ENCODER_STREAM>,
+        TypeValue<web::TransformStream, TRANSFORM_STREAM>,
+        TypeValue<web::Worker, EVENT_TARGET>,
+        TypeValue<web::WritableStream, WRITABLE_STREAM>
     >;
 };
 
@@ -126,6 +126,19 @@ public:
 
 namespace util {
 
+inline void submitAsyncRequest(const v8::FunctionCallbackInfo<v8::Value>& info, AsyncRequest&& req) {
+    auto isolate = info.GetIsolate();
+    v8::HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+    auto promise = resolver->GetPromise();
+    req.setResolver(isolate, resolver);
+    auto env = Environment::from(context);
+    auto eventLoop = env->getEventLoop();
+    eventLoop->submitAsyncRequest(std::move(req));
+    info.GetReturnValue().Set(promise);
+}
+
 template<uint32_t... NS>
 bool checkFuncArgs(const v8::FunctionCallbackInfo<v8::Value>& info) {
     auto isolate = info.GetIsolate();
@@ -387,14 +400,7 @@ void callAsyncFunc(const v8::FunctionCallbackInfo<v8::Value>& info, AsyncRequest
             return;
         }
     }(std::integral_constant<uint32_t, NS>{}), ...);
-    auto context = isolate->GetCurrentContext();
-    auto resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
-    auto promise = resolver->GetPromise();
-    req.setResolver(isolate, resolver);
-    auto env = Environment::from(context);
-    auto eventLoop = env->getEventLoop();
-    eventLoop->submitAsyncRequest(std::move(req));
-    info.GetReturnValue().Set(promise);
+    submitAsyncRequest(info, std::move(req));
 }
 
 }
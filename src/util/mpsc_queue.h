@@ -0,0 +1,123 @@
+#ifndef KUN_UTIL_MPSC_QUEUE_H
+#define KUN_UTIL_MPSC_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace kun {
+
+template<typename T, size_t N>
+class MpscQueue {
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0);
+
+    MpscQueue(const MpscQueue&) = delete;
+
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    MpscQueue(MpscQueue&&) = delete;
+
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    MpscQueue() : cells(new Cell[N]) {
+        for (size_t i = 0; i < N; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue() {
+        while (front() != nullptr) {
+            pop();
+        }
+        delete[] cells;
+    }
+
+    bool tryPush(T&& t) {
+        Cell* cell;
+        auto pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & MASK];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(std::move(t));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T&& t) {
+        if (!tryPush(std::move(t))) {
+            std::lock_guard<std::mutex> lockGuard(overflowMutex);
+            overflowItems.emplace_back(std::move(t));
+            overflowed.store(true);
+        }
+    }
+
+    T* front() {
+        if (!drainedItems.empty()) {
+            return &drainedItems.front();
+        }
+        auto& cell = cells[head & MASK];
+        auto seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq == head + 1) {
+            return std::launder(reinterpret_cast<T*>(cell.storage));
+        }
+        if (overflowed.load()) {
+            std::lock_guard<std::mutex> lockGuard(overflowMutex);
+            drainedItems.swap(overflowItems);
+            overflowed.store(false);
+        }
+        return drainedItems.empty() ? nullptr : &drainedItems.front();
+    }
+
+    void pop() {
+        if (!drainedItems.empty()) {
+            drainedItems.pop_front();
+            return;
+        }
+        auto& cell = cells[head & MASK];
+        std::launder(reinterpret_cast<T*>(cell.storage))->~T();
+        cell.sequence.store(head + N, std::memory_order_release);
+        head++;
+    }
+
+    bool empty() {
+        return front() == nullptr;
+    }
+
+private:
+    static constexpr size_t MASK = N - 1;
+
+    class Cell {
+    public:
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    Cell* const cells;
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) size_t head{0};
+    std::deque<T> drainedItems;
+    std::deque<T> overflowItems;
+    std::mutex overflowMutex;
+    std::atomic<bool> overflowed{false};
+};
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "util/output_buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+
+#include "sys/io.h"
+#include "util/constants.h"
+
+#ifdef KUN_PLATFORM_LINUX
+#include "unix/stdio_writer.h"
+#endif
+
+namespace {
+
+std::once_flag atexitFlag;
+
+void flushAtExit() {
+    if (auto outputBuffer = kun::OutputBuffer::current()) {
+        outputBuffer->flush();
+    }
+}
+
+}
+
+namespace kun {
+
+thread_local OutputBuffer* OutputBuffer::currentBuffer = nullptr;
+
+OutputBuffer::OutputBuffer() : data(new char[CAPACITY]) {
+    terminals[0] = KUN_SYS::isStdioTerminal<1>();
+    terminals[1] = KUN_SYS::isStdioTerminal<2>();
+    std::call_once(atexitFlag, []() {
+        ::atexit(flushAtExit);
+    });
+}
+
+OutputBuffer::~OutputBuffer() {
+    flush();
+    if (currentBuffer == this) {
+        currentBuffer = nullptr;
+    }
+}
+
+void OutputBuffer::write(int stream, const char* s, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (this->stream != stream) {
+        flush();
+        this->stream = stream;
+    }
+    if (length + len > CAPACITY) {
+        writeThrough(s, len);
+        return;
+    }
+    memcpy(data.get() + length, s, len);
+    length += len;
+    if (terminals[stream - 1] && memchr(s, '\n', len) != nullptr) {
+        flush();
+    }
+}
+
+void OutputBuffer::flush() {
+    if (length > 0) {
+        writeThrough(nullptr, 0);
+    }
+}
+
+void OutputBuffer::setCurrent(OutputBuffer* outputBuffer) {
+    currentBuffer = outputBuffer;
+}
+
+void OutputBuffer::writeThrough(const char* s, size_t len) {
+    #ifdef KUN_PLATFORM_LINUX
+    if (auto stdioWriter = stdioWriters[stream - 1]) {
+        stdioWriter->write(data.get(), length, s, len);
+        length = 0;
+        return;
+    }
+    #endif
+    if (stream == 1) {
+        KUN_SYS::writeStdio<1>(data.get(), length, s, len);
+    } else {
+        KUN_SYS::writeStdio<2>(data.get(), length, s, len);
+    }
+    length = 0;
+}
+
+}
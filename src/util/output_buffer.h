@@ -0,0 +1,56 @@
+#ifndef KUN_UTIL_OUTPUT_BUFFER_H
+#define KUN_UTIL_OUTPUT_BUFFER_H
+
+#include <stddef.h>
+
+#include <memory>
+
+namespace kun {
+
+class StdioWriter;
+
+class OutputBuffer {
+public:
+    OutputBuffer(const OutputBuffer&) = delete;
+
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    OutputBuffer(OutputBuffer&&) = delete;
+
+    OutputBuffer& operator=(OutputBuffer&&) = delete;
+
+    OutputBuffer();
+
+    ~OutputBuffer();
+
+    void write(int stream, const char* s, size_t len);
+
+    void flush();
+
+    void setStdioWriter(int stream, StdioWriter* stdioWriter) {
+        stdioWriters[stream - 1] = stdioWriter;
+    }
+
+    static OutputBuffer* current() {
+        return currentBuffer;
+    }
+
+    static void setCurrent(OutputBuffer* outputBuffer);
+
+    static constexpr size_t CAPACITY = 64 * 1024;
+
+private:
+    void writeThrough(const char* s, size_t len);
+
+    std::unique_ptr<char[]> data;
+    size_t length{0};
+    int stream{0};
+    StdioWriter* stdioWriters[2]{nullptr, nullptr};
+    bool terminals[2];
+
+    static thread_local OutputBuffer* currentBuffer;
+};
+
+}
+
+#endif
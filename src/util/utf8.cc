@@ -0,0 +1,136 @@
+#include "util/utf8.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define KUN_UTF8_X86
+#endif
+
+namespace {
+
+using FindNonAsciiFunc = size_t (*)(const char* s, size_t len);
+
+size_t findNonAsciiScalar(const char* s, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, s + i, 8);
+        if ((word & 0x8080808080808080ULL) != 0) {
+            break;
+        }
+    }
+    while (i < len && static_cast<unsigned char>(s[i]) < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+#ifdef KUN_UTF8_X86
+size_t findNonAsciiSse2(const char* s, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        auto mask = _mm_movemask_epi8(chunk);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i + findNonAsciiScalar(s + i, len - i);
+}
+
+__attribute__((target("avx2")))
+size_t findNonAsciiAvx2(const char* s, size_t len) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        auto mask = _mm256_movemask_epi8(chunk);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i + findNonAsciiSse2(s + i, len - i);
+}
+#endif
+
+FindNonAsciiFunc selectFindNonAscii() {
+    #ifdef KUN_UTF8_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return findNonAsciiAvx2;
+    }
+    return findNonAsciiSse2;
+    #else
+    return findNonAsciiScalar;
+    #endif
+}
+
+const FindNonAsciiFunc findNonAsciiImpl = selectFindNonAscii();
+
+bool isContinuation(unsigned char c) {
+    return (c & 0xc0) == 0x80;
+}
+
+size_t getSequenceLength(const unsigned char* p, size_t len) {
+    auto c = p[0];
+    if (c >= 0xc2 && c <= 0xdf) {
+        return len >= 2 && isContinuation(p[1]) ? 2 : 0;
+    }
+    if (c >= 0xe0 && c <= 0xef) {
+        if (len < 3) {
+            return 0;
+        }
+        auto lower = c == 0xe0 ? 0xa0 : 0x80;
+        auto upper = c == 0xed ? 0x9f : 0xbf;
+        if (p[1] < lower || p[1] > upper || !isContinuation(p[2])) {
+            return 0;
+        }
+        return 3;
+    }
+    if (c >= 0xf0 && c <= 0xf4) {
+        if (len < 4) {
+            return 0;
+        }
+        auto lower = c == 0xf0 ? 0x90 : 0x80;
+        auto upper = c == 0xf4 ? 0x8f : 0xbf;
+        if (
+            p[1] < lower ||
+            p[1] > upper ||
+            !isContinuation(p[2]) ||
+            !isContinuation(p[3])
+        ) {
+            return 0;
+        }
+        return 4;
+    }
+    return 0;
+}
+
+}
+
+namespace kun {
+
+size_t findNonAscii(const char* s, size_t len) {
+    return findNonAsciiImpl(s, len);
+}
+
+size_t validateUtf8(const char* s, size_t len, bool& isAscii) {
+    auto p = reinterpret_cast<const unsigned char*>(s);
+    size_t i = findNonAsciiImpl(s, len);
+    isAscii = i == len;
+    while (i < len) {
+        if (p[i] < 0x80) {
+            i += findNonAsciiImpl(s + i, len - i);
+            continue;
+        }
+        auto n = getSequenceLength(p + i, len - i);
+        if (n == 0) {
+            break;
+        }
+        i += n;
+    }
+    return i;
+}
+
+}
@@ -0,0 +1,14 @@
+#ifndef KUN_UTIL_UTF8_H
+#define KUN_UTIL_UTF8_H
+
+#include <stddef.h>
+
+namespace kun {
+
+size_t findNonAscii(const char* s, size_t len);
+
+size_t validateUtf8(const char* s, size_t len, bool& isAscii);
+
+}
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef KUN_UTIL_UTILS_H
 #define KUN_UTIL_UTILS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "sys/io.h"
 #include "util/bstring.h"
 
@@ -13,6 +16,20 @@
 
 namespace kun::util {
 
+inline uint64_t hashBytes(const char* data, size_t len, uint64_t h = 0xcbf29ce484222325) {
+    auto p = reinterpret_cast<const uint8_t*>(data);
+    auto end = p + len;
+    while (p < end) {
+        h ^= *p++;
+        h *= 0x100000001b3;
+    }
+    return h;
+}
+
+inline uint64_t hashBytes(const BString& str, uint64_t h = 0xcbf29ce484222325) {
+    return hashBytes(str.data(), str.length(), h);
+}
+
 template<typename T, typename... TS>
 inline void logErr(T&& t, TS&&... args) {
     if constexpr (std::is_same_v<std::decay_t<T>, int>) {
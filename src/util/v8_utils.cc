@@ -26,13 +26,13 @@ bool findClassNameAndRecv(
     size_t prev = 0;
     auto index = name.find(".");
     while (index != BString::END) {
-        prev = index + 1;
         auto key = name.substring(prev, index);
         Local<Object> out;
         if (!fromObject(context, obj, key, out)) {
             return false;
         }
         obj = out;
+        prev = index + 1;
         index = name.find(".", prev);
     }
     className = name.substring(prev);
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <initializer_list>
 #include <vector>
 
 #include "v8.h"
@@ -125,6 +126,15 @@ inline void setFunction(
     ).Check();
 }
 
+inline void addReferences(
+    std::vector<intptr_t>& references,
+    std::initializer_list<v8::FunctionCallback> callbacks
+) {
+    for (auto callback : callbacks) {
+        references.push_back(reinterpret_cast<intptr_t>(callback));
+    }
+}
+
 inline void throwError(v8::Isolate* isolate, const BString& str) {
     isolate->ThrowException(v8::Exception::Error(toV8String(isolate, str)));
 }
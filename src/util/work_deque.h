@@ -0,0 +1,105 @@
+#ifndef KUN_UTIL_WORK_DEQUE_H
+#define KUN_UTIL_WORK_DEQUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace kun {
+
+template<typename T, size_t N>
+class WorkDeque {
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0);
+
+    WorkDeque(const WorkDeque&) = delete;
+
+    WorkDeque& operator=(const WorkDeque&) = delete;
+
+    WorkDeque(WorkDeque&&) = delete;
+
+    WorkDeque& operator=(WorkDeque&&) = delete;
+
+    WorkDeque() = default;
+
+    ~WorkDeque() = default;
+
+    size_t capacity() const {
+        return N;
+    }
+
+    size_t size() const {
+        auto b = bottom.load(std::memory_order_relaxed);
+        auto t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    bool push(T* t) {
+        auto b = bottom.load(std::memory_order_relaxed);
+        auto tp = top.load(std::memory_order_acquire);
+        if (b - tp >= static_cast<int64_t>(N)) {
+            return false;
+        }
+        buffer[b & MASK].store(t, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    T* pop() {
+        auto b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        auto p = buffer[b & MASK].load(std::memory_order_relaxed);
+        if (t == b) {
+            if (!top.compare_exchange_strong(
+                t, t + 1,
+                std::memory_order_seq_cst,
+                std::memory_order_relaxed
+            )) {
+                p = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return p;
+    }
+
+    T* steal() {
+        auto t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        auto p = buffer[t & MASK].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(
+            t, t + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed
+        )) {
+            return nullptr;
+        }
+        return p;
+    }
+
+private:
+    static constexpr int64_t MASK = static_cast<int64_t>(N) - 1;
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<T*> buffer[N]{};
+};
+
+}
+
+#endif
@@ -10,6 +10,7 @@ KUN_V8_USINGS;
 using kun::Environment;
 using kun::InternalField;
 using kun::web::AbortSignal;
+using kun::util::addReferences;
 using kun::util::createObject;
 using kun::util::defineAccessor;
 using kun::util::fromInternal;
@@ -89,4 +90,12 @@ void exposeAbortController(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
 }
 
+void registerAbortControllerReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newAbortController,
+        abort,
+        getSignal
+    });
+}
+
 }
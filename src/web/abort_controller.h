@@ -1,6 +1,10 @@
 #ifndef KUN_WEB_ABORT_CONTROLLER_H
 #define KUN_WEB_ABORT_CONTROLLER_H
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "v8.h"
 #include "util/constants.h"
 
@@ -8,6 +12,8 @@ namespace kun::web {
 
 void exposeAbortController(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerAbortControllerReferences(std::vector<intptr_t>& references);
+
 }
 
 #endif
@@ -1,17 +1,23 @@
 #include "web/abort_signal.h"
 
+#include <algorithm>
+
+#include "loop/event_loop.h"
+#include "sys/time.h"
 #include "util/js_utils.h"
+#include "util/scope_guard.h"
 #include "util/utils.h"
 #include "util/v8_utils.h"
 
 KUN_V8_USINGS;
 
-using v8::External;
 using kun::Environment;
 using kun::InternalField;
 using kun::JS;
 using kun::web::AbortSignal;
 using kun::web::Event;
+using kun::sys::millisecond;
+using kun::util::addReferences;
 using kun::util::checkFuncArgs;
 using kun::util::createObject;
 using kun::util::defineAccessor;
@@ -27,14 +33,38 @@ using kun::util::toV8String;
 
 namespace {
 
-void appendIfAbsent(std::list<Global<Object>>& list, Isolate* isolate, Local<Object> obj) {
-    auto target = Global<Object>(isolate, obj);
-    for (const auto& g : list) {
-        if (g == target) {
-            return;
+bool appendIfAbsent(std::vector<Global<Object>>& signals, Isolate* isolate, Local<Object> obj) {
+    for (const auto& g : signals) {
+        if (g == obj) {
+            return false;
         }
     }
-    list.emplace_back(std::move(target));
+    signals.emplace_back(isolate, obj);
+    return true;
+}
+
+void appendDependent(AbortSignal* abortSignal, Isolate* isolate, Local<Object> obj) {
+    auto& dependentSignals = abortSignal->dependentSignals;
+    if (dependentSignals.size() >= abortSignal->dependentSignalsLimit) {
+        auto iter = std::remove_if(
+            dependentSignals.begin(),
+            dependentSignals.end(),
+            [](const Global<Object>& g) { return g.IsEmpty(); }
+        );
+        dependentSignals.erase(iter, dependentSignals.end());
+        abortSignal->dependentSignalsLimit = std::max<size_t>(8, dependentSignals.size() * 2);
+    }
+    dependentSignals.emplace_back(isolate, obj);
+    dependentSignals.back().SetWeak();
+}
+
+void appendSource(AbortSignal* abortSignal, Isolate* isolate, Local<Object> obj) {
+    auto& sourceSignals = abortSignal->sourceSignals;
+    if (appendIfAbsent(sourceSignals, isolate, obj)) {
+        sourceSignals.back().SetWeak();
+        auto sourceAbortSignal = InternalField<AbortSignal>::get(obj, 0);
+        appendDependent(sourceAbortSignal, isolate, abortSignal->weakObject.get());
+    }
 }
 
 void runAbortSteps(AbortSignal* abortSignal) {
@@ -56,21 +86,7 @@ void runAbortSteps(AbortSignal* abortSignal) {
     auto event = InternalField<Event>::get(eventObj, 0);
     event->isTrusted = true;
     abortSignal->dispatchEvent(event);
-}
-
-void timeoutCallback(const FunctionCallbackInfo<Value>& info) {
-    auto isolate = info.GetIsolate();
-    HandleScope handleScope(isolate);
-    auto context = isolate->GetCurrentContext();
-    auto external = info.Data().As<External>();
-    auto abortSignal = static_cast<AbortSignal*>(external->Value());
-    auto e = newInstance(
-        context,
-        "DOMException",
-        "signal timed out",
-        "TimeoutError"
-    ).ToLocalChecked();
-    abortSignal->signalAbort(e);
+    abortSignal->unpin();
 }
 
 void newAbortSignal(const FunctionCallbackInfo<Value>& info) {
@@ -217,13 +233,7 @@ void getOnabort(const FunctionCallbackInfo<Value>& info) {
     if (abortSignal == nullptr) {
         return;
     }
-    auto onabortListener = abortSignal->onabortListener;
-    if (onabortListener != nullptr && !onabortListener->removed) {
-        auto onabort = onabortListener->callback.Get(isolate);
-        info.GetReturnValue().Set(onabort);
-    } else {
-        info.GetReturnValue().SetNull();
-    }
+    info.GetReturnValue().Set(abortSignal->getEventHandler("abort"));
 }
 
 void setOnabort(const FunctionCallbackInfo<Value>& info) {
@@ -254,21 +264,71 @@ void AbortSignal::throwIfAborted() {
 }
 
 void AbortSignal::onabort(Local<Value> value) {
+    setEventHandler("abort", value);
+    if (!value.IsEmpty() && value->IsFunction()) {
+        pin();
+    }
+}
+
+bool AbortSignal::addEventListener(const BString& type, EventListener&& listener) {
+    if (!EventTarget::addEventListener(type, std::move(listener))) {
+        return false;
+    }
+    if (type == "abort") {
+        pin();
+    }
+    return true;
+}
+
+void AbortSignal::pin() {
+    if (pinned || isAborted()) {
+        return;
+    }
+    if (dependent) {
+        pinned = true;
+        retainBySources(true);
+    } else if (timeoutPending) {
+        pinned = true;
+        weakObject.ref();
+    }
+}
+
+void AbortSignal::unpin() {
+    if (!pinned) {
+        return;
+    }
+    pinned = false;
+    if (dependent) {
+        retainBySources(false);
+        sourceSignals.clear();
+    } else {
+        weakObject.unref();
+    }
+}
+
+void AbortSignal::retainBySources(bool retained) {
     auto isolate = env->getIsolate();
     HandleScope handleScope(isolate);
-    if (!value.IsEmpty() && value->IsFunction()) {
-        auto func = value.As<Function>();
-        if (onabortListener == nullptr) {
-            EventListener listener;
-            listener.callback.Reset(isolate, func);
-            onabortListener = addEventListener("abort", std::move(listener));
-        } else {
-            onabortListener->callback.Reset(isolate, func);
+    auto obj = weakObject.get();
+    for (const auto& g : sourceSignals) {
+        if (g.IsEmpty()) {
+            continue;
         }
-    } else {
-        if (onabortListener != nullptr) {
-            onabortListener->removed = true;
-            onabortListener->callback.Reset();
+        auto sourceAbortSignal = InternalField<AbortSignal>::get(g.Get(isolate), 0);
+        if (sourceAbortSignal == nullptr) {
+            continue;
+        }
+        for (auto& dependentSignal : sourceAbortSignal->dependentSignals) {
+            if (dependentSignal != obj) {
+                continue;
+            }
+            if (retained) {
+                dependentSignal.ClearWeak();
+                sourceAbortSignal->pin();
+            } else {
+                dependentSignal.SetWeak();
+            }
+            break;
         }
     }
 }
@@ -280,6 +340,7 @@ void AbortSignal::addAlgorithm(Local<Function> func) {
         return;
     }
     abortAlgorithms.emplace_back(isolate, func);
+    pin();
 }
 
 void AbortSignal::signalAbort(Local<Value> value) {
@@ -300,6 +361,9 @@ void AbortSignal::signalAbort(Local<Value> value) {
     abortReason.Reset(isolate, value);
     std::list<AbortSignal*> dependentSignalsToAbort;
     for (const auto& g : dependentSignals) {
+        if (g.IsEmpty()) {
+            continue;
+        }
         auto signal = g.Get(isolate);
         auto abortSignal = InternalField<AbortSignal>::get(signal, 0);
         if (!abortSignal->isAborted()) {
@@ -345,27 +409,22 @@ Local<Object> AbortSignal::timeout(Environment* env, int64_t milliseconds) {
         throwTypeError(isolate, "requires a non-negative number");
         return handleScope.Escape(signal);
     }
-    auto globalThis = context->Global();
-    Local<Function> setTimeout;
-    if (!fromObject(context, globalThis, "setTimeout", setTimeout)) {
-        KUN_LOG_ERR("globalThis.setTimeout is not defined");
-        return handleScope.Escape(signal);
-    }
-    auto recv = v8::Undefined(isolate);
-    auto data = External::New(isolate, abortSignal);
-    auto callback = Function::New(
-        context,
-        timeoutCallback,
-        data
-    ).ToLocalChecked();
-    Local<Value> argv[] = {
-        callback,
-        Number::New(isolate, static_cast<double>(milliseconds))
-    };
-    Local<Value> result;
-    if (!setTimeout->Call(context, recv, 2, argv).ToLocal(&result)) {
-        KUN_LOG_ERR("Failed to invoke 'setTimeout'");
+    auto ms = static_cast<uint64_t>(milliseconds);
+    auto deadline = millisecond().unwrap() + ms;
+    auto abortTimeout = env->findAbortTimeout(deadline);
+    if (abortTimeout == nullptr) {
+        abortTimeout = new AbortTimeout(env, ms, deadline);
+        auto eventLoop = env->getEventLoop();
+        if (!eventLoop->addChannel(abortTimeout)) {
+            delete abortTimeout;
+            KUN_LOG_ERR("Failed to add AbortTimeout");
+            return handleScope.Escape(signal);
+        }
+        env->addAbortTimeout(deadline, abortTimeout);
     }
+    abortTimeout->signals.emplace_back(isolate, signal);
+    abortTimeout->signals.back().SetWeak();
+    abortSignal->timeoutPending = true;
     return handleScope.Escape(signal);
 }
 
@@ -394,25 +453,56 @@ Local<Object> AbortSignal::any(Environment* env, const std::vector<Local<Object>
     for (const auto& signal : signals) {
         auto abortSignal = InternalField<AbortSignal>::get(signal, 0);
         if (!abortSignal->dependent) {
-            appendIfAbsent(resultAbortSignal->sourceSignals, isolate, signal);
-            appendIfAbsent(abortSignal->dependentSignals, isolate, resultSignal);
+            appendSource(resultAbortSignal, isolate, signal);
         } else {
             const auto& sourceSignals = abortSignal->sourceSignals;
             for (const auto& g : sourceSignals) {
+                if (g.IsEmpty()) {
+                    continue;
+                }
                 auto sourceSignal = g.Get(isolate);
                 auto sourceAbortSignal = InternalField<AbortSignal>::get(sourceSignal, 0);
                 if (sourceAbortSignal->isAborted() || sourceAbortSignal->dependent) {
                     throwTypeError(isolate, "source signal is aborted or dependent");
                     break;
                 }
-                appendIfAbsent(resultAbortSignal->sourceSignals, isolate, sourceSignal);
-                appendIfAbsent(sourceAbortSignal->dependentSignals, isolate, resultSignal);
+                appendSource(resultAbortSignal, isolate, sourceSignal);
             }
         }
     }
     return handleScope.Escape(resultSignal);
 }
 
+void AbortTimeout::onReadable() {
+    auto env = this->env;
+    env->removeAbortTimeout(deadline);
+    ON_SCOPE_EXIT {
+        delete this;
+    };
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    for (const auto& g : signals) {
+        if (g.IsEmpty()) {
+            continue;
+        }
+        auto signal = g.Get(isolate);
+        auto abortSignal = InternalField<AbortSignal>::get(signal, 0);
+        if (abortSignal == nullptr) {
+            continue;
+        }
+        abortSignal->timeoutPending = false;
+        auto e = newInstance(
+            context,
+            "DOMException",
+            "signal timed out",
+            "TimeoutError"
+        ).ToLocalChecked();
+        abortSignal->signalAbort(e);
+    }
+    env->runMicrotask();
+}
+
 void exposeAbortSignal(Local<Context> context, ExposedScope exposedScope) {
     auto isolate = context->GetIsolate();
     HandleScope handleScope(isolate);
@@ -450,4 +540,18 @@ void exposeAbortSignal(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
 }
 
+void registerAbortSignalReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newAbortSignal,
+        throwIfAborted,
+        getAborted,
+        getReason,
+        getOnabort,
+        setOnabort,
+        abort,
+        timeout,
+        any
+    });
+}
+
 }
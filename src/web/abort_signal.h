@@ -8,11 +8,31 @@
 
 #include "v8.h"
 #include "env/environment.h"
+#include "loop/timer.h"
 #include "util/constants.h"
 #include "web/event_target.h"
 
 namespace kun::web {
 
+class AbortTimeout : public Timer {
+public:
+    AbortTimeout(Environment* env, uint64_t milliseconds, uint64_t deadline) :
+        Timer(milliseconds, TimeUnit::MILLISECOND, false),
+        env(env),
+        deadline(deadline)
+    {
+
+    }
+
+    ~AbortTimeout() = default;
+
+    void onReadable() override final;
+
+    Environment* env;
+    const uint64_t deadline;
+    std::vector<v8::Global<v8::Object>> signals;
+};
+
 class AbortSignal : public EventTarget {
 public:
     AbortSignal(Environment* env, v8::Local<v8::Object> obj) : EventTarget(env, obj, this) {}
@@ -23,6 +43,8 @@ public:
         return !abortReason.IsEmpty();
     }
 
+    bool addEventListener(const BString& type, EventListener&& listener) override;
+
     void throwIfAborted();
 
     void onabort(v8::Local<v8::Value> value);
@@ -40,16 +62,26 @@ public:
         const std::vector<v8::Local<v8::Object>>& signals
     );
 
+    void pin();
+
+    void unpin();
+
+    void retainBySources(bool retained);
+
     v8::Global<v8::Value> abortReason;
-    EventListener* onabortListener{nullptr};
     std::list<v8::Global<v8::Function>> abortAlgorithms;
-    std::list<v8::Global<v8::Object>> sourceSignals;
-    std::list<v8::Global<v8::Object>> dependentSignals;
+    std::vector<v8::Global<v8::Object>> sourceSignals;
+    std::vector<v8::Global<v8::Object>> dependentSignals;
+    size_t dependentSignalsLimit{8};
     bool dependent{false};
+    bool timeoutPending{false};
+    bool pinned{false};
 };
 
 void exposeAbortSignal(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerAbortSignalReferences(std::vector<intptr_t>& references);
+
 }
 
 #endif
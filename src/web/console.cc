@@ -33,6 +33,7 @@ using v8::TypedArray;
 using kun::BString;
 using kun::web::Console;
 using kun::sys::microsecond;
+using kun::util::addReferences;
 using kun::util::formatException;
 using kun::util::formatStackTrace;
 using kun::util::fromObject;
@@ -1313,27 +1314,28 @@ void println(
     if (console == nullptr) {
         return;
     }
-    auto indents = console->indents + console->groupStack;
-    if (indents > 0) {
-        BString str;
-        str.reserve(indents);
-        appendIndents(str, indents);
-        print(logLevel, str);
-    }
     if (length == -1) {
         length = info.Length();
     }
     auto strs = format(info, offset, offset + length);
+    auto indents = console->indents + console->groupStack;
+    size_t len = indents + strs.size();
+    for (const auto& str : strs) {
+        len += str.length();
+    }
+    BString line;
+    line.reserve(len);
+    appendIndents(line, indents);
     auto iter = strs.cbegin();
     auto end = strs.cend();
     while (iter != end) {
-        print(logLevel, *iter);
+        line += *iter;
         ++iter;
         if (iter != end) {
-            print(logLevel, " ");
+            line += " ";
         }
     }
-    println(logLevel, "");
+    println(logLevel, line);
 }
 
 void assert(const FunctionCallbackInfo<Value>& info) {
@@ -1658,4 +1660,53 @@ void exposeConsole(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, obj, v8::DontEnum).Check();
 }
 
+void serializeConsole(Local<Context> context) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    Local<Object> obj;
+    if (!fromObject(context, globalThis, "console", obj)) {
+        return;
+    }
+    auto console = InternalField<Console>::get(obj, 0);
+    if (console != nullptr) {
+        obj->SetInternalField(0, v8::Undefined(isolate));
+        console->weakObject.finalize();
+    }
+}
+
+void deserializeConsole(Local<Context> context) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    Local<Object> obj;
+    if (fromObject(context, globalThis, "console", obj)) {
+        new Console(obj);
+    }
+}
+
+void registerConsoleReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        assert,
+        clear,
+        debug,
+        error,
+        info,
+        log,
+        table,
+        trace,
+        warn,
+        dir,
+        dirxml,
+        count,
+        countReset,
+        group,
+        groupCollapsed,
+        groupEnd,
+        time,
+        timeLog,
+        timeEnd
+    });
+}
+
 }
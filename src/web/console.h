@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 #include <unordered_map>
+#include <vector>
 
 #include "v8.h"
 #include "util/bstring.h"
@@ -38,6 +39,12 @@ public:
 
 void exposeConsole(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerConsoleReferences(std::vector<intptr_t>& references);
+
+void serializeConsole(v8::Local<v8::Context> context);
+
+void deserializeConsole(v8::Local<v8::Context> context);
+
 }
 
 #endif
@@ -13,6 +13,7 @@ KUN_V8_USINGS;
 using kun::BString;
 using kun::BStringHash;
 using kun::JS;
+using kun::util::addReferences;
 using kun::util::checkFuncArgs;
 using kun::util::defineAccessor;
 using kun::util::fromInternal;
@@ -185,4 +186,13 @@ void exposeDOMException(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
 }
 
+void registerDOMExceptionReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newDOMException,
+        getName,
+        getMessage,
+        getCode
+    });
+}
+
 }
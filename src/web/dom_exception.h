@@ -1,6 +1,10 @@
 #ifndef KUN_WEB_DOM_EXCEPTION_H
 #define KUN_WEB_DOM_EXCEPTION_H
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "v8.h"
 #include "util/constants.h"
 
@@ -8,6 +12,8 @@ namespace kun::web {
 
 void exposeDOMException(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerDOMExceptionReferences(std::vector<intptr_t>& references);
+
 }
 
 #endif
@@ -14,6 +14,7 @@ using kun::JS;
 using kun::WeakObject;
 using kun::web::Event;
 using kun::sys::microsecond;
+using kun::util::addReferences;
 using kun::util::checkFuncArgs;
 using kun::util::defineAccessor;
 using kun::util::fromObject;
@@ -517,4 +518,33 @@ void exposeEvent(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
 }
 
+void registerEventReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newEvent,
+        composedPath,
+        stopPropagation,
+        stopImmediatePropagation,
+        preventDefault,
+        initEvent,
+        getType,
+        getTarget,
+        getSrcElement,
+        getCurrentTarget,
+        getEventPhase,
+        getNone,
+        getCapturingPhase,
+        getAtTarget,
+        getBubblingPhase,
+        getCancelBubble,
+        setCancelBubble,
+        getBubbles,
+        getCancelable,
+        getReturnValue,
+        setReturnValue,
+        getDefaultPrevented,
+        getComposed,
+        getTimeStamp
+    });
+}
+
 }
@@ -1,6 +1,8 @@
 #ifndef KUN_WEB_EVENT_H
 #define KUN_WEB_EVENT_H
 
+#include <stdint.h>
+
 #include <vector>
 
 #include "v8.h"
@@ -72,6 +74,8 @@ public:
 
 void exposeEvent(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerEventReferences(std::vector<intptr_t>& references);
+
 }
 
 #endif
@@ -1,5 +1,7 @@
 #include "web/event_target.h"
 
+#include <algorithm>
+
 #include "util/js_utils.h"
 #include "util/utils.h"
 #include "util/v8_utils.h"
@@ -16,6 +18,7 @@ using kun::web::Event;
 using kun::web::EventListener;
 using kun::web::EventPath;
 using kun::web::EventTarget;
+using kun::util::addReferences;
 using kun::util::checkFuncArgs;
 using kun::util::fromObject;
 using kun::util::inObject;
@@ -150,41 +153,40 @@ void appendToEventPath(
     event->path.emplace_back(std::move(eventPath));
 }
 
-bool innerInvokeEventListeners(
+void innerInvokeEventListeners(
     Local<Context> context,
     Event* event,
-    std::multimap<BString, EventListener>& listeners,
-    const BString& phase
+    EventTarget* eventTarget,
+    uint32_t type,
+    int phase
 ) {
     auto isolate = context->GetIsolate();
     HandleScope handleScope(isolate);
-    bool found = false;
-    auto [begin, end] = listeners.equal_range(event->type);
-    for (auto iter = begin; iter != end; ++iter) {
-        auto& listener = iter->second;
+    auto listenerList = eventTarget->findListenerList(type);
+    if (listenerList == nullptr) {
+        return;
+    }
+    const auto index = static_cast<size_t>(listenerList - eventTarget->listenerLists.data());
+    const auto count = listenerList->listeners.size();
+    for (size_t i = 0; i < count; i++) {
+        listenerList = &eventTarget->listenerLists[index];
+        auto& listener = listenerList->listeners[i];
         if (listener.removed) {
             continue;
         }
-        found = true;
         if (
-            (phase == "capturing" && !listener.capture) ||
-            (phase == "bubbling" && listener.capture)
+            (phase == Event::CAPTURING_PHASE && !listener.capture) ||
+            (phase == Event::BUBBLING_PHASE && listener.capture)
         ) {
             continue;
         }
-        if (listener.once) {
-            listener.removed = true;
-        }
-        ON_SCOPE_EXIT {
-            if (listener.removed) {
-                listener.callback.Reset();
-                listener.signal.Reset();
-            }
-        };
+        auto callback = listener.callback.Get(isolate);
         if (listener.passive) {
             event->inPassiveListenerFlag = true;
         }
-        auto callback = listener.callback.Get(isolate);
+        if (listener.once) {
+            listenerList->remove(listener);
+        }
         Local<Value> recv;
         Local<Function> func;
         if (callback->IsFunction()) {
@@ -196,8 +198,8 @@ bool innerInvokeEventListeners(
             func = callback.As<Function>();
         } else {
             recv = callback;
-            auto obj = callback.As<Object>();
-            if (!fromObject(context, obj, "handleEvent", func)) {
+            if (!fromObject(context, callback, "handleEvent", func)) {
+                event->inPassiveListenerFlag = false;
                 KUN_LOG_ERR("'handleEvent' not found");
                 continue;
             }
@@ -210,17 +212,17 @@ bool innerInvokeEventListeners(
         }
         event->inPassiveListenerFlag = false;
         if (event->stopImmediatePropagationFlag) {
-            return found;
+            return;
         }
     }
-    return found;
 }
 
 void invokeEventListeners(
     Local<Context> context,
     const EventPath& eventPath,
     Event* event,
-    const BString& phase
+    uint32_t type,
+    int phase
 ) {
     auto isolate = context->GetIsolate();
     HandleScope handleScope(isolate);
@@ -257,8 +259,7 @@ void invokeEventListeners(
         if (eventTarget == nullptr) {
             return;
         }
-        auto& listeners = eventTarget->listeners;
-        innerInvokeEventListeners(context, event, listeners, phase);
+        innerInvokeEventListeners(context, event, eventTarget, type, phase);
     }
 }
 
@@ -391,7 +392,20 @@ void dispatchEvent(const FunctionCallbackInfo<Value>& info) {
 
 namespace kun::web {
 
-EventListener* EventTarget::addEventListener(const BString& type, EventListener&& listener) {
+void EventListenerList::compact() {
+    if (removedCount == 0) {
+        return;
+    }
+    auto iter = std::remove_if(
+        listeners.begin(),
+        listeners.end(),
+        [](const EventListener& listener) { return listener.removed; }
+    );
+    listeners.erase(iter, listeners.end());
+    removedCount = 0;
+}
+
+bool EventTarget::addEventListener(const BString& type, EventListener&& listener) {
     auto isolate = env->getIsolate();
     HandleScope handleScope(isolate);
     auto context = env->getContext();
@@ -400,29 +414,31 @@ EventListener* EventTarget::addEventListener(const BString& type, EventListener&
         auto signal = listener.signal.Get(isolate);
         abortSignal = InternalField<AbortSignal>::get(signal, 0);
         if (abortSignal != nullptr && abortSignal->isAborted()) {
-            return nullptr;
+            return false;
         }
     }
     if (listener.callback.IsEmpty()) {
-        return nullptr;
+        return false;
     }
     auto callback = listener.callback.Get(isolate);
     auto capture = listener.capture;
-    auto [begin, end] = listeners.equal_range(type);
-    for (auto iter = begin; iter != end; ++iter) {
-        const auto& t = iter->second;
+    auto& listenerList = ensureListenerList(env->internEventType(type));
+    for (const auto& t : listenerList.listeners) {
+        if (t.removed || t.handler) {
+            continue;
+        }
         auto cb = t.callback.Get(isolate);
         if (callback->StrictEquals(cb) && capture == t.capture) {
-            return nullptr;
+            return false;
         }
     }
-    auto iter = listeners.emplace(type, std::move(listener));
+    listenerList.listeners.emplace_back(std::move(listener));
     if (abortSignal != nullptr) {
         auto target = weakObject.get();
         auto func = abortSteps(context, target, type, callback, capture);
         abortSignal->addAlgorithm(func);
     }
-    return &iter->second;
+    return true;
 }
 
 void EventTarget::removeEventListener(const BString& type, const EventListener& listener) {
@@ -431,17 +447,25 @@ void EventTarget::removeEventListener(const BString& type, const EventListener&
     if (listener.callback.IsEmpty()) {
         return;
     }
+    auto listenerList = findListenerList(env->findEventType(type));
+    if (listenerList == nullptr) {
+        return;
+    }
     auto callback = listener.callback.Get(isolate);
     auto capture = listener.capture;
-    auto [begin, end] = listeners.equal_range(type);
-    for (auto iter = begin; iter != end; ++iter) {
-        const auto& t = iter->second;
+    for (auto& t : listenerList->listeners) {
+        if (t.removed || t.handler) {
+            continue;
+        }
         auto cb = t.callback.Get(isolate);
         if (callback->StrictEquals(cb) && capture == t.capture) {
-            listeners.erase(iter);
+            listenerList->remove(t);
             break;
         }
     }
+    if (dispatchDepth == 0) {
+        compactListenerLists();
+    }
 }
 
 bool EventTarget::dispatchEvent(Event* event) {
@@ -460,6 +484,8 @@ bool EventTarget::dispatchEvent(Event* event) {
     }
     event->isTrusted = false;
     event->dispatchFlag = true;
+    const auto type = env->findEventType(event->type);
+    ++dispatchDepth;
     auto target = weakObject.get();
     Local<Value> relatedTarget;
     if (event->relatedTarget.IsEmpty()) {
@@ -476,7 +502,7 @@ bool EventTarget::dispatchEvent(Event* event) {
         } else {
             event->eventPhase = Event::CAPTURING_PHASE;
         }
-        invokeEventListeners(context, eventPath, event, "capturing");
+        invokeEventListeners(context, eventPath, event, type, Event::CAPTURING_PHASE);
     }
     for (const auto& eventPath : path) {
         if (!eventPath.shadowAdjustedTarget.IsEmpty()) {
@@ -487,7 +513,7 @@ bool EventTarget::dispatchEvent(Event* event) {
             }
             event->eventPhase = Event::BUBBLING_PHASE;
         }
-        invokeEventListeners(context, eventPath, event, "bubbling");
+        invokeEventListeners(context, eventPath, event, type, Event::BUBBLING_PHASE);
     }
     event->eventPhase = Event::NONE;
     event->currentTarget.Reset();
@@ -495,9 +521,88 @@ bool EventTarget::dispatchEvent(Event* event) {
     event->dispatchFlag = false;
     event->stopPropagationFlag = false;
     event->stopImmediatePropagationFlag = false;
+    if (--dispatchDepth == 0) {
+        compactListenerLists();
+    }
     return !event->canceledFlag;
 }
 
+Local<Value> EventTarget::getEventHandler(const BString& type) {
+    auto isolate = env->getIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto listenerList = findListenerList(env->findEventType(type));
+    if (listenerList != nullptr) {
+        for (const auto& listener : listenerList->listeners) {
+            if (listener.handler && !listener.removed) {
+                return handleScope.Escape(listener.callback.Get(isolate));
+            }
+        }
+    }
+    return handleScope.Escape(v8::Null(isolate));
+}
+
+void EventTarget::setEventHandler(const BString& type, Local<Value> value) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto listenerList = findListenerList(env->findEventType(type));
+    EventListener* current = nullptr;
+    if (listenerList != nullptr) {
+        for (auto& listener : listenerList->listeners) {
+            if (listener.handler && !listener.removed) {
+                current = &listener;
+                break;
+            }
+        }
+    }
+    if (!value.IsEmpty() && value->IsFunction()) {
+        auto func = value.As<Function>();
+        if (current != nullptr) {
+            current->callback.Reset(isolate, func);
+            return;
+        }
+        EventListener listener;
+        listener.callback.Reset(isolate, func);
+        listener.passive = false;
+        listener.handler = true;
+        auto& list = ensureListenerList(env->internEventType(type));
+        list.listeners.emplace_back(std::move(listener));
+    } else if (current != nullptr) {
+        listenerList->remove(*current);
+        if (dispatchDepth == 0) {
+            compactListenerLists();
+        }
+    }
+}
+
+EventListenerList* EventTarget::findListenerList(uint32_t type) {
+    for (auto& listenerList : listenerLists) {
+        if (listenerList.type == type) {
+            return &listenerList;
+        }
+    }
+    return nullptr;
+}
+
+EventListenerList& EventTarget::ensureListenerList(uint32_t type) {
+    auto listenerList = findListenerList(type);
+    if (listenerList != nullptr) {
+        return *listenerList;
+    }
+    return listenerLists.emplace_back(type);
+}
+
+void EventTarget::compactListenerLists() {
+    for (auto& listenerList : listenerLists) {
+        listenerList.compact();
+    }
+    auto iter = std::remove_if(
+        listenerLists.begin(),
+        listenerLists.end(),
+        [](const EventListenerList& listenerList) { return listenerList.listeners.empty(); }
+    );
+    listenerLists.erase(iter, listenerLists.end());
+}
+
 void exposeEventTarget(Local<Context> context, ExposedScope exposedScope) {
     auto isolate = context->GetIsolate();
     HandleScope handleScope(isolate);
@@ -517,4 +622,13 @@ void exposeEventTarget(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
 }
 
+void registerEventTargetReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newEventTarget,
+        addEventListener,
+        removeEventListener,
+        dispatchEvent
+    });
+}
+
 }
@@ -1,7 +1,9 @@
 #ifndef KUN_WEB_EVENT_TARGET_H
 #define KUN_WEB_EVENT_TARGET_H
 
-#include <map>
+#include <stdint.h>
+
+#include <vector>
 
 #include "v8.h"
 #include "env/environment.h"
@@ -33,6 +35,35 @@ public:
     bool once{false};
     bool capture{false};
     bool removed{false};
+    bool handler{false};
+};
+
+class EventListenerList {
+public:
+    EventListenerList(const EventListenerList&) = delete;
+
+    EventListenerList& operator=(const EventListenerList&) = delete;
+
+    EventListenerList(EventListenerList&&) = default;
+
+    EventListenerList& operator=(EventListenerList&&) = default;
+
+    explicit EventListenerList(uint32_t type) : type(type) {}
+
+    ~EventListenerList() = default;
+
+    void remove(EventListener& listener) {
+        listener.removed = true;
+        listener.callback.Reset();
+        listener.signal.Reset();
+        ++removedCount;
+    }
+
+    void compact();
+
+    uint32_t type;
+    uint32_t removedCount{0};
+    std::vector<EventListener> listeners;
 };
 
 class EventTarget {
@@ -49,20 +80,34 @@ public:
 
     virtual ~EventTarget() = default;
 
-    virtual EventListener* addEventListener(const BString& type, EventListener&& listener);
+    virtual bool addEventListener(const BString& type, EventListener&& listener);
 
     virtual void removeEventListener(const BString& type, const EventListener& listener);
 
     virtual bool dispatchEvent(Event* event);
 
+    v8::Local<v8::Value> getEventHandler(const BString& type);
+
+    void setEventHandler(const BString& type, v8::Local<v8::Value> value);
+
+    EventListenerList* findListenerList(uint32_t type);
+
     Environment* env;
     WeakObject<EventTarget> weakObject;
     InternalField<EventTarget> internalField;
-    std::multimap<BString, EventListener> listeners;
+    std::vector<EventListenerList> listenerLists;
+    uint32_t dispatchDepth{0};
+
+private:
+    EventListenerList& ensureListenerList(uint32_t type);
+
+    void compactListenerLists();
 };
 
 void exposeEventTarget(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerEventTargetReferences(std::vector<intptr_t>& references);
+
 }
 
 #endif
@@ -0,0 +1,2082 @@
+#include "web/streams.h"
+
+#include <math.h>
+
+#include "util/js_utils.h"
+#include "util/v8_utils.h"
+
+KUN_V8_USINGS;
+
+using v8::Exception;
+using v8::Integer;
+using v8::TryCatch;
+using kun::BString;
+using kun::Environment;
+using kun::InternalField;
+using kun::JS;
+using kun::web::ReadableStream;
+using kun::web::StreamState;
+using kun::web::TransformStream;
+using kun::web::Transformer;
+using kun::web::WritableStream;
+using kun::util::addReferences;
+using kun::util::checkFuncArgs;
+using kun::util::createObject;
+using kun::util::defineAccessor;
+using kun::util::fromObject;
+using kun::util::getPrototypeOf;
+using kun::util::setFunction;
+using kun::util::setToStringTag;
+using kun::util::throwRangeError;
+using kun::util::throwTypeError;
+using kun::util::toV8String;
+
+namespace {
+
+constexpr int READABLE_FIELD_COUNT = 3;
+constexpr int WRITABLE_FIELD_COUNT = 3;
+constexpr int CONTROLLER_FIELD_COUNT = 2;
+constexpr int SOURCE_INDEX = 1;
+constexpr int CONTROLLER_INDEX = 2;
+constexpr int READABLE_INDEX = 2;
+constexpr int WRITABLE_INDEX = 3;
+constexpr int TRANSFORM_CONTROLLER_INDEX = 4;
+
+constexpr uint32_t PREVENT_CLOSE = 1;
+constexpr uint32_t PREVENT_ABORT = 2;
+constexpr uint32_t PREVENT_CANCEL = 4;
+
+Local<Value> getField(Local<Object> obj, int index) {
+    return obj->GetInternalField(index).As<Value>();
+}
+
+Local<Value> newTypeError(Isolate* isolate, const BString& str) {
+    return Exception::TypeError(toV8String(isolate, str));
+}
+
+Local<Object> newIterResult(Local<Context> context, Local<Value> value, bool done) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto obj = Object::New(isolate);
+    obj->Set(context, toV8String(isolate, "value"), value).Check();
+    obj->Set(context, toV8String(isolate, "done"), Boolean::New(isolate, done)).Check();
+    return handleScope.Escape(obj);
+}
+
+Local<Promise::Resolver> newResolver(Local<Context> context) {
+    return Promise::Resolver::New(context).ToLocalChecked();
+}
+
+Local<Promise> resolvedPromise(Local<Context> context, Local<Value> value) {
+    auto resolver = newResolver(context);
+    resolver->Resolve(context, value).Check();
+    return resolver->GetPromise();
+}
+
+Local<Promise> rejectedPromise(Local<Context> context, Local<Value> reason) {
+    auto resolver = newResolver(context);
+    resolver->Reject(context, reason).Check();
+    return resolver->GetPromise();
+}
+
+void rejectHandled(
+    Local<Context> context,
+    Local<Promise::Resolver> resolver,
+    Local<Value> reason
+) {
+    resolver->GetPromise()->MarkAsHandled();
+    resolver->Reject(context, reason).Check();
+}
+
+bool callMethod(
+    Local<Context> context,
+    Local<Value> recv,
+    const char* name,
+    int argc,
+    Local<Value> argv[],
+    Local<Value>& result
+) {
+    auto isolate = context->GetIsolate();
+    result = v8::Undefined(isolate);
+    if (!recv->IsObject()) {
+        return true;
+    }
+    auto obj = recv.As<Object>();
+    Local<Value> value;
+    if (!obj->Get(context, toV8String(isolate, name)).ToLocal(&value)) {
+        return false;
+    }
+    if (value->IsUndefined()) {
+        return true;
+    }
+    if (!value->IsFunction()) {
+        throwTypeError(isolate, BString::format("'{}' is not a function", name));
+        return false;
+    }
+    return value.As<Function>()->Call(context, obj, argc, argv).ToLocal(&result);
+}
+
+void thenWith(
+    Local<Context> context,
+    Local<Value> value,
+    v8::FunctionCallback onFulfilled,
+    v8::FunctionCallback onRejected,
+    Local<Value> data
+) {
+    auto resolver = newResolver(context);
+    resolver->Resolve(context, value).Check();
+    auto fulfilled = Function::New(context, onFulfilled, data).ToLocalChecked();
+    auto rejected = Function::New(context, onRejected, data).ToLocalChecked();
+    resolver->GetPromise()->Then(context, fulfilled, rejected).ToLocalChecked();
+}
+
+bool getHighWaterMark(
+    Local<Context> context,
+    Local<Value> strategy,
+    double defaultValue,
+    double& highWaterMark
+) {
+    highWaterMark = defaultValue;
+    if (strategy.IsEmpty() || !strategy->IsObject()) {
+        return true;
+    }
+    Local<Value> value;
+    if (!fromObject(context, strategy.As<Object>(), "highWaterMark", value)) {
+        return false;
+    }
+    if (value->IsUndefined()) {
+        return true;
+    }
+    double num = NAN;
+    if (!value->NumberValue(context).To(&num)) {
+        return false;
+    }
+    if (isnan(num) || num < 0) {
+        throwRangeError(context->GetIsolate(), "'highWaterMark' must be a non-negative number");
+        return false;
+    }
+    highWaterMark = num;
+    return true;
+}
+
+Local<Object> newController(
+    Local<Context> context,
+    const BString& className,
+    Local<Object> owner
+) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto controller = createObject(context, className, CONTROLLER_FIELD_COUNT).ToLocalChecked();
+    controller->SetInternalField(0, owner->GetInternalField(0));
+    controller->SetInternalField(1, owner);
+    return handleScope.Escape(controller);
+}
+
+void returnUndefined(const FunctionCallbackInfo<Value>& info) {
+    info.GetReturnValue().SetUndefined();
+}
+
+Local<Promise> toUndefinedPromise(Local<Context> context, Local<Value> value) {
+    auto resolver = newResolver(context);
+    resolver->Resolve(context, value).Check();
+    auto func = Function::New(context, returnUndefined).ToLocalChecked();
+    return resolver->GetPromise()->Then(context, func).ToLocalChecked();
+}
+
+ReadableStream* getReadable(Local<Value> data) {
+    return InternalField<ReadableStream>::get(data.As<Object>(), 0);
+}
+
+WritableStream* getWritable(Local<Value> data) {
+    return InternalField<WritableStream>::get(data.As<Object>(), 0);
+}
+
+TransformStream* getTransform(Local<Value> data) {
+    return InternalField<TransformStream>::get(data.As<Object>(), 0);
+}
+
+void onReadableStarted(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getReadable(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->started = true;
+    stream->pullIfNeeded();
+}
+
+void onReadableErrored(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getReadable(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->error(info[0]);
+}
+
+void onPullFulfilled(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getReadable(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->onPullSettled();
+}
+
+void onWritableStarted(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getWritable(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->started = true;
+    stream->advanceQueue();
+}
+
+void onWritableErrored(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getWritable(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->transformStream != nullptr) {
+        stream->transformStream->error(info[0]);
+    } else {
+        stream->error(info[0]);
+    }
+}
+
+void onWriteFulfilled(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getWritable(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->onWriteSettled();
+}
+
+void onCloseFulfilled(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getWritable(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->onCloseSettled();
+}
+
+void onTransformFulfilled(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getTransform(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->writable->state == StreamState::OPEN) {
+        stream->writable->onWriteSettled();
+    }
+}
+
+void onTransformRejected(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getTransform(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->error(info[0]);
+}
+
+void onFlushFulfilled(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getTransform(info.Data());
+    if (stream == nullptr) {
+        return;
+    }
+    stream->readable->close();
+    if (stream->writable->state == StreamState::OPEN) {
+        stream->writable->onCloseSettled();
+    }
+}
+
+void illegalConstructor(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    throwTypeError(isolate, "Illegal constructor");
+}
+
+void newReadableStream(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    if (
+        !checkFuncArgs<
+        JS::Optional | JS::Object,
+        JS::Optional | JS::Object
+        >(info)
+    ) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    double highWaterMark = 1;
+    if (!getHighWaterMark(context, info[1], 1, highWaterMark)) {
+        return;
+    }
+    auto env = Environment::from(context);
+    auto recv = info.This();
+    auto stream = new ReadableStream(env, recv, highWaterMark);
+    auto controller = newController(context, "ReadableStreamDefaultController", recv);
+    recv->SetInternalField(SOURCE_INDEX, info[0]);
+    recv->SetInternalField(CONTROLLER_INDEX, controller);
+    Local<Value> argv[] = {controller};
+    Local<Value> result;
+    if (!callMethod(context, info[0], "start", 1, argv, result)) {
+        return;
+    }
+    stream->start(result);
+}
+
+void getReadableLocked(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<ReadableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(stream->locked);
+}
+
+void cancelReadable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<ReadableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    if (stream->locked) {
+        auto reason = newTypeError(isolate, "The stream is locked");
+        info.GetReturnValue().Set(rejectedPromise(context, reason));
+        return;
+    }
+    info.GetReturnValue().Set(stream->cancel(info[0]));
+}
+
+void getReader(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto stream = InternalField<ReadableStream>::get(recv, 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->locked) {
+        throwTypeError(isolate, "The stream is locked");
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto reader = createObject(context, "ReadableStreamDefaultReader", 1).ToLocalChecked();
+    reader->SetInternalField(0, recv);
+    stream->acquireReader();
+    info.GetReturnValue().Set(reader);
+}
+
+void finishPipe(Local<Context> context, Local<Object> state, Local<Value> value, bool failed) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto resolverValue = getField(state, 2);
+    if (resolverValue->IsUndefined()) {
+        return;
+    }
+    state->SetInternalField(2, v8::Undefined(isolate));
+    auto source = getReadable(getField(state, 0));
+    auto dest = getWritable(getField(state, 1));
+    if (source != nullptr) {
+        source->releaseReader();
+    }
+    if (dest != nullptr) {
+        dest->releaseWriter();
+    }
+    auto resolver = resolverValue.As<Promise::Resolver>();
+    if (failed) {
+        resolver->Reject(context, value).Check();
+    } else {
+        resolver->Resolve(context, v8::Undefined(isolate)).Check();
+    }
+}
+
+bool isPipeFinished(Local<Object> state) {
+    return getField(state, 2)->IsUndefined();
+}
+
+uint32_t getPipeFlags(Local<Context> context, Local<Object> state) {
+    return getField(state, 3)->Uint32Value(context).FromMaybe(0);
+}
+
+void pipeStep(Local<Context> context, Local<Object> state);
+
+void onPipeSourceError(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    if (isPipeFinished(state)) {
+        return;
+    }
+    auto dest = getWritable(getField(state, 1));
+    if (dest != nullptr && (getPipeFlags(context, state) & PREVENT_ABORT) == 0) {
+        dest->abort(info[0])->MarkAsHandled();
+    }
+    finishPipe(context, state, info[0], true);
+}
+
+void onPipeDestError(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    if (isPipeFinished(state)) {
+        return;
+    }
+    auto source = getReadable(getField(state, 0));
+    if (source != nullptr && (getPipeFlags(context, state) & PREVENT_CANCEL) == 0) {
+        source->cancel(info[0])->MarkAsHandled();
+    }
+    finishPipe(context, state, info[0], true);
+}
+
+void onPipeClosed(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    finishPipe(context, state, v8::Undefined(isolate), false);
+}
+
+void onPipeReady(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    if (isPipeFinished(state)) {
+        return;
+    }
+    pipeStep(context, state);
+}
+
+void onPipeRead(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    if (isPipeFinished(state)) {
+        return;
+    }
+    auto dest = getWritable(getField(state, 1));
+    if (dest == nullptr) {
+        return;
+    }
+    auto result = info[0].As<Object>();
+    bool done = false;
+    fromObject(context, result, "done", done);
+    if (done) {
+        if ((getPipeFlags(context, state) & PREVENT_CLOSE) != 0) {
+            finishPipe(context, state, v8::Undefined(isolate), false);
+            return;
+        }
+        auto resolver = newResolver(context);
+        dest->close(resolver);
+        thenWith(context, resolver->GetPromise(), onPipeClosed, onPipeDestError, state);
+        return;
+    }
+    Local<Value> value;
+    fromObject(context, result, "value", value);
+    auto resolver = newResolver(context);
+    dest->write(value, resolver);
+    auto fulfilled = Function::New(context, returnUndefined).ToLocalChecked();
+    auto rejected = Function::New(context, onPipeDestError, state).ToLocalChecked();
+    resolver->GetPromise()->Then(context, fulfilled, rejected).ToLocalChecked();
+    pipeStep(context, state);
+}
+
+void pipeStep(Local<Context> context, Local<Object> state) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto source = getReadable(getField(state, 0));
+    auto dest = getWritable(getField(state, 1));
+    if (source == nullptr || dest == nullptr) {
+        return;
+    }
+    if (dest->state != StreamState::OPEN || dest->isClosing()) {
+        Local<Value> reason = dest->state == StreamState::ERRORED ?
+            dest->storedError.Get(isolate) :
+            newTypeError(isolate, "The destination stream is closed");
+        if ((getPipeFlags(context, state) & PREVENT_CANCEL) == 0) {
+            source->cancel(reason)->MarkAsHandled();
+        }
+        finishPipe(context, state, reason, true);
+        return;
+    }
+    if (dest->backpressure) {
+        thenWith(context, dest->getReady(), onPipeReady, onPipeDestError, state);
+        return;
+    }
+    auto resolver = newResolver(context);
+    source->read(resolver);
+    thenWith(context, resolver->GetPromise(), onPipeRead, onPipeSourceError, state);
+}
+
+Local<Promise> pipeStreams(
+    Local<Context> context,
+    Local<Object> sourceObj,
+    Local<Value> destValue,
+    Local<Value> options
+) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto source = InternalField<ReadableStream>::get(sourceObj, 0);
+    if (source == nullptr) {
+        return handleScope.Escape(Local<Promise>());
+    }
+    WritableStream* dest = nullptr;
+    if (destValue->IsObject()) {
+        TryCatch tryCatch(isolate);
+        dest = InternalField<WritableStream>::get(destValue.As<Object>(), 0);
+    }
+    if (dest == nullptr) {
+        auto reason = newTypeError(isolate, "'destination' must be a WritableStream");
+        return handleScope.Escape(rejectedPromise(context, reason));
+    }
+    if (source->locked || dest->locked) {
+        auto reason = newTypeError(isolate, "The stream is locked");
+        return handleScope.Escape(rejectedPromise(context, reason));
+    }
+    uint32_t flags = 0;
+    if (!options.IsEmpty() && options->IsObject()) {
+        auto obj = options.As<Object>();
+        bool value = false;
+        if (fromObject(context, obj, "preventClose", value) && value) {
+            flags |= PREVENT_CLOSE;
+        }
+        if (fromObject(context, obj, "preventAbort", value) && value) {
+            flags |= PREVENT_ABORT;
+        }
+        if (fromObject(context, obj, "preventCancel", value) && value) {
+            flags |= PREVENT_CANCEL;
+        }
+    }
+    auto objTmpl = ObjectTemplate::New(isolate);
+    objTmpl->SetInternalFieldCount(4);
+    auto state = objTmpl->NewInstance(context).ToLocalChecked();
+    auto resolver = newResolver(context);
+    state->SetInternalField(0, sourceObj);
+    state->SetInternalField(1, destValue);
+    state->SetInternalField(2, resolver);
+    state->SetInternalField(3, Integer::NewFromUnsigned(isolate, flags));
+    source->acquireReader();
+    dest->acquireWriter();
+    pipeStep(context, state);
+    return handleScope.Escape(resolver->GetPromise());
+}
+
+void pipeTo(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto promise = pipeStreams(context, info.This(), info[0], info[1]);
+    if (!promise.IsEmpty()) {
+        info.GetReturnValue().Set(promise);
+    }
+}
+
+void pipeThrough(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Object, JS::Optional | JS::Object>(info)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto pair = info[0].As<Object>();
+    Local<Value> writable;
+    Local<Value> readable;
+    if (
+        !fromObject(context, pair, "writable", writable) ||
+        !fromObject(context, pair, "readable", readable)
+    ) {
+        return;
+    }
+    if (!readable->IsObject()) {
+        throwTypeError(isolate, "'readable' must be a ReadableStream");
+        return;
+    }
+    auto source = InternalField<ReadableStream>::get(info.This(), 0);
+    if (source == nullptr) {
+        return;
+    }
+    if (source->locked) {
+        throwTypeError(isolate, "The stream is locked");
+        return;
+    }
+    auto promise = pipeStreams(context, info.This(), writable, info[1]);
+    if (promise.IsEmpty()) {
+        return;
+    }
+    promise->MarkAsHandled();
+    info.GetReturnValue().Set(readable);
+}
+
+void onIteratorRead(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    bool done = false;
+    fromObject(context, info[0].As<Object>(), "done", done);
+    if (done) {
+        auto streamObj = getField(state, 0);
+        if (streamObj->IsObject()) {
+            getReadable(streamObj)->releaseReader();
+            state->SetInternalField(0, v8::Undefined(isolate));
+        }
+    }
+    info.GetReturnValue().Set(info[0]);
+}
+
+void onIteratorError(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto state = info.Data().As<Object>();
+    auto streamObj = getField(state, 0);
+    if (streamObj->IsObject()) {
+        getReadable(streamObj)->releaseReader();
+        state->SetInternalField(0, v8::Undefined(isolate));
+    }
+    isolate->ThrowException(info[0]);
+}
+
+void iteratorNext(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    auto streamObj = getField(state, 0);
+    if (!streamObj->IsObject()) {
+        auto result = newIterResult(context, v8::Undefined(isolate), true);
+        info.GetReturnValue().Set(resolvedPromise(context, result));
+        return;
+    }
+    auto resolver = newResolver(context);
+    getReadable(streamObj)->read(resolver);
+    auto fulfilled = Function::New(context, onIteratorRead, state).ToLocalChecked();
+    auto rejected = Function::New(context, onIteratorError, state).ToLocalChecked();
+    auto promise = resolver->GetPromise()->Then(context, fulfilled, rejected).ToLocalChecked();
+    info.GetReturnValue().Set(promise);
+}
+
+void iteratorReturn(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto state = info.Data().As<Object>();
+    auto streamObj = getField(state, 0);
+    auto result = newIterResult(context, info[0], true);
+    if (!streamObj->IsObject()) {
+        info.GetReturnValue().Set(resolvedPromise(context, result));
+        return;
+    }
+    auto stream = getReadable(streamObj);
+    state->SetInternalField(0, v8::Undefined(isolate));
+    if (getField(state, 1)->IsTrue()) {
+        stream->releaseReader();
+        info.GetReturnValue().Set(resolvedPromise(context, result));
+        return;
+    }
+    auto promise = stream->cancel(info[0]);
+    stream->releaseReader();
+    auto func = Function::New(context, returnUndefined).ToLocalChecked();
+    auto resolver = newResolver(context);
+    resolver->Resolve(context, result).Check();
+    promise->Then(context, func).ToLocalChecked()->MarkAsHandled();
+    info.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void getIterator(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto stream = InternalField<ReadableStream>::get(recv, 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->locked) {
+        throwTypeError(isolate, "The stream is locked");
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    bool preventCancel = false;
+    if (info.Length() > 0 && info[0]->IsObject()) {
+        fromObject(context, info[0].As<Object>(), "preventCancel", preventCancel);
+    }
+    auto objTmpl = ObjectTemplate::New(isolate);
+    objTmpl->SetInternalFieldCount(2);
+    auto state = objTmpl->NewInstance(context).ToLocalChecked();
+    state->SetInternalField(0, recv);
+    state->SetInternalField(1, Boolean::New(isolate, preventCancel));
+    stream->acquireReader();
+    auto iterator = Object::New(isolate);
+    auto next = Function::New(context, iteratorNext, state).ToLocalChecked();
+    auto ret = Function::New(context, iteratorReturn, state).ToLocalChecked();
+    iterator->Set(context, toV8String(isolate, "next"), next).Check();
+    iterator->Set(context, toV8String(isolate, "return"), ret).Check();
+    info.GetReturnValue().Set(iterator);
+}
+
+bool getReaderStream(
+    const FunctionCallbackInfo<Value>& info,
+    ReadableStream*& stream
+) {
+    auto isolate = info.GetIsolate();
+    auto recv = info.This();
+    if (recv->InternalFieldCount() < 1) {
+        throwTypeError(isolate, "Illegal invocation");
+        return false;
+    }
+    auto streamObj = getField(recv, 0);
+    stream = streamObj->IsObject() ? getReadable(streamObj) : nullptr;
+    return true;
+}
+
+void newReader(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    if (!checkFuncArgs<JS::Object>(info)) {
+        return;
+    }
+    auto streamObj = info[0].As<Object>();
+    auto stream = InternalField<ReadableStream>::get(streamObj, 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->locked) {
+        throwTypeError(isolate, "The stream is locked");
+        return;
+    }
+    info.This()->SetInternalField(0, streamObj);
+    stream->acquireReader();
+}
+
+void readerRead(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    ReadableStream* stream = nullptr;
+    if (!getReaderStream(info, stream)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    if (stream == nullptr) {
+        auto reason = newTypeError(isolate, "The reader has been released");
+        info.GetReturnValue().Set(rejectedPromise(context, reason));
+        return;
+    }
+    auto resolver = newResolver(context);
+    stream->read(resolver);
+    info.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void readerReleaseLock(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    ReadableStream* stream = nullptr;
+    if (!getReaderStream(info, stream) || stream == nullptr) {
+        return;
+    }
+    stream->releaseReader();
+    info.This()->SetInternalField(0, v8::Undefined(isolate));
+}
+
+void readerCancel(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    ReadableStream* stream = nullptr;
+    if (!getReaderStream(info, stream)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    if (stream == nullptr) {
+        auto reason = newTypeError(isolate, "The reader has been released");
+        info.GetReturnValue().Set(rejectedPromise(context, reason));
+        return;
+    }
+    info.GetReturnValue().Set(stream->cancel(info[0]));
+}
+
+void getReaderClosed(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    ReadableStream* stream = nullptr;
+    if (!getReaderStream(info, stream)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    if (stream == nullptr || stream->closedResolver.IsEmpty()) {
+        auto reason = newTypeError(isolate, "The reader has been released");
+        auto promise = rejectedPromise(context, reason);
+        promise->MarkAsHandled();
+        info.GetReturnValue().Set(promise);
+        return;
+    }
+    info.GetReturnValue().Set(stream->closedResolver.Get(isolate)->GetPromise());
+}
+
+void controllerEnqueue(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<ReadableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (!stream->canEnqueue()) {
+        throwTypeError(isolate, "The stream is not in a state that permits enqueue");
+        return;
+    }
+    stream->enqueue(info[0]);
+}
+
+void controllerClose(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<ReadableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (!stream->canEnqueue()) {
+        throwTypeError(isolate, "The stream is not in a state that permits close");
+        return;
+    }
+    stream->close();
+}
+
+void controllerError(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<ReadableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    stream->error(info[0]);
+}
+
+void getControllerDesiredSize(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<ReadableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->state == StreamState::ERRORED) {
+        info.GetReturnValue().SetNull();
+    } else if (stream->state == StreamState::CLOSED) {
+        info.GetReturnValue().Set(0);
+    } else {
+        info.GetReturnValue().Set(stream->getDesiredSize());
+    }
+}
+
+void newWritableStream(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    if (
+        !checkFuncArgs<
+        JS::Optional | JS::Object,
+        JS::Optional | JS::Object
+        >(info)
+    ) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    double highWaterMark = 1;
+    if (!getHighWaterMark(context, info[1], 1, highWaterMark)) {
+        return;
+    }
+    auto env = Environment::from(context);
+    auto recv = info.This();
+    auto stream = new WritableStream(env, recv, highWaterMark);
+    auto controller = newController(context, "WritableStreamDefaultController", recv);
+    recv->SetInternalField(SOURCE_INDEX, info[0]);
+    recv->SetInternalField(CONTROLLER_INDEX, controller);
+    Local<Value> argv[] = {controller};
+    Local<Value> result;
+    if (!callMethod(context, info[0], "start", 1, argv, result)) {
+        return;
+    }
+    stream->start(result);
+}
+
+void getWritableLocked(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<WritableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(stream->locked);
+}
+
+void abortWritable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<WritableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    if (stream->locked) {
+        auto reason = newTypeError(isolate, "The stream is locked");
+        info.GetReturnValue().Set(rejectedPromise(context, reason));
+        return;
+    }
+    info.GetReturnValue().Set(stream->abort(info[0]));
+}
+
+void closeWritable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<WritableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    if (stream->locked) {
+        auto reason = newTypeError(isolate, "The stream is locked");
+        info.GetReturnValue().Set(rejectedPromise(context, reason));
+        return;
+    }
+    auto resolver = newResolver(context);
+    stream->close(resolver);
+    info.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void getWriter(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto stream = InternalField<WritableStream>::get(recv, 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->locked) {
+        throwTypeError(isolate, "The stream is locked");
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto writer = createObject(context, "WritableStreamDefaultWriter", 1).ToLocalChecked();
+    writer->SetInternalField(0, recv);
+    stream->acquireWriter();
+    info.GetReturnValue().Set(writer);
+}
+
+bool getWriterStream(
+    const FunctionCallbackInfo<Value>& info,
+    WritableStream*& stream
+) {
+    auto isolate = info.GetIsolate();
+    auto recv = info.This();
+    if (recv->InternalFieldCount() < 1) {
+        throwTypeError(isolate, "Illegal invocation");
+        return false;
+    }
+    auto streamObj = getField(recv, 0);
+    stream = streamObj->IsObject() ? getWritable(streamObj) : nullptr;
+    return true;
+}
+
+void rejectReleased(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    auto context = isolate->GetCurrentContext();
+    auto reason = newTypeError(isolate, "The writer has been released");
+    info.GetReturnValue().Set(rejectedPromise(context, reason));
+}
+
+void newWriter(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    if (!checkFuncArgs<JS::Object>(info)) {
+        return;
+    }
+    auto streamObj = info[0].As<Object>();
+    auto stream = InternalField<WritableStream>::get(streamObj, 0);
+    if (stream == nullptr) {
+        return;
+    }
+    if (stream->locked) {
+        throwTypeError(isolate, "The stream is locked");
+        return;
+    }
+    info.This()->SetInternalField(0, streamObj);
+    stream->acquireWriter();
+}
+
+void writerWrite(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    WritableStream* stream = nullptr;
+    if (!getWriterStream(info, stream)) {
+        return;
+    }
+    if (stream == nullptr) {
+        rejectReleased(info);
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto resolver = newResolver(context);
+    stream->write(info[0], resolver);
+    info.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void writerClose(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    WritableStream* stream = nullptr;
+    if (!getWriterStream(info, stream)) {
+        return;
+    }
+    if (stream == nullptr) {
+        rejectReleased(info);
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto resolver = newResolver(context);
+    stream->close(resolver);
+    info.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void writerAbort(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    WritableStream* stream = nullptr;
+    if (!getWriterStream(info, stream)) {
+        return;
+    }
+    if (stream == nullptr) {
+        rejectReleased(info);
+        return;
+    }
+    info.GetReturnValue().Set(stream->abort(info[0]));
+}
+
+void writerReleaseLock(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    WritableStream* stream = nullptr;
+    if (!getWriterStream(info, stream) || stream == nullptr) {
+        return;
+    }
+    stream->releaseWriter();
+    info.This()->SetInternalField(0, v8::Undefined(isolate));
+}
+
+void getWriterReady(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    WritableStream* stream = nullptr;
+    if (!getWriterStream(info, stream)) {
+        return;
+    }
+    if (stream == nullptr) {
+        rejectReleased(info);
+        return;
+    }
+    info.GetReturnValue().Set(stream->getReady());
+}
+
+void getWriterClosed(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    WritableStream* stream = nullptr;
+    if (!getWriterStream(info, stream)) {
+        return;
+    }
+    if (stream == nullptr || stream->closedResolver.IsEmpty()) {
+        rejectReleased(info);
+        return;
+    }
+    info.GetReturnValue().Set(stream->closedResolver.Get(isolate)->GetPromise());
+}
+
+void getWriterDesiredSize(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    WritableStream* stream = nullptr;
+    if (!getWriterStream(info, stream)) {
+        return;
+    }
+    if (stream == nullptr) {
+        throwTypeError(isolate, "The writer has been released");
+        return;
+    }
+    if (stream->state == StreamState::ERRORED) {
+        info.GetReturnValue().SetNull();
+    } else if (stream->state == StreamState::CLOSED) {
+        info.GetReturnValue().Set(0);
+    } else {
+        info.GetReturnValue().Set(stream->getDesiredSize());
+    }
+}
+
+void writableControllerError(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<WritableStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    stream->error(info[0]);
+}
+
+void newTransformStream(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    if (
+        !checkFuncArgs<
+        JS::Optional | JS::Object,
+        JS::Optional | JS::Object,
+        JS::Optional | JS::Object
+        >(info)
+    ) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    double writableHighWaterMark = 1;
+    double readableHighWaterMark = 0;
+    if (
+        !getHighWaterMark(context, info[1], 1, writableHighWaterMark) ||
+        !getHighWaterMark(context, info[2], 0, readableHighWaterMark)
+    ) {
+        return;
+    }
+    auto env = Environment::from(context);
+    auto recv = info.This();
+    auto stream = new TransformStream(
+        env,
+        recv,
+        nullptr,
+        writableHighWaterMark,
+        readableHighWaterMark
+    );
+    auto controller = newController(context, "TransformStreamDefaultController", recv);
+    recv->SetInternalField(SOURCE_INDEX, info[0]);
+    recv->SetInternalField(TRANSFORM_CONTROLLER_INDEX, controller);
+    Local<Value> argv[] = {controller};
+    Local<Value> result;
+    if (!callMethod(context, info[0], "start", 1, argv, result)) {
+        return;
+    }
+    stream->writable->start(result);
+}
+
+void getTransformReadable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    if (InternalField<TransformStream>::get(recv, 0) == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(getField(recv, READABLE_INDEX));
+}
+
+void getTransformWritable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    if (InternalField<TransformStream>::get(recv, 0) == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(getField(recv, WRITABLE_INDEX));
+}
+
+void transformControllerEnqueue(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<TransformStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    stream->enqueue(info[0]);
+}
+
+void transformControllerError(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<TransformStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    stream->error(info[0]);
+}
+
+void transformControllerTerminate(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<TransformStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    stream->terminate();
+}
+
+void getTransformControllerDesiredSize(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = InternalField<TransformStream>::get(info.This(), 0);
+    if (stream == nullptr) {
+        return;
+    }
+    auto readable = stream->readable;
+    if (readable->state == StreamState::ERRORED) {
+        info.GetReturnValue().SetNull();
+    } else if (readable->state == StreamState::CLOSED) {
+        info.GetReturnValue().Set(0);
+    } else {
+        info.GetReturnValue().Set(readable->getDesiredSize());
+    }
+}
+
+}
+
+namespace kun::web {
+
+void ReadableStream::start(Local<Value> result) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    thenWith(context, result, onReadableStarted, onReadableErrored, weakObject.get());
+}
+
+void ReadableStream::enqueue(Local<Value> chunk) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (!readRequests.empty()) {
+        auto resolver = readRequests.front().Get(isolate);
+        readRequests.pop_front();
+        resolver->Resolve(context, newIterResult(context, chunk, false)).Check();
+    } else {
+        queue.emplace_back(isolate, chunk);
+    }
+    pullIfNeeded();
+}
+
+void ReadableStream::close() {
+    if (!canEnqueue()) {
+        return;
+    }
+    closeRequested = true;
+    if (queue.empty()) {
+        finishClose();
+    }
+}
+
+void ReadableStream::error(Local<Value> reason) {
+    if (state != StreamState::OPEN) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    state = StreamState::ERRORED;
+    storedError.Reset(isolate, reason);
+    queue.clear();
+    while (!readRequests.empty()) {
+        auto resolver = readRequests.front().Get(isolate);
+        readRequests.pop_front();
+        resolver->Reject(context, reason).Check();
+    }
+    if (!closedResolver.IsEmpty()) {
+        rejectHandled(context, closedResolver.Get(isolate), reason);
+    }
+}
+
+void ReadableStream::read(Local<Promise::Resolver> resolver) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (state == StreamState::CLOSED) {
+        auto result = newIterResult(context, v8::Undefined(isolate), true);
+        resolver->Resolve(context, result).Check();
+        return;
+    }
+    if (state == StreamState::ERRORED) {
+        resolver->Reject(context, storedError.Get(isolate)).Check();
+        return;
+    }
+    if (!queue.empty()) {
+        auto chunk = queue.front().Get(isolate);
+        queue.pop_front();
+        resolver->Resolve(context, newIterResult(context, chunk, false)).Check();
+        if (closeRequested && queue.empty()) {
+            finishClose();
+        } else {
+            pullIfNeeded();
+        }
+        return;
+    }
+    readRequests.emplace_back(isolate, resolver);
+    pullIfNeeded();
+}
+
+Local<Promise> ReadableStream::cancel(Local<Value> reason) {
+    auto isolate = env->getIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (state == StreamState::CLOSED) {
+        return handleScope.Escape(resolvedPromise(context, v8::Undefined(isolate)));
+    }
+    if (state == StreamState::ERRORED) {
+        return handleScope.Escape(rejectedPromise(context, storedError.Get(isolate)));
+    }
+    queue.clear();
+    finishClose();
+    if (transformStream != nullptr) {
+        transformStream->cancel(reason);
+        return handleScope.Escape(resolvedPromise(context, v8::Undefined(isolate)));
+    }
+    auto source = getField(weakObject.get(), SOURCE_INDEX);
+    TryCatch tryCatch(isolate);
+    Local<Value> argv[] = {reason};
+    Local<Value> result;
+    if (!callMethod(context, source, "cancel", 1, argv, result)) {
+        return handleScope.Escape(rejectedPromise(context, tryCatch.Exception()));
+    }
+    return handleScope.Escape(toUndefinedPromise(context, result));
+}
+
+void ReadableStream::acquireReader() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    locked = true;
+    auto resolver = newResolver(context);
+    if (state == StreamState::CLOSED) {
+        resolver->Resolve(context, v8::Undefined(isolate)).Check();
+    } else if (state == StreamState::ERRORED) {
+        rejectHandled(context, resolver, storedError.Get(isolate));
+    }
+    closedResolver.Reset(isolate, resolver);
+}
+
+void ReadableStream::releaseReader() {
+    if (!locked) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    locked = false;
+    auto reason = newTypeError(isolate, "The reader has been released");
+    while (!readRequests.empty()) {
+        auto resolver = readRequests.front().Get(isolate);
+        readRequests.pop_front();
+        resolver->Reject(context, reason).Check();
+    }
+    if (state == StreamState::OPEN && !closedResolver.IsEmpty()) {
+        rejectHandled(context, closedResolver.Get(isolate), reason);
+    }
+    closedResolver.Reset();
+}
+
+void ReadableStream::pullIfNeeded() {
+    if (state != StreamState::OPEN || !started || closeRequested) {
+        return;
+    }
+    if (readRequests.empty() && getDesiredSize() <= 0) {
+        return;
+    }
+    if (pulling) {
+        pullAgain = true;
+        return;
+    }
+    pulling = true;
+    if (transformStream != nullptr) {
+        transformStream->onPull();
+        onPullSettled();
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    auto obj = weakObject.get();
+    auto source = getField(obj, SOURCE_INDEX);
+    TryCatch tryCatch(isolate);
+    Local<Value> argv[] = {getField(obj, CONTROLLER_INDEX)};
+    Local<Value> result;
+    if (!callMethod(context, source, "pull", 1, argv, result)) {
+        pulling = false;
+        error(tryCatch.Exception());
+        return;
+    }
+    thenWith(context, result, onPullFulfilled, onReadableErrored, obj);
+}
+
+void ReadableStream::onPullSettled() {
+    pulling = false;
+    if (pullAgain) {
+        pullAgain = false;
+        pullIfNeeded();
+    }
+}
+
+void ReadableStream::finishClose() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    state = StreamState::CLOSED;
+    while (!readRequests.empty()) {
+        auto resolver = readRequests.front().Get(isolate);
+        readRequests.pop_front();
+        auto result = newIterResult(context, v8::Undefined(isolate), true);
+        resolver->Resolve(context, result).Check();
+    }
+    if (!closedResolver.IsEmpty()) {
+        closedResolver.Get(isolate)->Resolve(context, v8::Undefined(isolate)).Check();
+    }
+}
+
+void WritableStream::start(Local<Value> result) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    updateBackpressure();
+    thenWith(context, result, onWritableStarted, onWritableErrored, weakObject.get());
+}
+
+void WritableStream::write(Local<Value> chunk, Local<Promise::Resolver> resolver) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (state == StreamState::ERRORED) {
+        resolver->Reject(context, storedError.Get(isolate)).Check();
+        return;
+    }
+    if (state == StreamState::CLOSED || isClosing()) {
+        auto reason = newTypeError(isolate, "The stream is closing or closed");
+        resolver->Reject(context, reason).Check();
+        return;
+    }
+    writeRequests.emplace_back(isolate, chunk);
+    writeResolvers.emplace_back(isolate, resolver);
+    updateBackpressure();
+    advanceQueue();
+}
+
+void WritableStream::close(Local<Promise::Resolver> resolver) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (state == StreamState::ERRORED) {
+        resolver->Reject(context, storedError.Get(isolate)).Check();
+        return;
+    }
+    if (state == StreamState::CLOSED || isClosing()) {
+        auto reason = newTypeError(isolate, "The stream is closing or closed");
+        resolver->Reject(context, reason).Check();
+        return;
+    }
+    closeResolver.Reset(isolate, resolver);
+    if (locked && backpressure) {
+        readyResolver.Get(isolate)->Resolve(context, v8::Undefined(isolate)).Check();
+    }
+    advanceQueue();
+}
+
+void WritableStream::error(Local<Value> reason) {
+    if (state != StreamState::OPEN) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    state = StreamState::ERRORED;
+    storedError.Reset(isolate, reason);
+    inFlight = false;
+    writeRequests.clear();
+    while (!writeResolvers.empty()) {
+        auto resolver = writeResolvers.front().Get(isolate);
+        writeResolvers.pop_front();
+        resolver->Reject(context, reason).Check();
+    }
+    if (!closeResolver.IsEmpty()) {
+        closeResolver.Get(isolate)->Reject(context, reason).Check();
+        closeResolver.Reset();
+    }
+    if (!closedResolver.IsEmpty()) {
+        rejectHandled(context, closedResolver.Get(isolate), reason);
+    }
+    if (locked) {
+        auto resolver = readyResolver.Get(isolate);
+        if (!backpressure) {
+            resolver = newResolver(context);
+            readyResolver.Reset(isolate, resolver);
+        }
+        rejectHandled(context, resolver, reason);
+    }
+}
+
+Local<Promise> WritableStream::abort(Local<Value> reason) {
+    auto isolate = env->getIsolate();
+    EscapableHandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (state != StreamState::OPEN) {
+        return handleScope.Escape(resolvedPromise(context, v8::Undefined(isolate)));
+    }
+    if (transformStream != nullptr) {
+        transformStream->abort(reason);
+        return handleScope.Escape(resolvedPromise(context, v8::Undefined(isolate)));
+    }
+    error(reason);
+    auto sink = getField(weakObject.get(), SOURCE_INDEX);
+    TryCatch tryCatch(isolate);
+    Local<Value> argv[] = {reason};
+    Local<Value> result;
+    if (!callMethod(context, sink, "abort", 1, argv, result)) {
+        return handleScope.Escape(rejectedPromise(context, tryCatch.Exception()));
+    }
+    return handleScope.Escape(toUndefinedPromise(context, result));
+}
+
+void WritableStream::acquireWriter() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    locked = true;
+    auto closed = newResolver(context);
+    auto ready = newResolver(context);
+    if (state == StreamState::CLOSED) {
+        closed->Resolve(context, v8::Undefined(isolate)).Check();
+        ready->Resolve(context, v8::Undefined(isolate)).Check();
+    } else if (state == StreamState::ERRORED) {
+        rejectHandled(context, closed, storedError.Get(isolate));
+        rejectHandled(context, ready, storedError.Get(isolate));
+    } else if (!backpressure || isClosing()) {
+        ready->Resolve(context, v8::Undefined(isolate)).Check();
+    }
+    closedResolver.Reset(isolate, closed);
+    readyResolver.Reset(isolate, ready);
+}
+
+void WritableStream::releaseWriter() {
+    if (!locked) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    locked = false;
+    auto reason = newTypeError(isolate, "The writer has been released");
+    if (state == StreamState::OPEN) {
+        if (backpressure && !isClosing()) {
+            rejectHandled(context, readyResolver.Get(isolate), reason);
+        }
+        rejectHandled(context, closedResolver.Get(isolate), reason);
+    }
+    readyResolver.Reset();
+    closedResolver.Reset();
+}
+
+void WritableStream::advanceQueue() {
+    if (!started || inFlight || state != StreamState::OPEN) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    auto obj = weakObject.get();
+    if (writeRequests.empty()) {
+        if (closeResolver.IsEmpty()) {
+            return;
+        }
+        inFlight = true;
+        if (transformStream != nullptr) {
+            transformStream->close();
+            return;
+        }
+        TryCatch tryCatch(isolate);
+        Local<Value> result;
+        if (!callMethod(context, getField(obj, SOURCE_INDEX), "close", 0, nullptr, result)) {
+            error(tryCatch.Exception());
+            return;
+        }
+        thenWith(context, result, onCloseFulfilled, onWritableErrored, obj);
+        return;
+    }
+    inFlight = true;
+    auto chunk = writeRequests.front().Get(isolate);
+    if (transformStream != nullptr) {
+        transformStream->write(chunk);
+        return;
+    }
+    TryCatch tryCatch(isolate);
+    Local<Value> argv[] = {chunk, getField(obj, CONTROLLER_INDEX)};
+    Local<Value> result;
+    if (!callMethod(context, getField(obj, SOURCE_INDEX), "write", 2, argv, result)) {
+        error(tryCatch.Exception());
+        return;
+    }
+    thenWith(context, result, onWriteFulfilled, onWritableErrored, obj);
+}
+
+void WritableStream::onWriteSettled() {
+    if (state != StreamState::OPEN || writeResolvers.empty()) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    inFlight = false;
+    auto resolver = writeResolvers.front().Get(isolate);
+    writeResolvers.pop_front();
+    writeRequests.pop_front();
+    resolver->Resolve(context, v8::Undefined(isolate)).Check();
+    updateBackpressure();
+    advanceQueue();
+}
+
+void WritableStream::onCloseSettled() {
+    if (state != StreamState::OPEN) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    inFlight = false;
+    state = StreamState::CLOSED;
+    if (!closeResolver.IsEmpty()) {
+        closeResolver.Get(isolate)->Resolve(context, v8::Undefined(isolate)).Check();
+        closeResolver.Reset();
+    }
+    if (!closedResolver.IsEmpty()) {
+        closedResolver.Get(isolate)->Resolve(context, v8::Undefined(isolate)).Check();
+    }
+}
+
+Local<Promise> WritableStream::getReady() {
+    auto isolate = env->getIsolate();
+    EscapableHandleScope handleScope(isolate);
+    if (readyResolver.IsEmpty()) {
+        auto context = env->getContext();
+        return handleScope.Escape(resolvedPromise(context, v8::Undefined(isolate)));
+    }
+    return handleScope.Escape(readyResolver.Get(isolate)->GetPromise());
+}
+
+void WritableStream::updateBackpressure() {
+    if (state != StreamState::OPEN || isClosing()) {
+        return;
+    }
+    auto value = getDesiredSize() <= 0;
+    if (value == backpressure) {
+        return;
+    }
+    backpressure = value;
+    if (!locked) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    if (backpressure) {
+        readyResolver.Reset(isolate, newResolver(context));
+    } else {
+        readyResolver.Get(isolate)->Resolve(context, v8::Undefined(isolate)).Check();
+    }
+}
+
+TransformStream::TransformStream(
+    Environment* env,
+    Local<Object> obj,
+    std::unique_ptr<Transformer> transformer,
+    double writableHighWaterMark,
+    double readableHighWaterMark
+) :
+    env(env),
+    weakObject(obj, this),
+    internalField(this),
+    transformer(std::move(transformer))
+{
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    internalField.set(obj, 0);
+    auto readableObj = createObject(
+        context,
+        "ReadableStream",
+        READABLE_FIELD_COUNT
+    ).ToLocalChecked();
+    readable = new ReadableStream(env, readableObj, readableHighWaterMark);
+    readable->transformStream = this;
+    readable->started = true;
+    readableObj->SetInternalField(SOURCE_INDEX, obj);
+    auto writableObj = createObject(
+        context,
+        "WritableStream",
+        WRITABLE_FIELD_COUNT
+    ).ToLocalChecked();
+    writable = new WritableStream(env, writableObj, writableHighWaterMark);
+    writable->transformStream = this;
+    writableObj->SetInternalField(SOURCE_INDEX, obj);
+    obj->SetInternalField(READABLE_INDEX, readableObj);
+    obj->SetInternalField(WRITABLE_INDEX, writableObj);
+}
+
+bool TransformStream::enqueue(Local<Value> chunk) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    if (!readable->canEnqueue()) {
+        throwTypeError(isolate, "The readable side is not in a state that permits enqueue");
+        return false;
+    }
+    readable->enqueue(chunk);
+    if (readable->readRequests.empty() && readable->getDesiredSize() <= 0) {
+        backpressure = true;
+    }
+    return true;
+}
+
+void TransformStream::error(Local<Value> reason) {
+    pendingChunk.Reset();
+    readable->error(reason);
+    writable->error(reason);
+}
+
+void TransformStream::terminate() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    readable->close();
+    pendingChunk.Reset();
+    writable->error(newTypeError(isolate, "The stream has been terminated"));
+}
+
+void TransformStream::write(Local<Value> chunk) {
+    if (backpressure) {
+        pendingChunk.Reset(env->getIsolate(), chunk);
+        return;
+    }
+    runTransform(chunk);
+}
+
+void TransformStream::close() {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    TryCatch tryCatch(isolate);
+    if (transformer != nullptr) {
+        if (!transformer->flush(this)) {
+            error(tryCatch.Exception());
+            return;
+        }
+        readable->close();
+        writable->onCloseSettled();
+        return;
+    }
+    auto obj = weakObject.get();
+    Local<Value> argv[] = {getField(obj, TRANSFORM_CONTROLLER_INDEX)};
+    Local<Value> result;
+    if (!callMethod(context, getField(obj, SOURCE_INDEX), "flush", 1, argv, result)) {
+        error(tryCatch.Exception());
+        return;
+    }
+    thenWith(context, result, onFlushFulfilled, onTransformRejected, obj);
+}
+
+void TransformStream::abort(Local<Value> reason) {
+    error(reason);
+}
+
+void TransformStream::cancel(Local<Value> reason) {
+    pendingChunk.Reset();
+    writable->error(reason);
+}
+
+void TransformStream::onPull() {
+    backpressure = false;
+    if (pendingChunk.IsEmpty()) {
+        return;
+    }
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto chunk = pendingChunk.Get(isolate);
+    pendingChunk.Reset();
+    runTransform(chunk);
+}
+
+void TransformStream::runTransform(Local<Value> chunk) {
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    TryCatch tryCatch(isolate);
+    if (transformer != nullptr) {
+        if (!transformer->transform(this, chunk)) {
+            error(tryCatch.Exception());
+            return;
+        }
+        writable->onWriteSettled();
+        return;
+    }
+    auto obj = weakObject.get();
+    auto source = getField(obj, SOURCE_INDEX);
+    Local<Value> argv[] = {chunk, getField(obj, TRANSFORM_CONTROLLER_INDEX)};
+    Local<Value> result;
+    Local<Value> func;
+    if (
+        source->IsObject() &&
+        source.As<Object>()->Get(context, toV8String(isolate, "transform")).ToLocal(&func) &&
+        !func->IsUndefined()
+    ) {
+        if (!callMethod(context, source, "transform", 2, argv, result)) {
+            error(tryCatch.Exception());
+            return;
+        }
+        thenWith(context, result, onTransformFulfilled, onTransformRejected, obj);
+        return;
+    }
+    if (tryCatch.HasCaught() || !enqueue(chunk)) {
+        error(tryCatch.Exception());
+        return;
+    }
+    writable->onWriteSettled();
+}
+
+void exposeStreams(Local<Context> context, ExposedScope exposedScope) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto instTmpl = funcTmpl->InstanceTemplate();
+        instTmpl->SetInternalFieldCount(READABLE_FIELD_COUNT);
+        auto exposedName = toV8String(isolate, "ReadableStream");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(newReadableStream);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "cancel", cancelReadable);
+        setFunction(isolate, protoTmpl, "getReader", getReader);
+        setFunction(isolate, protoTmpl, "pipeTo", pipeTo);
+        setFunction(isolate, protoTmpl, "pipeThrough", pipeThrough);
+        setFunction(isolate, protoTmpl, "values", getIterator);
+        protoTmpl->Set(
+            v8::Symbol::GetAsyncIterator(isolate),
+            FunctionTemplate::New(isolate, getIterator),
+            v8::DontEnum
+        );
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "locked", {getReadableLocked});
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto instTmpl = funcTmpl->InstanceTemplate();
+        instTmpl->SetInternalFieldCount(1);
+        auto exposedName = toV8String(isolate, "ReadableStreamDefaultReader");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(newReader);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "read", readerRead);
+        setFunction(isolate, protoTmpl, "releaseLock", readerReleaseLock);
+        setFunction(isolate, protoTmpl, "cancel", readerCancel);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "closed", {getReaderClosed});
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto exposedName = toV8String(isolate, "ReadableStreamDefaultController");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(illegalConstructor);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "enqueue", controllerEnqueue);
+        setFunction(isolate, protoTmpl, "close", controllerClose);
+        setFunction(isolate, protoTmpl, "error", controllerError);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "desiredSize", {getControllerDesiredSize});
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto instTmpl = funcTmpl->InstanceTemplate();
+        instTmpl->SetInternalFieldCount(WRITABLE_FIELD_COUNT);
+        auto exposedName = toV8String(isolate, "WritableStream");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(newWritableStream);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "abort", abortWritable);
+        setFunction(isolate, protoTmpl, "close", closeWritable);
+        setFunction(isolate, protoTmpl, "getWriter", getWriter);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "locked", {getWritableLocked});
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto instTmpl = funcTmpl->InstanceTemplate();
+        instTmpl->SetInternalFieldCount(1);
+        auto exposedName = toV8String(isolate, "WritableStreamDefaultWriter");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(newWriter);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "write", writerWrite);
+        setFunction(isolate, protoTmpl, "close", writerClose);
+        setFunction(isolate, protoTmpl, "abort", writerAbort);
+        setFunction(isolate, protoTmpl, "releaseLock", writerReleaseLock);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "ready", {getWriterReady});
+        defineAccessor(context, proto, "closed", {getWriterClosed});
+        defineAccessor(context, proto, "desiredSize", {getWriterDesiredSize});
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto exposedName = toV8String(isolate, "WritableStreamDefaultController");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(illegalConstructor);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "error", writableControllerError);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto instTmpl = funcTmpl->InstanceTemplate();
+        instTmpl->SetInternalFieldCount(TransformStream::FIELD_COUNT);
+        auto exposedName = toV8String(isolate, "TransformStream");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(newTransformStream);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(context, proto, "readable", {getTransformReadable});
+        defineAccessor(context, proto, "writable", {getTransformWritable});
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+    {
+        auto funcTmpl = FunctionTemplate::New(isolate);
+        auto protoTmpl = funcTmpl->PrototypeTemplate();
+        auto exposedName = toV8String(isolate, "TransformStreamDefaultController");
+        funcTmpl->SetClassName(exposedName);
+        funcTmpl->SetCallHandler(illegalConstructor);
+        setToStringTag(isolate, protoTmpl, exposedName);
+        setFunction(isolate, protoTmpl, "enqueue", transformControllerEnqueue);
+        setFunction(isolate, protoTmpl, "error", transformControllerError);
+        setFunction(isolate, protoTmpl, "terminate", transformControllerTerminate);
+        auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+        auto proto = getPrototypeOf(context, func).ToLocalChecked();
+        defineAccessor(
+            context,
+            proto,
+            "desiredSize",
+            {getTransformControllerDesiredSize}
+        );
+        globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    }
+}
+
+void registerStreamsReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        returnUndefined,
+        onReadableStarted,
+        onReadableErrored,
+        onPullFulfilled,
+        onWritableStarted,
+        onWritableErrored,
+        onWriteFulfilled,
+        onCloseFulfilled,
+        onTransformFulfilled,
+        onTransformRejected,
+        onFlushFulfilled,
+        illegalConstructor,
+        newReadableStream,
+        getReadableLocked,
+        cancelReadable,
+        getReader,
+        onPipeSourceError,
+        onPipeDestError,
+        onPipeClosed,
+        onPipeReady,
+        onPipeRead,
+        pipeTo,
+        pipeThrough,
+        onIteratorRead,
+        onIteratorError,
+        iteratorNext,
+        iteratorReturn,
+        getIterator,
+        newReader,
+        readerRead,
+        readerReleaseLock,
+        readerCancel,
+        getReaderClosed,
+        controllerEnqueue,
+        controllerClose,
+        controllerError,
+        getControllerDesiredSize,
+        newWritableStream,
+        getWritableLocked,
+        abortWritable,
+        closeWritable,
+        getWriter,
+        newWriter,
+        writerWrite,
+        writerClose,
+        writerAbort,
+        writerReleaseLock,
+        getWriterReady,
+        getWriterClosed,
+        getWriterDesiredSize,
+        writableControllerError,
+        newTransformStream,
+        getTransformReadable,
+        getTransformWritable,
+        transformControllerEnqueue,
+        transformControllerError,
+        transformControllerTerminate,
+        getTransformControllerDesiredSize
+    });
+}
+
+}
@@ -0,0 +1,219 @@
+#ifndef KUN_WEB_STREAMS_H
+#define KUN_WEB_STREAMS_H
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "v8.h"
+#include "env/environment.h"
+#include "util/constants.h"
+#include "util/internal_field.h"
+#include "util/weak_object.h"
+
+namespace kun::web {
+
+class TransformStream;
+
+enum class StreamState {
+    OPEN = 0,
+    CLOSED,
+    ERRORED
+};
+
+class Transformer {
+public:
+    Transformer(const Transformer&) = delete;
+
+    Transformer& operator=(const Transformer&) = delete;
+
+    Transformer(Transformer&&) = delete;
+
+    Transformer& operator=(Transformer&&) = delete;
+
+    Transformer() = default;
+
+    virtual ~Transformer() = default;
+
+    virtual bool transform(TransformStream* stream, v8::Local<v8::Value> chunk) = 0;
+
+    virtual bool flush(TransformStream* stream) = 0;
+};
+
+class ReadableStream {
+public:
+    ReadableStream(Environment* env, v8::Local<v8::Object> obj, double highWaterMark) :
+        env(env),
+        weakObject(obj, this),
+        internalField(this),
+        highWaterMark(highWaterMark)
+    {
+        internalField.set(obj, 0);
+    }
+
+    ~ReadableStream() = default;
+
+    double getDesiredSize() const {
+        return highWaterMark - static_cast<double>(queue.size());
+    }
+
+    bool canEnqueue() const {
+        return state == StreamState::OPEN && !closeRequested;
+    }
+
+    void start(v8::Local<v8::Value> result);
+
+    void enqueue(v8::Local<v8::Value> chunk);
+
+    void close();
+
+    void error(v8::Local<v8::Value> reason);
+
+    void read(v8::Local<v8::Promise::Resolver> resolver);
+
+    v8::Local<v8::Promise> cancel(v8::Local<v8::Value> reason);
+
+    void acquireReader();
+
+    void releaseReader();
+
+    void pullIfNeeded();
+
+    void onPullSettled();
+
+    Environment* env;
+    WeakObject<ReadableStream> weakObject;
+    InternalField<ReadableStream> internalField;
+    TransformStream* transformStream{nullptr};
+    std::deque<v8::Global<v8::Value>> queue;
+    std::deque<v8::Global<v8::Promise::Resolver>> readRequests;
+    v8::Global<v8::Value> storedError;
+    v8::Global<v8::Promise::Resolver> closedResolver;
+    double highWaterMark;
+    StreamState state{StreamState::OPEN};
+    bool started{false};
+    bool pulling{false};
+    bool pullAgain{false};
+    bool closeRequested{false};
+    bool locked{false};
+
+private:
+    void finishClose();
+};
+
+class WritableStream {
+public:
+    WritableStream(Environment* env, v8::Local<v8::Object> obj, double highWaterMark) :
+        env(env),
+        weakObject(obj, this),
+        internalField(this),
+        highWaterMark(highWaterMark)
+    {
+        internalField.set(obj, 0);
+    }
+
+    ~WritableStream() = default;
+
+    double getDesiredSize() const {
+        return highWaterMark - static_cast<double>(writeRequests.size());
+    }
+
+    bool isClosing() const {
+        return state == StreamState::OPEN && !closeResolver.IsEmpty();
+    }
+
+    void start(v8::Local<v8::Value> result);
+
+    void write(v8::Local<v8::Value> chunk, v8::Local<v8::Promise::Resolver> resolver);
+
+    void close(v8::Local<v8::Promise::Resolver> resolver);
+
+    void error(v8::Local<v8::Value> reason);
+
+    v8::Local<v8::Promise> abort(v8::Local<v8::Value> reason);
+
+    void acquireWriter();
+
+    void releaseWriter();
+
+    void advanceQueue();
+
+    void onWriteSettled();
+
+    void onCloseSettled();
+
+    v8::Local<v8::Promise> getReady();
+
+    Environment* env;
+    WeakObject<WritableStream> weakObject;
+    InternalField<WritableStream> internalField;
+    TransformStream* transformStream{nullptr};
+    std::deque<v8::Global<v8::Value>> writeRequests;
+    std::deque<v8::Global<v8::Promise::Resolver>> writeResolvers;
+    v8::Global<v8::Promise::Resolver> closeResolver;
+    v8::Global<v8::Promise::Resolver> readyResolver;
+    v8::Global<v8::Promise::Resolver> closedResolver;
+    v8::Global<v8::Value> storedError;
+    double highWaterMark;
+    StreamState state{StreamState::OPEN};
+    bool started{false};
+    bool inFlight{false};
+    bool backpressure{false};
+    bool locked{false};
+
+private:
+    void updateBackpressure();
+};
+
+class TransformStream {
+public:
+    TransformStream(
+        Environment* env,
+        v8::Local<v8::Object> obj,
+        std::unique_ptr<Transformer> transformer,
+        double writableHighWaterMark,
+        double readableHighWaterMark
+    );
+
+    ~TransformStream() = default;
+
+    static constexpr int FIELD_COUNT = 5;
+
+    bool enqueue(v8::Local<v8::Value> chunk);
+
+    void error(v8::Local<v8::Value> reason);
+
+    void terminate();
+
+    void write(v8::Local<v8::Value> chunk);
+
+    void close();
+
+    void abort(v8::Local<v8::Value> reason);
+
+    void cancel(v8::Local<v8::Value> reason);
+
+    void onPull();
+
+    Environment* env;
+    WeakObject<TransformStream> weakObject;
+    InternalField<TransformStream> internalField;
+    std::unique_ptr<Transformer> transformer;
+    ReadableStream* readable;
+    WritableStream* writable;
+    v8::Global<v8::Value> pendingChunk;
+    bool backpressure{true};
+
+private:
+    void runTransform(v8::Local<v8::Value> chunk);
+};
+
+void exposeStreams(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerStreamsReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
@@ -0,0 +1,260 @@
+#include "web/structured_clone.h"
+
+#include "util/bstring.h"
+#include "util/js_utils.h"
+#include "util/v8_utils.h"
+
+KUN_V8_USINGS;
+
+using v8::Maybe;
+using v8::SharedArrayBuffer;
+using v8::ValueDeserializer;
+using v8::ValueSerializer;
+using kun::BString;
+using kun::JS;
+using kun::web::SerializedData;
+using kun::web::deserializeValue;
+using kun::web::getTransferList;
+using kun::web::serializeValue;
+using kun::util::addReferences;
+using kun::util::checkFuncArgs;
+using kun::util::fromObject;
+using kun::util::newInstance;
+using kun::util::setFunction;
+using kun::util::throwTypeError;
+using kun::util::toBString;
+
+namespace {
+
+void throwDataCloneError(Local<Context> context, const BString& message) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    Local<Object> exception;
+    if (newInstance(context, "DOMException", message, "DataCloneError").ToLocal(&exception)) {
+        isolate->ThrowException(exception);
+    }
+}
+
+class SerializerDelegate : public ValueSerializer::Delegate {
+public:
+    SerializerDelegate(const SerializerDelegate&) = delete;
+
+    SerializerDelegate& operator=(const SerializerDelegate&) = delete;
+
+    SerializerDelegate(SerializerDelegate&&) = delete;
+
+    SerializerDelegate& operator=(SerializerDelegate&&) = delete;
+
+    SerializerDelegate(Local<Context> context, SerializedData& serializedData) :
+        context(context),
+        serializedData(serializedData)
+    {
+
+    }
+
+    ~SerializerDelegate() = default;
+
+    void ThrowDataCloneError(Local<String> message) override {
+        throwDataCloneError(context, toBString(context, message));
+    }
+
+    Maybe<uint32_t> GetSharedArrayBufferId(
+        Isolate* isolate,
+        Local<SharedArrayBuffer> sharedArrayBuffer
+    ) override {
+        auto store = sharedArrayBuffer->GetBackingStore();
+        auto& sharedArrayBuffers = serializedData.sharedArrayBuffers;
+        const auto n = static_cast<uint32_t>(sharedArrayBuffers.size());
+        for (uint32_t i = 0; i < n; i++) {
+            if (sharedArrayBuffers[i] == store) {
+                return v8::Just(i);
+            }
+        }
+        sharedArrayBuffers.emplace_back(std::move(store));
+        return v8::Just(n);
+    }
+
+private:
+    Local<Context> context;
+    SerializedData& serializedData;
+};
+
+class DeserializerDelegate : public ValueDeserializer::Delegate {
+public:
+    DeserializerDelegate(const DeserializerDelegate&) = delete;
+
+    DeserializerDelegate& operator=(const DeserializerDelegate&) = delete;
+
+    DeserializerDelegate(DeserializerDelegate&&) = delete;
+
+    DeserializerDelegate& operator=(DeserializerDelegate&&) = delete;
+
+    explicit DeserializerDelegate(const SerializedData& serializedData) :
+        serializedData(serializedData)
+    {
+
+    }
+
+    ~DeserializerDelegate() = default;
+
+    MaybeLocal<SharedArrayBuffer> GetSharedArrayBufferFromId(
+        Isolate* isolate,
+        uint32_t id
+    ) override {
+        const auto& sharedArrayBuffers = serializedData.sharedArrayBuffers;
+        if (id >= sharedArrayBuffers.size()) {
+            return MaybeLocal<SharedArrayBuffer>();
+        }
+        return SharedArrayBuffer::New(isolate, sharedArrayBuffers[id]);
+    }
+
+private:
+    const SerializedData& serializedData;
+};
+
+void structuredClone(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Any, JS::Optional | JS::Object>(info)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    std::vector<Local<ArrayBuffer>> transferList;
+    if (info.Length() > 1 && !getTransferList(context, info[1], transferList)) {
+        return;
+    }
+    SerializedData serializedData;
+    if (!serializeValue(context, info[0], transferList, serializedData)) {
+        return;
+    }
+    Local<Value> value;
+    if (deserializeValue(context, serializedData).ToLocal(&value)) {
+        info.GetReturnValue().Set(value);
+    }
+}
+
+}
+
+namespace kun::web {
+
+bool getTransferList(
+    Local<Context> context,
+    Local<Value> value,
+    std::vector<Local<ArrayBuffer>>& transferList
+) {
+    auto isolate = context->GetIsolate();
+    if (value.IsEmpty() || value->IsNullOrUndefined()) {
+        return true;
+    }
+    if (!value->IsArray()) {
+        if (!value->IsObject()) {
+            throwTypeError(isolate, "The transfer list must be an array");
+            return false;
+        }
+        if (!fromObject(context, value.As<Object>(), "transfer", value)) {
+            return false;
+        }
+        if (value->IsUndefined()) {
+            return true;
+        }
+        if (!value->IsArray()) {
+            throwTypeError(isolate, "'transfer' must be an array");
+            return false;
+        }
+    }
+    auto arr = value.As<Array>();
+    auto len = arr->Length();
+    transferList.reserve(len);
+    for (uint32_t i = 0; i < len; i++) {
+        Local<Value> item;
+        if (!arr->Get(context, i).ToLocal(&item)) {
+            return false;
+        }
+        if (!item->IsArrayBuffer()) {
+            throwDataCloneError(context, "Only ArrayBuffer objects can be transferred");
+            return false;
+        }
+        auto arrBuf = item.As<ArrayBuffer>();
+        if (!arrBuf->IsDetachable() || arrBuf->WasDetached()) {
+            throwDataCloneError(context, "ArrayBuffer is detached or not detachable");
+            return false;
+        }
+        for (const auto& transferred : transferList) {
+            if (transferred == arrBuf) {
+                throwDataCloneError(context, "ArrayBuffer is duplicated in the transfer list");
+                return false;
+            }
+        }
+        transferList.emplace_back(arrBuf);
+    }
+    return true;
+}
+
+bool serializeValue(
+    Local<Context> context,
+    Local<Value> value,
+    const std::vector<Local<ArrayBuffer>>& transferList,
+    SerializedData& serializedData
+) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    SerializerDelegate delegate(context, serializedData);
+    ValueSerializer serializer(isolate, &delegate);
+    serializer.WriteHeader();
+    const auto n = static_cast<uint32_t>(transferList.size());
+    for (uint32_t i = 0; i < n; i++) {
+        serializer.TransferArrayBuffer(i, transferList[i]);
+    }
+    if (!serializer.WriteValue(context, value).FromMaybe(false)) {
+        return false;
+    }
+    serializedData.arrayBuffers.reserve(n);
+    for (const auto& arrBuf : transferList) {
+        serializedData.arrayBuffers.emplace_back(arrBuf->GetBackingStore());
+        arrBuf->Detach(Local<Value>()).Check();
+    }
+    auto [data, size] = serializer.Release();
+    serializedData.data = data;
+    serializedData.size = size;
+    return true;
+}
+
+MaybeLocal<Value> deserializeValue(Local<Context> context, const SerializedData& serializedData) {
+    auto isolate = context->GetIsolate();
+    EscapableHandleScope handleScope(isolate);
+    DeserializerDelegate delegate(serializedData);
+    ValueDeserializer deserializer(
+        isolate,
+        serializedData.data,
+        serializedData.size,
+        &delegate
+    );
+    if (!deserializer.ReadHeader(context).FromMaybe(false)) {
+        return MaybeLocal<Value>();
+    }
+    const auto& arrayBuffers = serializedData.arrayBuffers;
+    const auto n = static_cast<uint32_t>(arrayBuffers.size());
+    for (uint32_t i = 0; i < n; i++) {
+        deserializer.TransferArrayBuffer(i, ArrayBuffer::New(isolate, arrayBuffers[i]));
+    }
+    Local<Value> value;
+    if (!deserializer.ReadValue(context).ToLocal(&value)) {
+        return MaybeLocal<Value>();
+    }
+    return handleScope.Escape(value);
+}
+
+void exposeStructuredClone(Local<Context> context, ExposedScope exposedScope) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto globalThis = context->Global();
+    setFunction(context, globalThis, "structuredClone", structuredClone);
+}
+
+void registerStructuredCloneReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        structuredClone
+    });
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef KUN_WEB_STRUCTURED_CLONE_H
+#define KUN_WEB_STRUCTURED_CLONE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <vector>
+
+#include "v8.h"
+#include "util/constants.h"
+
+namespace kun::web {
+
+class SerializedData {
+public:
+    SerializedData(const SerializedData&) = delete;
+
+    SerializedData& operator=(const SerializedData&) = delete;
+
+    SerializedData(SerializedData&&) = delete;
+
+    SerializedData& operator=(SerializedData&&) = delete;
+
+    SerializedData() = default;
+
+    ~SerializedData() {
+        if (data != nullptr) {
+            ::free(data);
+        }
+    }
+
+    uint8_t* data{nullptr};
+    size_t size{0};
+    std::vector<std::shared_ptr<v8::BackingStore>> arrayBuffers;
+    std::vector<std::shared_ptr<v8::BackingStore>> sharedArrayBuffers;
+};
+
+bool getTransferList(
+    v8::Local<v8::Context> context,
+    v8::Local<v8::Value> value,
+    std::vector<v8::Local<v8::ArrayBuffer>>& transferList
+);
+
+bool serializeValue(
+    v8::Local<v8::Context> context,
+    v8::Local<v8::Value> value,
+    const std::vector<v8::Local<v8::ArrayBuffer>>& transferList,
+    SerializedData& serializedData
+);
+
+v8::MaybeLocal<v8::Value> deserializeValue(
+    v8::Local<v8::Context> context,
+    const SerializedData& serializedData
+);
+
+void exposeStructuredClone(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerStructuredCloneReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
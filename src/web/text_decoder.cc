@@ -2,10 +2,14 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include "util/js_utils.h"
 #include "util/result.h"
 #include "util/sys_err.h"
+#include "util/utf8.h"
 #include "util/v8_utils.h"
 
 KUN_V8_USINGS;
@@ -18,6 +22,8 @@ using kun::JS;
 using kun::Result;
 using kun::SysErr;
 using kun::web::TextDecoder;
+using kun::web::getBufferSource;
+using kun::util::addReferences;
 using kun::util::checkFuncArgs;
 using kun::util::defineAccessor;
 using kun::util::fromInternal;
@@ -45,9 +51,10 @@ Result<size_t> decodeUtf8(BString& result, const BString& str, const BString& er
         const unsigned char u = *p++;
         if (bytesNeeded == 0) {
             if (u <= 0x7f) {
-                char s[] = {static_cast<char>(u)};
-                result.append(s, 1);
-                bytesRead += 1;
+                auto n = 1 + kun::findNonAscii(p, end - p);
+                result.append(p - 1, n);
+                bytesRead += n;
+                p += n - 1;
                 continue;
             }
             if (u >= 0xc2 && u <= 0xdf) {
@@ -73,6 +80,7 @@ Result<size_t> decodeUtf8(BString& result, const BString& str, const BString& er
                     return SysErr(SysErr::INVALID_CHARSET);
                 }
                 result += "\xef\xbf\xbd";
+                bytesRead += 1;
             }
             continue;
         }
@@ -103,6 +111,23 @@ Result<size_t> decodeUtf8(BString& result, const BString& str, const BString& er
     return bytesRead;
 }
 
+Local<String> newStringFromUtf8(Isolate* isolate, const char* data, size_t len, bool isAscii) {
+    if (isAscii) {
+        return String::NewFromOneByte(
+            isolate,
+            reinterpret_cast<const uint8_t*>(data),
+            v8::NewStringType::kNormal,
+            static_cast<int>(len)
+        ).ToLocalChecked();
+    }
+    return String::NewFromUtf8(
+        isolate,
+        data,
+        v8::NewStringType::kNormal,
+        static_cast<int>(len)
+    ).ToLocalChecked();
+}
+
 void newTextDecoder(const FunctionCallbackInfo<Value>& info) {
     auto isolate = info.GetIsolate();
     HandleScope handleScope(isolate);
@@ -139,7 +164,7 @@ void newTextDecoder(const FunctionCallbackInfo<Value>& info) {
     auto textDecoder = new TextDecoder(env, recv);
     textDecoder->encoding = "utf-8";
     if (fatal) {
-        textDecoder->errorMode = "fatal";
+        textDecoder->decoder.errorMode = "fatal";
     }
     textDecoder->ignoreBOM = ignoreBOM;
 }
@@ -160,17 +185,7 @@ void decode(const FunctionCallbackInfo<Value>& info) {
     char* data = nullptr;
     size_t nbytes = 0;
     if (argNum > 0) {
-        if (info[0]->IsArrayBuffer()) {
-            auto arrBuf = info[0].As<ArrayBuffer>();
-            data = static_cast<char*>(arrBuf->Data());
-            nbytes = arrBuf->ByteLength();
-        } else {
-            auto abv = info[0].As<ArrayBufferView>();
-            auto arrBuf = abv->Buffer();
-            auto offset = abv->ByteOffset();
-            data = static_cast<char*>(arrBuf->Data()) + offset;
-            nbytes = abv->ByteLength();
-        }
+        getBufferSource(info[0], data, nbytes);
     }
     bool stream = false;
     if (argNum > 1) {
@@ -182,47 +197,10 @@ void decode(const FunctionCallbackInfo<Value>& info) {
     if (textDecoder == nullptr) {
         return;
     }
-    if (!textDecoder->doNotFlush) {
-        textDecoder->ioQueue.resize(0);
-    }
-    textDecoder->doNotFlush = stream;
-    if (data == nullptr || nbytes == 0) {
-        info.GetReturnValue().Set(String::Empty(isolate));
-        return;
+    Local<String> result;
+    if (textDecoder->decoder.decode(isolate, data, nbytes, stream).ToLocal(&result)) {
+        info.GetReturnValue().Set(result);
     }
-    const auto& errorMode = textDecoder->errorMode;
-    auto& ioQueue = textDecoder->ioQueue;
-    BString result;
-    result.reserve(nbytes + (nbytes >> 2));
-    auto p = data;
-    auto end = data + nbytes;
-    if (!ioQueue.empty()) {
-        const auto ioQueueLen = ioQueue.length();
-        BString str;
-        str += ioQueue;
-        str.append(data, nbytes >= 8 ? 8 : nbytes);
-        ioQueue.resize(0);
-        if (auto r = decodeUtf8(result, str, errorMode)) {
-            p += r.unwrap() - ioQueueLen;
-        } else {
-            throwTypeError(isolate, "The encoded data is invalid");
-            return;
-        }
-    }
-    if (p < end) {
-        auto str = BString::view(p, end - p);
-        if (auto r = decodeUtf8(result, str, errorMode)) {
-            p += r.unwrap();
-        } else {
-            throwTypeError(isolate, "The encoded data is invalid");
-            return;
-        }
-    }
-    if (p < end) {
-        ioQueue.append(p, end - p);
-    }
-    auto v8Str = toV8String(isolate, result);
-    info.GetReturnValue().Set(v8Str);
 }
 
 void getEncoding(const FunctionCallbackInfo<Value>& info) {
@@ -245,7 +223,7 @@ void getFatal(const FunctionCallbackInfo<Value>& info) {
     if (textDecoder == nullptr) {
         return;
     }
-    auto fatal = textDecoder->errorMode == "fatal";
+    auto fatal = textDecoder->decoder.errorMode == "fatal";
     info.GetReturnValue().Set(fatal);
 }
 
@@ -264,6 +242,99 @@ void getIgnoreBOM(const FunctionCallbackInfo<Value>& info) {
 
 namespace kun::web {
 
+MaybeLocal<String> Utf8Decoder::decode(
+    Isolate* isolate,
+    const char* data,
+    size_t nbytes,
+    bool stream
+) {
+    EscapableHandleScope handleScope(isolate);
+    if (!doNotFlush) {
+        ioQueue.resize(0);
+    }
+    doNotFlush = stream;
+    auto v8Str = String::Empty(isolate);
+    auto p = data;
+    auto end = data + nbytes;
+    if (!ioQueue.empty() && p < end) {
+        char buf[16];
+        const auto ioQueueLen = ioQueue.length();
+        const auto n = std::min(nbytes, sizeof(buf) - ioQueueLen);
+        memcpy(buf, ioQueue.data(), ioQueueLen);
+        memcpy(buf + ioQueueLen, data, n);
+        BString result;
+        auto r = decodeUtf8(result, BString::view(buf, ioQueueLen + n), errorMode);
+        if (!r) {
+            ioQueue.resize(0);
+            throwTypeError(isolate, "The encoded data is invalid");
+            return MaybeLocal<String>();
+        }
+        const auto bytesRead = r.unwrap();
+        if (bytesRead < ioQueueLen) {
+            ioQueue.append(data, n);
+            p += n;
+        } else {
+            ioQueue.resize(0);
+            p += bytesRead - ioQueueLen;
+        }
+        if (!result.empty()) {
+            v8Str = toV8String(isolate, result);
+        }
+    }
+    if (p < end) {
+        bool isAscii = false;
+        auto len = kun::validateUtf8(p, end - p, isAscii);
+        if (len > 0) {
+            auto prefix = newStringFromUtf8(isolate, p, len, isAscii);
+            v8Str = v8Str->Length() == 0 ? prefix : String::Concat(isolate, v8Str, prefix);
+            p += len;
+        }
+    }
+    if (p < end) {
+        BString result;
+        result.reserve(static_cast<size_t>(end - p) + 3);
+        auto str = BString::view(p, end - p);
+        if (auto r = decodeUtf8(result, str, errorMode)) {
+            p += r.unwrap();
+        } else {
+            throwTypeError(isolate, "The encoded data is invalid");
+            return MaybeLocal<String>();
+        }
+        if (!result.empty()) {
+            v8Str = String::Concat(isolate, v8Str, toV8String(isolate, result));
+        }
+    }
+    if (p < end) {
+        ioQueue.append(p, end - p);
+    }
+    if (!stream && !ioQueue.empty()) {
+        ioQueue.resize(0);
+        if (errorMode == "fatal") {
+            throwTypeError(isolate, "The encoded data is invalid");
+            return MaybeLocal<String>();
+        }
+        v8Str = String::Concat(isolate, v8Str, toV8String(isolate, "\xef\xbf\xbd"));
+    }
+    return handleScope.Escape(v8Str);
+}
+
+bool getBufferSource(Local<Value> value, char*& data, size_t& nbytes) {
+    if (value->IsArrayBuffer()) {
+        auto arrBuf = value.As<ArrayBuffer>();
+        data = static_cast<char*>(arrBuf->Data());
+        nbytes = arrBuf->ByteLength();
+        return true;
+    }
+    if (value->IsArrayBufferView()) {
+        auto abv = value.As<ArrayBufferView>();
+        auto arrBuf = abv->Buffer();
+        data = static_cast<char*>(arrBuf->Data()) + abv->ByteOffset();
+        nbytes = abv->ByteLength();
+        return true;
+    }
+    return false;
+}
+
 void exposeTextDecoder(Local<Context> context, ExposedScope exposedScope) {
     auto isolate = context->GetIsolate();
     HandleScope handleScope(isolate);
@@ -285,4 +356,14 @@ void exposeTextDecoder(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
 }
 
+void registerTextDecoderReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newTextDecoder,
+        decode,
+        getEncoding,
+        getFatal,
+        getIgnoreBOM
+    });
+}
+
 }
@@ -1,6 +1,11 @@
 #ifndef KUN_WEB_TEXT_DECODER_H
 #define KUN_WEB_TEXT_DECODER_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
 #include "v8.h"
 #include "env/environment.h"
 #include "util/bstring.h"
@@ -10,13 +15,38 @@
 
 namespace kun::web {
 
+class Utf8Decoder {
+public:
+    Utf8Decoder(const Utf8Decoder&) = delete;
+
+    Utf8Decoder& operator=(const Utf8Decoder&) = delete;
+
+    Utf8Decoder(Utf8Decoder&&) = delete;
+
+    Utf8Decoder& operator=(Utf8Decoder&&) = delete;
+
+    Utf8Decoder() : errorMode("replacement") {}
+
+    ~Utf8Decoder() = default;
+
+    v8::MaybeLocal<v8::String> decode(
+        v8::Isolate* isolate,
+        const char* data,
+        size_t nbytes,
+        bool stream
+    );
+
+    BString errorMode;
+    BString ioQueue;
+    bool doNotFlush{false};
+};
+
 class TextDecoder {
 public:
     TextDecoder(Environment* env, v8::Local<v8::Object> obj) :
         env(env),
         weakObject(obj, this),
-        internalField(this),
-        errorMode("replacement")
+        internalField(this)
     {
         internalField.set(obj, 0);
     }
@@ -24,15 +54,17 @@ public:
     Environment* env;
     WeakObject<TextDecoder> weakObject;
     InternalField<TextDecoder> internalField;
+    Utf8Decoder decoder;
     BString encoding;
-    BString errorMode;
-    BString ioQueue;
     bool ignoreBOM{false};
-    bool doNotFlush{false};
 };
 
+bool getBufferSource(v8::Local<v8::Value> value, char*& data, size_t& nbytes);
+
 void exposeTextDecoder(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerTextDecoderReferences(std::vector<intptr_t>& references);
+
 }
 
 #endif
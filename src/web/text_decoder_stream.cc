@@ -0,0 +1,205 @@
+#include "web/text_decoder_stream.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <utility>
+
+#include "util/js_utils.h"
+#include "util/v8_utils.h"
+
+KUN_V8_USINGS;
+
+using kun::Environment;
+using kun::InternalField;
+using kun::JS;
+using kun::web::TextDecoderStream;
+using kun::web::TransformStream;
+using kun::web::getBufferSource;
+using kun::util::addReferences;
+using kun::util::checkFuncArgs;
+using kun::util::defineAccessor;
+using kun::util::fromObject;
+using kun::util::getPrototypeOf;
+using kun::util::setToStringTag;
+using kun::util::throwRangeError;
+using kun::util::throwTypeError;
+using kun::util::toBString;
+using kun::util::toV8String;
+
+namespace {
+
+constexpr int FIELD_COUNT = TransformStream::FIELD_COUNT + 1;
+
+void newTextDecoderStream(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    if (
+        !checkFuncArgs<
+        JS::Optional | JS::Any,
+        JS::Optional | JS::Object
+        >(info)
+    ) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    const auto argNum = info.Length();
+    if (argNum > 0) {
+        auto label = toBString(context, info[0]);
+        if (!label.equalFold("utf-8") && !label.equalFold("utf8")) {
+            throwRangeError(isolate, "Only 'utf-8' is supported");
+            return;
+        }
+    }
+    bool fatal = false;
+    bool ignoreBOM = false;
+    if (argNum > 1) {
+        auto options = info[1].As<Object>();
+        fromObject(context, options, "fatal", fatal);
+        fromObject(context, options, "ignoreBOM", ignoreBOM);
+    }
+    auto env = Environment::from(context);
+    auto recv = info.This();
+    auto transformer = std::make_unique<TextDecoderStream>(recv);
+    if (fatal) {
+        transformer->decoder.errorMode = "fatal";
+    }
+    transformer->ignoreBOM = ignoreBOM;
+    auto stream = new TransformStream(env, recv, std::move(transformer), 1, 0);
+    stream->writable->start(v8::Undefined(isolate));
+}
+
+void getEncoding(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    if (InternalField<TextDecoderStream>::get(recv, TransformStream::FIELD_COUNT) == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(toV8String(isolate, "utf-8"));
+}
+
+void getFatal(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto textDecoderStream = InternalField<TextDecoderStream>::get(
+        recv,
+        TransformStream::FIELD_COUNT
+    );
+    if (textDecoderStream == nullptr) {
+        return;
+    }
+    auto fatal = textDecoderStream->decoder.errorMode == "fatal";
+    info.GetReturnValue().Set(fatal);
+}
+
+void getIgnoreBOM(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto textDecoderStream = InternalField<TextDecoderStream>::get(
+        recv,
+        TransformStream::FIELD_COUNT
+    );
+    if (textDecoderStream == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(textDecoderStream->ignoreBOM);
+}
+
+TransformStream* getTransformStream(Local<Object> recv) {
+    if (InternalField<TextDecoderStream>::get(recv, TransformStream::FIELD_COUNT) == nullptr) {
+        return nullptr;
+    }
+    return InternalField<TransformStream>::get(recv, 0);
+}
+
+void getReadable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getTransformStream(info.This());
+    if (stream == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(stream->readable->weakObject.get());
+}
+
+void getWritable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getTransformStream(info.This());
+    if (stream == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(stream->writable->weakObject.get());
+}
+
+}
+
+namespace kun::web {
+
+bool TextDecoderStream::transform(TransformStream* stream, Local<Value> chunk) {
+    auto isolate = stream->env->getIsolate();
+    HandleScope handleScope(isolate);
+    char* data = nullptr;
+    size_t nbytes = 0;
+    if (!getBufferSource(chunk, data, nbytes)) {
+        throwTypeError(isolate, "The chunk must be an 'ArrayBuffer' or 'ArrayBufferView'");
+        return false;
+    }
+    Local<String> str;
+    if (!decoder.decode(isolate, data, nbytes, true).ToLocal(&str)) {
+        return false;
+    }
+    return str->Length() == 0 || stream->enqueue(str);
+}
+
+bool TextDecoderStream::flush(TransformStream* stream) {
+    auto isolate = stream->env->getIsolate();
+    HandleScope handleScope(isolate);
+    Local<String> str;
+    if (!decoder.decode(isolate, nullptr, 0, false).ToLocal(&str)) {
+        return false;
+    }
+    return str->Length() == 0 || stream->enqueue(str);
+}
+
+void exposeTextDecoderStream(Local<Context> context, ExposedScope exposedScope) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto funcTmpl = FunctionTemplate::New(isolate);
+    auto protoTmpl = funcTmpl->PrototypeTemplate();
+    auto instTmpl = funcTmpl->InstanceTemplate();
+    instTmpl->SetInternalFieldCount(FIELD_COUNT);
+    auto exposedName = toV8String(isolate, "TextDecoderStream");
+    funcTmpl->SetClassName(exposedName);
+    funcTmpl->SetCallHandler(newTextDecoderStream);
+    setToStringTag(isolate, protoTmpl, exposedName);
+    auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+    auto proto = getPrototypeOf(context, func).ToLocalChecked();
+    defineAccessor(context, proto, "encoding", {getEncoding});
+    defineAccessor(context, proto, "fatal", {getFatal});
+    defineAccessor(context, proto, "ignoreBOM", {getIgnoreBOM});
+    defineAccessor(context, proto, "readable", {getReadable});
+    defineAccessor(context, proto, "writable", {getWritable});
+    auto globalThis = context->Global();
+    globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+}
+
+void registerTextDecoderStreamReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newTextDecoderStream,
+        getEncoding,
+        getFatal,
+        getIgnoreBOM,
+        getReadable,
+        getWritable
+    });
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef KUN_WEB_TEXT_DECODER_STREAM_H
+#define KUN_WEB_TEXT_DECODER_STREAM_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "v8.h"
+#include "util/constants.h"
+#include "util/internal_field.h"
+#include "web/streams.h"
+#include "web/text_decoder.h"
+
+namespace kun::web {
+
+class TextDecoderStream : public Transformer {
+public:
+    TextDecoderStream(const TextDecoderStream&) = delete;
+
+    TextDecoderStream& operator=(const TextDecoderStream&) = delete;
+
+    TextDecoderStream(TextDecoderStream&&) = delete;
+
+    TextDecoderStream& operator=(TextDecoderStream&&) = delete;
+
+    explicit TextDecoderStream(v8::Local<v8::Object> obj) : internalField(this) {
+        internalField.set(obj, TransformStream::FIELD_COUNT);
+    }
+
+    ~TextDecoderStream() override = default;
+
+    bool transform(TransformStream* stream, v8::Local<v8::Value> chunk) override;
+
+    bool flush(TransformStream* stream) override;
+
+    InternalField<TextDecoderStream> internalField;
+    Utf8Decoder decoder;
+    bool ignoreBOM{false};
+};
+
+void exposeTextDecoderStream(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerTextDecoderStreamReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
@@ -1,12 +1,19 @@
 #include "web/text_encoder.h"
 
+#include <string.h>
+
+#include <utility>
+
 #include "util/js_utils.h"
+#include "util/utf8.h"
 #include "util/v8_utils.h"
 
 KUN_V8_USINGS;
 
 using v8::Name;
 using kun::JS;
+using kun::web::encodeUtf8;
+using kun::util::addReferences;
 using kun::util::checkFuncArgs;
 using kun::util::defineAccessor;
 using kun::util::getPrototypeOf;
@@ -17,6 +24,58 @@ using kun::util::toV8String;
 
 namespace {
 
+void freeBackingStore(void* data, size_t len, void* allocator) {
+    static_cast<ArrayBuffer::Allocator*>(allocator)->Free(data, len);
+}
+
+Local<Uint8Array> newUint8Array(Isolate* isolate, size_t len, char*& data) {
+    auto allocator = isolate->GetArrayBufferAllocator();
+    data = static_cast<char*>(allocator->AllocateUninitialized(len));
+    if (data == nullptr) {
+        auto arrBuf = ArrayBuffer::New(isolate, len);
+        data = static_cast<char*>(arrBuf->Data());
+        return Uint8Array::New(arrBuf, 0, len);
+    }
+    auto store = ArrayBuffer::NewBackingStore(data, len, freeBackingStore, allocator);
+    auto arrBuf = ArrayBuffer::New(isolate, std::move(store));
+    return Uint8Array::New(arrBuf, 0, len);
+}
+
+Local<Uint8Array> encodeOneByte(Isolate* isolate, Local<String> input) {
+    const auto len = static_cast<size_t>(input->Length());
+    char* data = nullptr;
+    auto u8Arr = newUint8Array(isolate, len, data);
+    input->WriteOneByte(
+        isolate,
+        reinterpret_cast<uint8_t*>(data),
+        0,
+        -1,
+        String::NO_NULL_TERMINATION
+    );
+    auto asciiLen = kun::findNonAscii(data, len);
+    if (asciiLen == len) {
+        return u8Arr;
+    }
+    size_t extra = 0;
+    for (auto i = asciiLen; i < len; i++) {
+        extra += static_cast<unsigned char>(data[i]) >> 7;
+    }
+    char* out = nullptr;
+    auto result = newUint8Array(isolate, len + extra, out);
+    memcpy(out, data, asciiLen);
+    out += asciiLen;
+    for (auto i = asciiLen; i < len; i++) {
+        auto c = static_cast<unsigned char>(data[i]);
+        if (c < 0x80) {
+            *out++ = static_cast<char>(c);
+        } else {
+            *out++ = static_cast<char>(0xc0 | (c >> 6));
+            *out++ = static_cast<char>(0x80 | (c & 0x3f));
+        }
+    }
+    return result;
+}
+
 void newTextEncoder(const FunctionCallbackInfo<Value>& info) {
     auto isolate = info.GetIsolate();
     HandleScope handleScope(isolate);
@@ -33,36 +92,14 @@ void encode(const FunctionCallbackInfo<Value>& info) {
     }
     auto context = isolate->GetCurrentContext();
     Local<String> input;
-    int inputLen = 0;
-    if (info.Length() > 0) {
-        if (info[0]->ToString(context).ToLocal(&input)) {
-            inputLen = input->Utf8Length(isolate);
-        } else {
-            throwTypeError(isolate, "Failed to convert value to 'string'");
-            return;
-        }
-    }
-    if (input.IsEmpty() || inputLen <= 0) {
-        auto arrBuf = ArrayBuffer::New(isolate, 0);
-        auto u8Arr = Uint8Array::New(arrBuf, 0, 0);
-        info.GetReturnValue().Set(u8Arr);
+    if (info.Length() > 0 && !info[0]->ToString(context).ToLocal(&input)) {
+        throwTypeError(isolate, "Failed to convert value to 'string'");
         return;
     }
-    auto buf = new char[inputLen];
-    input->WriteUtf8(isolate, buf, inputLen);
-    auto store = ArrayBuffer::NewBackingStore(
-        buf,
-        inputLen,
-        [](void* data, size_t, void*) {
-            auto buf = static_cast<char*>(data);
-            delete[] buf;
-        },
-        nullptr
-    );
-    auto arrBuf = ArrayBuffer::New(isolate, std::move(store));
-    auto u8Arr = Uint8Array::New(arrBuf, 0, inputLen);
-    isolate->AdjustAmountOfExternalAllocatedMemory(inputLen);
-    info.GetReturnValue().Set(u8Arr);
+    if (input.IsEmpty()) {
+        input = String::Empty(isolate);
+    }
+    info.GetReturnValue().Set(encodeUtf8(isolate, input));
 }
 
 void encodeInto(const FunctionCallbackInfo<Value>& info) {
@@ -112,6 +149,27 @@ void getEncoding(const FunctionCallbackInfo<Value>& info) {
 
 namespace kun::web {
 
+Local<Uint8Array> encodeUtf8(Isolate* isolate, Local<String> input) {
+    EscapableHandleScope handleScope(isolate);
+    char* data = nullptr;
+    if (input->Length() == 0) {
+        return handleScope.Escape(newUint8Array(isolate, 0, data));
+    }
+    if (input->IsOneByte()) {
+        return handleScope.Escape(encodeOneByte(isolate, input));
+    }
+    const auto inputLen = input->Utf8Length(isolate);
+    auto u8Arr = newUint8Array(isolate, inputLen, data);
+    input->WriteUtf8(
+        isolate,
+        data,
+        inputLen,
+        nullptr,
+        String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8
+    );
+    return handleScope.Escape(u8Arr);
+}
+
 void exposeTextEncoder(Local<Context> context, ExposedScope exposedScope) {
     auto isolate = context->GetIsolate();
     HandleScope handleScope(isolate);
@@ -129,4 +187,13 @@ void exposeTextEncoder(Local<Context> context, ExposedScope exposedScope) {
     globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
 }
 
+void registerTextEncoderReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newTextEncoder,
+        encode,
+        encodeInto,
+        getEncoding
+    });
+}
+
 }
@@ -1,13 +1,21 @@
 #ifndef KUN_WEB_TEXT_ENCODER_H
 #define KUN_WEB_TEXT_ENCODER_H
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "v8.h"
 #include "util/constants.h"
 
 namespace kun::web {
 
+v8::Local<v8::Uint8Array> encodeUtf8(v8::Isolate* isolate, v8::Local<v8::String> input);
+
 void exposeTextEncoder(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerTextEncoderReferences(std::vector<intptr_t>& references);
+
 }
 
 #endif
@@ -0,0 +1,172 @@
+#include "web/text_encoder_stream.h"
+
+#include <string.h>
+
+#include <memory>
+#include <utility>
+
+#include "util/v8_utils.h"
+#include "web/text_encoder.h"
+
+KUN_V8_USINGS;
+
+using kun::Environment;
+using kun::InternalField;
+using kun::web::TextEncoderStream;
+using kun::web::TransformStream;
+using kun::web::encodeUtf8;
+using kun::util::addReferences;
+using kun::util::defineAccessor;
+using kun::util::getPrototypeOf;
+using kun::util::setToStringTag;
+using kun::util::throwTypeError;
+using kun::util::toV8String;
+
+namespace {
+
+constexpr int FIELD_COUNT = TransformStream::FIELD_COUNT + 1;
+
+bool isHighSurrogate(uint16_t c) {
+    return c >= 0xd800 && c <= 0xdbff;
+}
+
+void newTextEncoderStream(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto env = Environment::from(context);
+    auto recv = info.This();
+    auto transformer = std::make_unique<TextEncoderStream>(recv);
+    auto stream = new TransformStream(env, recv, std::move(transformer), 1, 0);
+    stream->writable->start(v8::Undefined(isolate));
+}
+
+TransformStream* getTransformStream(Local<Object> recv) {
+    if (InternalField<TextEncoderStream>::get(recv, TransformStream::FIELD_COUNT) == nullptr) {
+        return nullptr;
+    }
+    return InternalField<TransformStream>::get(recv, 0);
+}
+
+void getEncoding(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (getTransformStream(info.This()) == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(toV8String(isolate, "utf-8"));
+}
+
+void getReadable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getTransformStream(info.This());
+    if (stream == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(stream->readable->weakObject.get());
+}
+
+void getWritable(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto stream = getTransformStream(info.This());
+    if (stream == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(stream->writable->weakObject.get());
+}
+
+}
+
+namespace kun::web {
+
+bool TextEncoderStream::transform(TransformStream* stream, Local<Value> chunk) {
+    auto isolate = stream->env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    Local<String> input;
+    if (!chunk->ToString(context).ToLocal(&input)) {
+        return false;
+    }
+    if (pendingHighSurrogate != 0) {
+        auto pending = String::NewFromTwoByte(
+            isolate,
+            &pendingHighSurrogate,
+            v8::NewStringType::kNormal,
+            1
+        ).ToLocalChecked();
+        input = String::Concat(isolate, pending, input);
+        pendingHighSurrogate = 0;
+    }
+    const auto len = input->Length();
+    if (len == 0) {
+        return true;
+    }
+    if (!input->IsOneByte()) {
+        uint16_t last = 0;
+        input->Write(isolate, &last, len - 1, 1, String::NO_NULL_TERMINATION);
+        if (isHighSurrogate(last)) {
+            pendingHighSurrogate = last;
+            if (len == 1) {
+                return true;
+            }
+            std::vector<uint16_t> units(static_cast<size_t>(len - 1));
+            input->Write(isolate, units.data(), 0, len - 1, String::NO_NULL_TERMINATION);
+            input = String::NewFromTwoByte(
+                isolate,
+                units.data(),
+                v8::NewStringType::kNormal,
+                len - 1
+            ).ToLocalChecked();
+        }
+    }
+    return stream->enqueue(encodeUtf8(isolate, input));
+}
+
+bool TextEncoderStream::flush(TransformStream* stream) {
+    if (pendingHighSurrogate == 0) {
+        return true;
+    }
+    auto isolate = stream->env->getIsolate();
+    HandleScope handleScope(isolate);
+    pendingHighSurrogate = 0;
+    auto arrBuf = ArrayBuffer::New(isolate, 3);
+    memcpy(arrBuf->Data(), "\xef\xbf\xbd", 3);
+    return stream->enqueue(Uint8Array::New(arrBuf, 0, 3));
+}
+
+void exposeTextEncoderStream(Local<Context> context, ExposedScope exposedScope) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto funcTmpl = FunctionTemplate::New(isolate);
+    auto protoTmpl = funcTmpl->PrototypeTemplate();
+    auto instTmpl = funcTmpl->InstanceTemplate();
+    instTmpl->SetInternalFieldCount(FIELD_COUNT);
+    auto exposedName = toV8String(isolate, "TextEncoderStream");
+    funcTmpl->SetClassName(exposedName);
+    funcTmpl->SetCallHandler(newTextEncoderStream);
+    setToStringTag(isolate, protoTmpl, exposedName);
+    auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+    auto proto = getPrototypeOf(context, func).ToLocalChecked();
+    defineAccessor(context, proto, "encoding", {getEncoding});
+    defineAccessor(context, proto, "readable", {getReadable});
+    defineAccessor(context, proto, "writable", {getWritable});
+    auto globalThis = context->Global();
+    globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+}
+
+void registerTextEncoderStreamReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newTextEncoderStream,
+        getEncoding,
+        getReadable,
+        getWritable
+    });
+}
+
+}
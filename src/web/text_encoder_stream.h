@@ -0,0 +1,45 @@
+#ifndef KUN_WEB_TEXT_ENCODER_STREAM_H
+#define KUN_WEB_TEXT_ENCODER_STREAM_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "v8.h"
+#include "util/constants.h"
+#include "util/internal_field.h"
+#include "web/streams.h"
+
+namespace kun::web {
+
+class TextEncoderStream : public Transformer {
+public:
+    TextEncoderStream(const TextEncoderStream&) = delete;
+
+    TextEncoderStream& operator=(const TextEncoderStream&) = delete;
+
+    TextEncoderStream(TextEncoderStream&&) = delete;
+
+    TextEncoderStream& operator=(TextEncoderStream&&) = delete;
+
+    explicit TextEncoderStream(v8::Local<v8::Object> obj) : internalField(this) {
+        internalField.set(obj, TransformStream::FIELD_COUNT);
+    }
+
+    ~TextEncoderStream() override = default;
+
+    bool transform(TransformStream* stream, v8::Local<v8::Value> chunk) override;
+
+    bool flush(TransformStream* stream) override;
+
+    InternalField<TextEncoderStream> internalField;
+    uint16_t pendingHighSurrogate{0};
+};
+
+void exposeTextEncoderStream(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerTextEncoderStreamReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "web/timers.h"
 
 #include "util/js_utils.h"
+#include "util/scope_guard.h"
 #include "util/utils.h"
 #include "util/v8_utils.h"
 
@@ -9,6 +10,7 @@ KUN_V8_USINGS;
 using kun::Environment;
 using kun::JS;
 using kun::WebTimer;
+using kun::util::addReferences;
 using kun::util::checkFuncArgs;
 using kun::util::fromObject;
 using kun::util::setFunction;
@@ -100,6 +102,16 @@ void clearInterval(const FunctionCallbackInfo<Value>& info) {
 namespace kun {
 
 void WebTimer::onReadable() {
+    auto env = this->env;
+    const auto repeat = this->repeat;
+    if (!repeat) {
+        env->removeWebTimer(id);
+    }
+    ON_SCOPE_EXIT {
+        if (!repeat) {
+            delete this;
+        }
+    };
     auto isolate = env->getIsolate();
     HandleScope handleScope(isolate);
     auto context = env->getContext();
@@ -139,10 +151,6 @@ void WebTimer::onReadable() {
             KUN_LOG_ERR("globalThis.eval is not defined");
         }
     }
-    if (!repeat) {
-        env->removeWebTimer(this->id);
-        delete this;
-    }
 }
 
 namespace web {
@@ -157,6 +165,15 @@ void exposeTimers(Local<Context> context, ExposedScope exposedScope) {
     setFunction(context, globalThis, "clearInterval", clearInterval);
 }
 
+void registerTimersReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        setTimeout,
+        clearTimeout,
+        setInterval,
+        clearInterval
+    });
+}
+
 }
 
 }
@@ -45,6 +45,8 @@ namespace web {
 
 void exposeTimers(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerTimersReferences(std::vector<intptr_t>& references);
+
 }
 
 }
@@ -6,9 +6,14 @@
 #include "web/dom_exception.h"
 #include "web/event.h"
 #include "web/event_target.h"
+#include "web/streams.h"
+#include "web/structured_clone.h"
 #include "web/text_decoder.h"
+#include "web/text_decoder_stream.h"
 #include "web/text_encoder.h"
+#include "web/text_encoder_stream.h"
 #include "web/timers.h"
+#include "web/worker.h"
 
 KUN_V8_USINGS;
 
@@ -21,9 +26,40 @@ void expose(Local<Context> context, ExposedScope exposedScope) {
     exposeConsole(context, exposedScope);
     exposeDOMException(context, exposedScope);
     exposeEvent(context, exposedScope);
+    exposeStreams(context, exposedScope);
+    exposeStructuredClone(context, exposedScope);
     exposeTextDecoder(context, exposedScope);
+    exposeTextDecoderStream(context, exposedScope);
     exposeTextEncoder(context, exposedScope);
+    exposeTextEncoderStream(context, exposedScope);
     exposeTimers(context, exposedScope);
+    exposeWorker(context, exposedScope);
+}
+
+void registerReferences(std::vector<intptr_t>& references) {
+    references.reserve(256);
+    registerEventTargetReferences(references);
+    registerAbortControllerReferences(references);
+    registerAbortSignalReferences(references);
+    registerConsoleReferences(references);
+    registerDOMExceptionReferences(references);
+    registerEventReferences(references);
+    registerStreamsReferences(references);
+    registerStructuredCloneReferences(references);
+    registerTextDecoderReferences(references);
+    registerTextDecoderStreamReferences(references);
+    registerTextEncoderReferences(references);
+    registerTextEncoderStreamReferences(references);
+    registerTimersReferences(references);
+    registerWorkerReferences(references);
+}
+
+void serialize(Local<Context> context) {
+    serializeConsole(context);
+}
+
+void deserialize(Local<Context> context) {
+    deserializeConsole(context);
 }
 
 }
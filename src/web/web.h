@@ -1,6 +1,10 @@
 #ifndef KUN_WEB_WEB_H
 #define KUN_WEB_WEB_H
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "v8.h"
 #include "util/constants.h"
 
@@ -8,6 +12,12 @@ namespace kun::web {
 
 void expose(v8::Local<v8::Context> context, ExposedScope exposedScope);
 
+void registerReferences(std::vector<intptr_t>& references);
+
+void serialize(v8::Local<v8::Context> context);
+
+void deserialize(v8::Local<v8::Context> context);
+
 }
 
 #endif
@@ -0,0 +1,611 @@
+#include "web/worker.h"
+
+#include "env/cmdline.h"
+#include "loop/async_request.h"
+#include "loop/event_loop.h"
+#include "sys/path.h"
+#include "util/js_utils.h"
+#include "util/v8_utils.h"
+#include "web/event.h"
+
+KUN_V8_USINGS;
+
+using v8::StackTrace;
+using v8::TryCatch;
+using kun::AsyncRequest;
+using kun::BString;
+using kun::Environment;
+using kun::InternalField;
+using kun::JS;
+using kun::web::Event;
+using kun::web::EventTarget;
+using kun::web::SerializedData;
+using kun::web::Worker;
+using kun::web::WorkerGlobalScope;
+using kun::web::WorkerState;
+using kun::web::deserializeValue;
+using kun::web::getTransferList;
+using kun::web::serializeValue;
+using kun::sys::cleanPath;
+using kun::sys::dirname;
+using kun::sys::isAbsolutePath;
+using kun::sys::joinPath;
+using kun::sys::pathExists;
+using kun::sys::toAbsolutePath;
+using kun::util::addReferences;
+using kun::util::checkFuncArgs;
+using kun::util::createObject;
+using kun::util::defineAccessor;
+using kun::util::fromObject;
+using kun::util::getPrototypeOf;
+using kun::util::inherit;
+using kun::util::newInstance;
+using kun::util::setFunction;
+using kun::util::setToStringTag;
+using kun::util::throwTypeError;
+using kun::util::toBString;
+using kun::util::toV8String;
+
+namespace {
+
+void runWorker(std::shared_ptr<WorkerState> state) {
+    {
+        Environment env(state->parentEnv->getCmdline());
+        env.runWorker(state);
+    }
+    state->exit();
+}
+
+void resolveWorkerMessages(Local<Context> context, AsyncRequest& req) {
+    auto globalScope = req.get<WorkerGlobalScope*>(0);
+    globalScope->receive();
+}
+
+void resolveParentMessages(Local<Context> context, AsyncRequest& req) {
+    auto worker = req.get<Worker*>(0);
+    worker->receive();
+}
+
+void resolveWorkerExit(Local<Context> context, AsyncRequest& req) {
+    auto worker = req.get<Worker*>(0);
+    worker->onExit();
+}
+
+void resolveWorkerStop(Local<Context> context, AsyncRequest& req) {
+    auto env = Environment::from(context);
+    env->getEventLoop()->stop();
+}
+
+void dispatchMessage(EventTarget* eventTarget, const SerializedData& message) {
+    auto env = eventTarget->env;
+    auto isolate = env->getIsolate();
+    HandleScope handleScope(isolate);
+    auto context = env->getContext();
+    Local<Value> data;
+    BString type = "message";
+    {
+        TryCatch tryCatch(isolate);
+        if (!deserializeValue(context, message).ToLocal(&data)) {
+            data = v8::Null(isolate);
+            type = "messageerror";
+        }
+    }
+    auto eventObj = newInstance(context, "Event", type).ToLocalChecked();
+    eventObj->DefineOwnProperty(
+        context,
+        toV8String(isolate, "data"),
+        data,
+        v8::ReadOnly
+    ).Check();
+    auto event = InternalField<Event>::get(eventObj, 0);
+    event->isTrusted = true;
+    eventTarget->dispatchEvent(event);
+}
+
+std::unique_ptr<SerializedData> serializeMessage(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    std::vector<Local<ArrayBuffer>> transferList;
+    if (info.Length() > 1 && !getTransferList(context, info[1], transferList)) {
+        return nullptr;
+    }
+    auto message = std::make_unique<SerializedData>();
+    if (!serializeValue(context, info[0], transferList, *message)) {
+        return nullptr;
+    }
+    return message;
+}
+
+BString resolveWorkerPath(Local<Context> context, const BString& specifier) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto path = specifier.startsWith("file://") ? specifier.substring(7) : specifier;
+    if (isAbsolutePath(path)) {
+        return cleanPath(path);
+    }
+    auto scriptName = StackTrace::CurrentScriptNameOrSourceURL(isolate);
+    if (!scriptName.IsEmpty() && scriptName->Length() > 0) {
+        auto referrerDir = dirname(toBString(context, scriptName));
+        return joinPath(referrerDir, path);
+    }
+    if (auto result = toAbsolutePath(path)) {
+        return result.unwrap();
+    }
+    return path;
+}
+
+WorkerGlobalScope* getWorkerGlobalScope(Local<Context> context) {
+    auto env = Environment::from(context);
+    auto state = env->getWorkerState();
+    return state != nullptr ? state->globalScope : nullptr;
+}
+
+void newWorker(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!info.IsConstructCall()) {
+        throwTypeError(isolate, "Please use the 'new' operator");
+        return;
+    }
+    if (!checkFuncArgs<JS::Any, JS::Optional | JS::Object>(info)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto env = Environment::from(context);
+    auto specifier = toBString(context, info[0]);
+    auto scriptPath = resolveWorkerPath(context, specifier);
+    if (!pathExists(scriptPath)) {
+        auto errStr = BString::format("Worker script not found '{}'", scriptPath);
+        throwTypeError(isolate, errStr);
+        return;
+    }
+    auto recv = info.This();
+    new Worker(env, recv, scriptPath);
+}
+
+void postMessage(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Any, JS::Optional | JS::Any>(info)) {
+        return;
+    }
+    auto recv = info.This();
+    auto worker = InternalField<Worker>::get(recv, 0);
+    if (worker == nullptr) {
+        return;
+    }
+    if (auto message = serializeMessage(info)) {
+        worker->postMessage(std::move(message));
+    }
+}
+
+void terminate(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto worker = InternalField<Worker>::get(recv, 0);
+    if (worker == nullptr) {
+        return;
+    }
+    worker->terminate();
+}
+
+void getOnmessage(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto worker = InternalField<Worker>::get(recv, 0);
+    if (worker == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(worker->getEventHandler("message"));
+}
+
+void setOnmessage(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Any>(info)) {
+        return;
+    }
+    auto recv = info.This();
+    auto worker = InternalField<Worker>::get(recv, 0);
+    if (worker == nullptr) {
+        return;
+    }
+    worker->setEventHandler("message", info[0]);
+}
+
+void getOnmessageerror(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto recv = info.This();
+    auto worker = InternalField<Worker>::get(recv, 0);
+    if (worker == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(worker->getEventHandler("messageerror"));
+}
+
+void setOnmessageerror(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Any>(info)) {
+        return;
+    }
+    auto recv = info.This();
+    auto worker = InternalField<Worker>::get(recv, 0);
+    if (worker == nullptr) {
+        return;
+    }
+    worker->setEventHandler("messageerror", info[0]);
+}
+
+void postMessageToParent(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Any, JS::Optional | JS::Any>(info)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto globalScope = getWorkerGlobalScope(context);
+    if (globalScope == nullptr) {
+        throwTypeError(isolate, "Illegal invocation");
+        return;
+    }
+    if (auto message = serializeMessage(info)) {
+        globalScope->state->postToParent(std::move(message));
+    }
+}
+
+void closeGlobalScope(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto globalScope = getWorkerGlobalScope(context);
+    if (globalScope == nullptr) {
+        throwTypeError(isolate, "Illegal invocation");
+        return;
+    }
+    globalScope->close();
+}
+
+void getGlobalOnmessage(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto globalScope = getWorkerGlobalScope(context);
+    if (globalScope == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(globalScope->getEventHandler("message"));
+}
+
+void setGlobalOnmessage(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Any>(info)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto globalScope = getWorkerGlobalScope(context);
+    if (globalScope == nullptr) {
+        return;
+    }
+    globalScope->onmessage(info[0]);
+}
+
+void getGlobalOnmessageerror(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto globalScope = getWorkerGlobalScope(context);
+    if (globalScope == nullptr) {
+        return;
+    }
+    info.GetReturnValue().Set(globalScope->getEventHandler("messageerror"));
+}
+
+void setGlobalOnmessageerror(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    if (!checkFuncArgs<JS::Any>(info)) {
+        return;
+    }
+    auto context = isolate->GetCurrentContext();
+    auto globalScope = getWorkerGlobalScope(context);
+    if (globalScope == nullptr) {
+        return;
+    }
+    globalScope->setEventHandler("messageerror", info[0]);
+}
+
+void forwardToGlobalScope(const FunctionCallbackInfo<Value>& info) {
+    auto isolate = info.GetIsolate();
+    HandleScope handleScope(isolate);
+    auto context = isolate->GetCurrentContext();
+    auto globalScope = getWorkerGlobalScope(context);
+    if (globalScope == nullptr) {
+        throwTypeError(isolate, "Illegal invocation");
+        return;
+    }
+    auto recv = globalScope->weakObject.get();
+    auto name = info.Data().As<String>();
+    Local<Function> func;
+    if (!fromObject(context, recv, name, func)) {
+        return;
+    }
+    const auto argc = info.Length();
+    std::vector<Local<Value>> argv;
+    argv.reserve(argc);
+    for (int i = 0; i < argc; i++) {
+        argv.emplace_back(info[i]);
+    }
+    Local<Value> result;
+    if (func->Call(context, recv, argc, argv.data()).ToLocal(&result)) {
+        info.GetReturnValue().Set(result);
+    }
+}
+
+void exposeWorkerGlobalScope(Local<Context> context) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto env = Environment::from(context);
+    auto state = env->getWorkerState();
+    auto obj = createObject(context, "EventTarget", 1).ToLocalChecked();
+    new WorkerGlobalScope(env, obj, state);
+    auto globalThis = context->Global();
+    globalThis->DefineOwnProperty(
+        context,
+        toV8String(isolate, "self"),
+        globalThis,
+        v8::DontEnum
+    ).Check();
+    setFunction(context, globalThis, "postMessage", postMessageToParent, v8::DontEnum);
+    setFunction(context, globalThis, "close", closeGlobalScope, v8::DontEnum);
+    for (auto name : {"addEventListener", "removeEventListener", "dispatchEvent"}) {
+        auto v8Name = toV8String(isolate, name);
+        globalThis->DefineOwnProperty(
+            context,
+            v8Name,
+            Function::New(context, forwardToGlobalScope, v8Name).ToLocalChecked(),
+            v8::DontEnum
+        ).Check();
+    }
+    defineAccessor(context, globalThis, "onmessage", {getGlobalOnmessage, setGlobalOnmessage});
+    defineAccessor(
+        context,
+        globalThis,
+        "onmessageerror",
+        {getGlobalOnmessageerror, setGlobalOnmessageerror}
+    );
+}
+
+}
+
+namespace kun::web {
+
+void WorkerState::postToWorker(std::unique_ptr<SerializedData> message) {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    if (terminated) {
+        return;
+    }
+    workerMessages.emplace_back(std::move(message));
+    if (workerEnv != nullptr && !workerNotified) {
+        workerNotified = true;
+        AsyncRequest req(nullptr, resolveWorkerMessages);
+        req.set(0, globalScope);
+        workerEnv->getEventLoop()->postAsyncRequest(std::move(req));
+    }
+}
+
+void WorkerState::postToParent(std::unique_ptr<SerializedData> message) {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    if (terminated || detached) {
+        return;
+    }
+    parentMessages.emplace_back(std::move(message));
+    if (!parentNotified) {
+        parentNotified = true;
+        AsyncRequest req(nullptr, resolveParentMessages);
+        req.set(0, worker);
+        parentEnv->getEventLoop()->postAsyncRequest(std::move(req));
+    }
+}
+
+MessageQueue WorkerState::takeWorkerMessages() {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    MessageQueue messages;
+    messages.swap(workerMessages);
+    workerNotified = false;
+    return messages;
+}
+
+MessageQueue WorkerState::takeParentMessages() {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    MessageQueue messages;
+    messages.swap(parentMessages);
+    parentNotified = false;
+    return messages;
+}
+
+bool WorkerState::start(Environment* env) {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    if (terminated) {
+        return false;
+    }
+    workerEnv = env;
+    if (!workerMessages.empty() && !workerNotified) {
+        workerNotified = true;
+        AsyncRequest req(nullptr, resolveWorkerMessages);
+        req.set(0, globalScope);
+        env->getEventLoop()->postAsyncRequest(std::move(req));
+    }
+    return true;
+}
+
+void WorkerState::stop() {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    workerEnv = nullptr;
+    globalScope = nullptr;
+    workerMessages.clear();
+}
+
+void WorkerState::exit() {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    if (detached) {
+        return;
+    }
+    AsyncRequest req(nullptr, resolveWorkerExit);
+    req.set(0, worker);
+    parentEnv->getEventLoop()->postAsyncRequest(std::move(req));
+}
+
+void WorkerState::terminate() {
+    std::lock_guard<std::mutex> lockGuard(mutex);
+    terminateLocked();
+}
+
+void WorkerState::shutdown() {
+    {
+        std::lock_guard<std::mutex> lockGuard(mutex);
+        detached = true;
+        terminateLocked();
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void WorkerState::terminateLocked() {
+    if (terminated) {
+        return;
+    }
+    terminated = true;
+    workerMessages.clear();
+    parentMessages.clear();
+    if (workerEnv != nullptr) {
+        workerEnv->getIsolate()->TerminateExecution();
+        AsyncRequest req(nullptr, resolveWorkerStop);
+        workerEnv->getEventLoop()->postAsyncRequest(std::move(req));
+    }
+}
+
+Worker::Worker(Environment* env, Local<Object> obj, const BString& scriptPath) :
+    EventTarget(env, obj, this),
+    state(std::make_shared<WorkerState>(env, this, scriptPath))
+{
+    weakObject.ref();
+    env->getEventLoop()->ref();
+    env->addWorker(state);
+    state->thread = std::thread(runWorker, state);
+}
+
+void Worker::receive() {
+    auto messages = state->takeParentMessages();
+    if (state->isTerminated()) {
+        return;
+    }
+    for (const auto& message : messages) {
+        dispatchMessage(this, *message);
+    }
+}
+
+void Worker::onExit() {
+    receive();
+    if (state->thread.joinable()) {
+        state->thread.join();
+    }
+    env->removeWorker(state.get());
+    env->getEventLoop()->unref();
+    weakObject.unref();
+}
+
+bool WorkerGlobalScope::addEventListener(const BString& type, EventListener&& listener) {
+    if (!EventTarget::addEventListener(type, std::move(listener))) {
+        return false;
+    }
+    if (type == "message") {
+        ref();
+    }
+    return true;
+}
+
+void WorkerGlobalScope::onmessage(Local<Value> value) {
+    setEventHandler("message", value);
+    if (!value.IsEmpty() && value->IsFunction()) {
+        ref();
+    }
+}
+
+void WorkerGlobalScope::receive() {
+    auto messages = state->takeWorkerMessages();
+    if (closed) {
+        return;
+    }
+    for (const auto& message : messages) {
+        dispatchMessage(this, *message);
+    }
+}
+
+void WorkerGlobalScope::close() {
+    if (closed) {
+        return;
+    }
+    closed = true;
+    env->getEventLoop()->stop();
+}
+
+void WorkerGlobalScope::ref() {
+    if (refed || closed) {
+        return;
+    }
+    refed = true;
+    env->getEventLoop()->ref();
+}
+
+void exposeWorker(Local<Context> context, ExposedScope exposedScope) {
+    auto isolate = context->GetIsolate();
+    HandleScope handleScope(isolate);
+    auto funcTmpl = FunctionTemplate::New(isolate);
+    auto protoTmpl = funcTmpl->PrototypeTemplate();
+    auto instTmpl = funcTmpl->InstanceTemplate();
+    instTmpl->SetInternalFieldCount(1);
+    auto exposedName = toV8String(isolate, "Worker");
+    funcTmpl->SetClassName(exposedName);
+    funcTmpl->SetCallHandler(newWorker);
+    setToStringTag(isolate, protoTmpl, exposedName);
+    setFunction(isolate, protoTmpl, "postMessage", postMessage);
+    setFunction(isolate, protoTmpl, "terminate", terminate);
+    auto func = funcTmpl->GetFunction(context).ToLocalChecked();
+    auto proto = getPrototypeOf(context, func).ToLocalChecked();
+    defineAccessor(context, proto, "onmessage", {getOnmessage, setOnmessage});
+    defineAccessor(context, proto, "onmessageerror", {getOnmessageerror, setOnmessageerror});
+    inherit(context, func, "EventTarget");
+    auto globalThis = context->Global();
+    globalThis->DefineOwnProperty(context, exposedName, func, v8::DontEnum).Check();
+    if (exposedScope == ExposedScope::WORKER) {
+        exposeWorkerGlobalScope(context);
+    }
+}
+
+void registerWorkerReferences(std::vector<intptr_t>& references) {
+    addReferences(references, {
+        newWorker,
+        postMessage,
+        terminate,
+        getOnmessage,
+        setOnmessage,
+        getOnmessageerror,
+        setOnmessageerror,
+        postMessageToParent,
+        closeGlobalScope,
+        getGlobalOnmessage,
+        setGlobalOnmessage,
+        getGlobalOnmessageerror,
+        setGlobalOnmessageerror,
+        forwardToGlobalScope
+    });
+}
+
+}
@@ -0,0 +1,143 @@
+#ifndef KUN_WEB_WORKER_H
+#define KUN_WEB_WORKER_H
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "v8.h"
+#include "env/environment.h"
+#include "util/bstring.h"
+#include "util/constants.h"
+#include "web/event_target.h"
+#include "web/structured_clone.h"
+
+namespace kun::web {
+
+class Worker;
+class WorkerGlobalScope;
+
+using MessageQueue = std::deque<std::unique_ptr<SerializedData>>;
+
+class WorkerState {
+public:
+    WorkerState(const WorkerState&) = delete;
+
+    WorkerState& operator=(const WorkerState&) = delete;
+
+    WorkerState(WorkerState&&) = delete;
+
+    WorkerState& operator=(WorkerState&&) = delete;
+
+    WorkerState(Environment* parentEnv, Worker* worker, const BString& scriptPath) :
+        parentEnv(parentEnv),
+        worker(worker),
+        scriptPath(scriptPath)
+    {
+
+    }
+
+    ~WorkerState() = default;
+
+    bool isTerminated() {
+        std::lock_guard<std::mutex> lockGuard(mutex);
+        return terminated;
+    }
+
+    void postToWorker(std::unique_ptr<SerializedData> message);
+
+    void postToParent(std::unique_ptr<SerializedData> message);
+
+    MessageQueue takeWorkerMessages();
+
+    MessageQueue takeParentMessages();
+
+    bool start(Environment* env);
+
+    void stop();
+
+    void exit();
+
+    void terminate();
+
+    void shutdown();
+
+    Environment* const parentEnv;
+    Worker* const worker;
+    const BString scriptPath;
+    WorkerGlobalScope* globalScope{nullptr};
+    std::thread thread;
+
+private:
+    void terminateLocked();
+
+    std::mutex mutex;
+    MessageQueue workerMessages;
+    MessageQueue parentMessages;
+    Environment* workerEnv{nullptr};
+    bool workerNotified{false};
+    bool parentNotified{false};
+    bool terminated{false};
+    bool detached{false};
+};
+
+class Worker : public EventTarget {
+public:
+    Worker(Environment* env, v8::Local<v8::Object> obj, const BString& scriptPath);
+
+    ~Worker() = default;
+
+    void postMessage(std::unique_ptr<SerializedData> message) {
+        state->postToWorker(std::move(message));
+    }
+
+    void terminate() {
+        state->terminate();
+    }
+
+    void receive();
+
+    void onExit();
+
+    std::shared_ptr<WorkerState> state;
+};
+
+class WorkerGlobalScope : public EventTarget {
+public:
+    WorkerGlobalScope(Environment* env, v8::Local<v8::Object> obj, WorkerState* state) :
+        EventTarget(env, obj, this),
+        state(state)
+    {
+        weakObject.ref();
+        state->globalScope = this;
+    }
+
+    ~WorkerGlobalScope() = default;
+
+    bool addEventListener(const BString& type, EventListener&& listener) override;
+
+    void onmessage(v8::Local<v8::Value> value);
+
+    void receive();
+
+    void close();
+
+    WorkerState* const state;
+    bool refed{false};
+    bool closed{false};
+
+private:
+    void ref();
+};
+
+void exposeWorker(v8::Local<v8::Context> context, ExposedScope exposedScope);
+
+void registerWorkerReferences(std::vector<intptr_t>& references);
+
+}
+
+#endif
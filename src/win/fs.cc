@@ -2,10 +2,13 @@
 
 #ifdef KUN_PLATFORM_WIN32
 
+#include <errno.h>
 #include <shlwapi.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <windows.h>
 
+#include <atomic>
 #include <vector>
 
 #include "util/scope_guard.h"
@@ -14,6 +17,29 @@
 #include "win/err.h"
 #include "win/utils.h"
 
+namespace {
+
+inline double toMillisecond(const FILETIME& fileTime) {
+    ULARGE_INTEGER value;
+    value.LowPart = fileTime.dwLowDateTime;
+    value.HighPart = fileTime.dwHighDateTime;
+    return static_cast<double>(value.QuadPart - 116444736000000000ULL) / 10000;
+}
+
+std::atomic<uint64_t> tempFileCount{0};
+
+inline kun::FileType toFileType(DWORD attrs) {
+    if (attrs & FILE_ATTRIBUTE_REPARSE_POINT) {
+        return kun::FileType::SYMLINK;
+    }
+    if (attrs & FILE_ATTRIBUTE_DIRECTORY) {
+        return kun::FileType::DIRECTORY;
+    }
+    return kun::FileType::FILE;
+}
+
+}
+
 namespace KUN_SYS {
 
 Result<BString> readFile(const BString& path) {
@@ -68,6 +94,127 @@ Result<BString> readFile(const BString& path) {
     return result;
 }
 
+Result<MappedFile> mapFile(const BString& path, size_t minMapSize) {
+    auto wpath = toWString(path).unwrap();
+    auto handle = ::CreateFileW(
+        wpath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (handle == INVALID_HANDLE_VALUE) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    ON_SCOPE_EXIT {
+        if (::CloseHandle(handle) == 0) {
+            auto errCode = convertError(::GetLastError());
+            KUN_LOG_ERR(errCode);
+        }
+    };
+    LARGE_INTEGER fileSize;
+    if (::GetFileSizeEx(handle, &fileSize) == 0) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    if (fileSize.QuadPart <= 0) {
+        return MappedFile();
+    }
+    auto len = static_cast<size_t>(fileSize.QuadPart);
+    if (len < minMapSize) {
+        auto buf = static_cast<char*>(::malloc(len));
+        if (buf == nullptr) {
+            return SysErr(ENOMEM);
+        }
+        DWORD nbytes = 0;
+        if (::ReadFile(handle, buf, static_cast<DWORD>(len), &nbytes, nullptr) == 0) {
+            auto errCode = convertError(::GetLastError());
+            ::free(buf);
+            return SysErr(errCode);
+        }
+        return MappedFile(buf, nbytes, false);
+    }
+    auto mapping = ::CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    ON_SCOPE_EXIT {
+        if (::CloseHandle(mapping) == 0) {
+            auto errCode = convertError(::GetLastError());
+            KUN_LOG_ERR(errCode);
+        }
+    };
+    auto addr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (addr == nullptr) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    return MappedFile(addr, len, true);
+}
+
+Result<bool> writeFile(const BString& path, const BString& content) {
+    auto wpath = toWString(path).unwrap();
+    auto handle = ::CreateFileW(
+        wpath.c_str(),
+        GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (handle == INVALID_HANDLE_VALUE) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    ON_SCOPE_EXIT {
+        if (::CloseHandle(handle) == 0) {
+            auto errCode = convertError(::GetLastError());
+            KUN_LOG_ERR(errCode);
+        }
+    };
+    const char* p = content.data();
+    auto end = p + content.length();
+    while (p < end) {
+        auto len = static_cast<DWORD>(end - p);
+        DWORD nbytes = 0;
+        if (::WriteFile(handle, p, len, &nbytes, nullptr) == 0) {
+            auto errCode = convertError(::GetLastError());
+            return SysErr(errCode);
+        }
+        if (nbytes == 0) {
+            return SysErr(SysErr::WRITE_ERROR);
+        }
+        p += nbytes;
+    }
+    return true;
+}
+
+Result<bool> replaceFile(const BString& path, const BString& content) {
+    auto tempPath = BString::format(
+        "{}.{}.{}.tmp",
+        path,
+        static_cast<uint64_t>(::GetCurrentProcessId()),
+        tempFileCount.fetch_add(1, std::memory_order_relaxed)
+    );
+    auto wtempPath = toWString(tempPath).unwrap();
+    if (auto result = writeFile(tempPath, content); !result) {
+        ::DeleteFileW(wtempPath.c_str());
+        return result.err();
+    }
+    auto wpath = toWString(path).unwrap();
+    if (::MoveFileExW(wtempPath.c_str(), wpath.c_str(), MOVEFILE_REPLACE_EXISTING) == 0) {
+        auto errCode = convertError(::GetLastError());
+        ::DeleteFileW(wtempPath.c_str());
+        return SysErr(errCode);
+    }
+    return true;
+}
+
 Result<bool> makeDirs(const BString& path) {
     auto wpath = toWString(path).unwrap();
     auto len = wpath.length();
@@ -105,7 +252,7 @@ Result<bool> removeDir(const BString& path) {
         auto errCode = convertError(::GetLastError());
         return SysErr(errCode);
     }
-    if (!(attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+    if (!(attrs & FILE_ATTRIBUTE_DIRECTORY) || (attrs & FILE_ATTRIBUTE_REPARSE_POINT)) {
         return SysErr(SysErr::NOT_DIRECTORY);
     }
     std::vector<WString> wdirs;
@@ -153,7 +300,16 @@ Result<bool> removeDir(const BString& path) {
             wfilePath += wdir;
             wfilePath += L"\\";
             wfilePath += wfilename;
-            if (findDataw.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            const auto fileAttrs = findDataw.dwFileAttributes;
+            if (
+                (fileAttrs & FILE_ATTRIBUTE_DIRECTORY) &&
+                (fileAttrs & FILE_ATTRIBUTE_REPARSE_POINT)
+            ) {
+                if (::RemoveDirectoryW(wfilePath.c_str()) == 0) {
+                    auto errCode = convertError(::GetLastError());
+                    return SysErr(errCode);
+                }
+            } else if (fileAttrs & FILE_ATTRIBUTE_DIRECTORY) {
                 wdirs.emplace_back(std::move(wfilePath));
             } else {
                 if (::DeleteFileW(wfilePath.c_str()) == 0) {
@@ -173,6 +329,107 @@ Result<bool> removeDir(const BString& path) {
     return true;
 }
 
+Result<FileStat> getFileStat(const BString& path) {
+    auto wpath = toWString(path).unwrap();
+    WIN32_FILE_ATTRIBUTE_DATA attrData;
+    if (::GetFileAttributesExW(wpath.c_str(), GetFileExInfoStandard, &attrData) == 0) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    ULARGE_INTEGER fileSize;
+    fileSize.LowPart = attrData.nFileSizeLow;
+    fileSize.HighPart = attrData.nFileSizeHigh;
+    FileStat fileStat;
+    fileStat.type = toFileType(attrData.dwFileAttributes);
+    fileStat.size = fileSize.QuadPart;
+    fileStat.mode = (attrData.dwFileAttributes & FILE_ATTRIBUTE_READONLY) ? 0444 : 0666;
+    fileStat.atime = toMillisecond(attrData.ftLastAccessTime);
+    fileStat.mtime = toMillisecond(attrData.ftLastWriteTime);
+    return fileStat;
+}
+
+Result<std::vector<DirEntry>> readDir(const BString& path) {
+    auto wpath = toWString(path).unwrap();
+    auto findPath = WString::format(L"{}\\*", wpath);
+    WIN32_FIND_DATAW findDataw;
+    auto handle = ::FindFirstFileW(findPath.c_str(), &findDataw);
+    if (handle == INVALID_HANDLE_VALUE) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    ON_SCOPE_EXIT {
+        if (::FindClose(handle) == 0) {
+            auto errCode = convertError(::GetLastError());
+            KUN_LOG_ERR(errCode);
+        }
+    };
+    std::vector<DirEntry> entries;
+    entries.reserve(64);
+    while (true) {
+        auto nameLen = wcslen(findDataw.cFileName);
+        auto wfilename = WString::view(findDataw.cFileName, nameLen);
+        if (wfilename != L"." && wfilename != L"..") {
+            auto name = toBString(wfilename).unwrap();
+            entries.emplace_back(std::move(name), toFileType(findDataw.dwFileAttributes));
+        }
+        if (::FindNextFileW(handle, &findDataw) == 0) {
+            auto lastErr = ::GetLastError();
+            if (lastErr == ERROR_NO_MORE_FILES) {
+                break;
+            }
+            auto errCode = convertError(lastErr);
+            return SysErr(errCode);
+        }
+    }
+    return entries;
+}
+
+Result<bool> makeDir(const BString& path) {
+    auto wpath = toWString(path).unwrap();
+    if (::CreateDirectoryW(wpath.c_str(), nullptr) == 0) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    return true;
+}
+
+Result<bool> removePath(const BString& path) {
+    auto wpath = toWString(path).unwrap();
+    auto attrs = ::GetFileAttributesW(wpath.c_str());
+    if (attrs == INVALID_FILE_ATTRIBUTES) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    BOOL success = FALSE;
+    if (attrs & FILE_ATTRIBUTE_DIRECTORY) {
+        success = ::RemoveDirectoryW(wpath.c_str());
+    } else {
+        success = ::DeleteFileW(wpath.c_str());
+    }
+    if (success == 0) {
+        auto errCode = convertError(::GetLastError());
+        return SysErr(errCode);
+    }
+    return true;
+}
+
+}
+
+namespace kun {
+
+void MappedFile::reset() {
+    if (addr != nullptr) {
+        if (!mapped) {
+            ::free(addr);
+        } else if (::UnmapViewOfFile(addr) == 0) {
+            auto errCode = win::convertError(::GetLastError());
+            KUN_LOG_ERR(errCode);
+        }
+    }
+    addr = nullptr;
+    length = 0;
+}
+
 }
 
 #endif
@@ -5,17 +5,34 @@
 
 #ifdef KUN_PLATFORM_WIN32
 
+#include <vector>
+
 #include "util/bstring.h"
+#include "util/file_info.h"
 #include "util/result.h"
 
 namespace KUN_SYS {
 
 Result<BString> readFile(const BString& path);
 
+Result<MappedFile> mapFile(const BString& path, size_t minMapSize);
+
+Result<bool> writeFile(const BString& path, const BString& content);
+
+Result<bool> replaceFile(const BString& path, const BString& content);
+
 Result<bool> makeDirs(const BString& path);
 
 Result<bool> removeDir(const BString& path);
 
+Result<FileStat> getFileStat(const BString& path);
+
+Result<std::vector<DirEntry>> readDir(const BString& path);
+
+Result<bool> makeDir(const BString& path);
+
+Result<bool> removePath(const BString& path);
+
 }
 
 #endif
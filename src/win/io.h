@@ -8,34 +8,46 @@
 #include <stddef.h>
 #include <windows.h>
 
+#include <utility>
+
 #include "util/bstring.h"
 #include "util/result.h"
 #include "win/err.h"
 
 namespace KUN_SYS {
 
-template<int N, typename... TS>
-inline void fprint(const BString& fmt, TS&&... args) {
+template<int N>
+inline void writeStdio(
+    const char* head,
+    size_t headLength,
+    const char* tail = nullptr,
+    size_t tailLength = 0
+) {
     static_assert(N == 1 || N == 2);
-    BString str;
-    if constexpr (sizeof...(args) == 0) {
-        str = BString::view(fmt);
-    } else {
-        str = BString::format(fmt, std::forward<TS>(args)...);
-    }
     constexpr auto n = N == 1 ? STD_OUTPUT_HANDLE : STD_ERROR_HANDLE;
     auto handle = ::GetStdHandle(n);
-    const char* p = str.data();
-    auto end = p + str.length();
-    DWORD nbytes = 0;
-    while (p < end) {
-        auto len = static_cast<DWORD>(end - p);
-        ::WriteFile(handle, p, len, &nbytes, nullptr);
-        p += nbytes;
-        nbytes = 0;
+    for (auto [p, len] : {std::make_pair(head, headLength), std::make_pair(tail, tailLength)}) {
+        auto end = p + len;
+        DWORD nbytes = 0;
+        while (p < end) {
+            auto remaining = static_cast<DWORD>(end - p);
+            if (!::WriteFile(handle, p, remaining, &nbytes, nullptr)) {
+                break;
+            }
+            p += nbytes;
+            nbytes = 0;
+        }
     }
 }
 
+template<int N>
+inline bool isStdioTerminal() {
+    static_assert(N == 1 || N == 2);
+    constexpr auto n = N == 1 ? STD_OUTPUT_HANDLE : STD_ERROR_HANDLE;
+    DWORD mode = 0;
+    return ::GetConsoleMode(::GetStdHandle(n), &mode) != 0;
+}
+
 inline Result<bool> setNonblocking(SOCKET sock) {
     u_long flag = 1;
     if (::ioctlsocket(sock, FIONBIO, &flag) == 0) {
@@ -10,7 +10,7 @@
 #include "win/err.h"
 
 using kun::SysErr;
-using kun::sys::microsecond;
+using kun::sys::millisecond;
 using kun::win::convertError;
 
 namespace {
@@ -76,11 +76,7 @@ private:
 
 namespace kun {
 
-EventLoop::EventLoop(Environment* env) :
-    env(env),
-    asyncHandler(env),
-    usecTimers(1024)
-{
+EventLoop::EventLoop(Environment* env) : env(env), asyncHandler(env) {
     fdChannelMap.reserve(1024);
     if (!addChannel(&asyncHandler)) {
         KUN_LOG_ERR("Failed to add AsyncHandler");
@@ -88,7 +84,7 @@ EventLoop::EventLoop(Environment* env) :
 }
 
 void EventLoop::run() {
-    if (fdChannelMap.size() <= 1 && usecTimers.empty()) {
+    if (fdChannelMap.size() <= 1 && timerWheel.empty() && refCount == 0) {
         return;
     }
     FdsWrap readFdsWrap(1024);
@@ -107,16 +103,12 @@ void EventLoop::run() {
         }
         auto readfds = readFdsWrap.data();
         auto writefds = writeFdsWrap.data();
+        env->flushOutput();
         struct timeval* timeout = nullptr;
-        if (!usecTimers.empty()) {
-            auto currTime = microsecond().unwrap();
-            auto data = usecTimers.peek();
-            uint64_t us = 0;
-            if (data.num >= currTime) {
-                us = data.num - currTime;
-            }
-            tv.tv_sec = static_cast<long>(us / 1000000);
-            tv.tv_usec = static_cast<long>(us - tv.tv_sec * 1000000);
+        auto ms = timerWheel.nextTimeout(millisecond().unwrap());
+        if (ms != -1) {
+            tv.tv_sec = static_cast<long>(ms / 1000);
+            tv.tv_usec = static_cast<long>((ms - tv.tv_sec * 1000) * 1000);
             timeout = &tv;
         }
         nfds = ::select(0, readfds, writefds, nullptr, timeout);
@@ -150,24 +142,10 @@ void EventLoop::run() {
                 }
             }
         }
-        if (timeout != nullptr) {
-            auto currTime = microsecond().unwrap();
-            while (!usecTimers.empty()) {
-                auto [timer, usec] = usecTimers.peek();
-                if (usec > currTime) {
-                    break;
-                }
-                usecTimers.pop();
-                if (!timer->removed) {
-                    timer->onReadable();
-                    if (timer->repeat) {
-                        auto value = timer->getValue(TimeUnit::MICROSECOND);
-                        usecTimers.push(timer, currTime + value);
-                    }
-                }
-            }
+        if (!timerWheel.empty()) {
+            timerWheel.expire(millisecond().unwrap());
         }
-        if (fdChannelMap.size() <= 1 && usecTimers.empty()) {
+        if (stopped || (fdChannelMap.size() <= 1 && timerWheel.empty() && refCount == 0)) {
             if (asyncHandler.tryClose()) {
                 break;
             }
@@ -178,9 +156,7 @@ void EventLoop::run() {
 bool EventLoop::addChannel(Channel* channel) {
     if (channel->type == ChannelType::TIMER) {
         auto timer = static_cast<Timer*>(channel);
-        auto currTime = microsecond().unwrap();
-        auto value = timer->getValue(TimeUnit::MICROSECOND);
-        usecTimers.push(timer, currTime + value);
+        timerWheel.add(timer, millisecond().unwrap());
         return true;
     }
     if (channel->fd == KUN_INVALID_FD) {
@@ -198,7 +174,7 @@ bool EventLoop::modifyChannel(Channel* channel) {
 bool EventLoop::removeChannel(Channel* channel) {
     if (channel->type == ChannelType::TIMER) {
         auto timer = static_cast<Timer*>(channel);
-        timer->removed = true;
+        timerWheel.remove(timer);
         return true;
     }
     if (channel->fd == KUN_INVALID_FD) {
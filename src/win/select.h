@@ -15,9 +15,9 @@
 #include "loop/async_handler.h"
 #include "loop/channel.h"
 #include "loop/timer.h"
+#include "loop/timer_wheel.h"
 #include "sys/io.h"
 #include "sys/time.h"
-#include "util/min_heap.h"
 
 namespace kun {
 
@@ -47,10 +47,38 @@ public:
         asyncHandler.submit(std::move(req));
     }
 
+    void postAsyncRequest(AsyncRequest&& req) {
+        asyncHandler.post(std::move(req));
+    }
+
+    void runAsyncRequests() {
+        asyncHandler.runResolvedRequests();
+    }
+
+    void waitAsyncRequests() {
+        asyncHandler.waitResolvedRequests();
+    }
+
+    void ref() {
+        ++refCount;
+    }
+
+    void unref() {
+        if (refCount > 0) {
+            --refCount;
+        }
+    }
+
+    void stop() {
+        stopped = true;
+    }
+
 private:
     Environment* env;
     AsyncHandler asyncHandler;
-    MinHeap<Timer, uint64_t> usecTimers;
+    TimerWheel timerWheel;
+    uint32_t refCount{0};
+    bool stopped{false};
     std::unordered_map<SOCKET, Channel*> fdChannelMap;
 };
 
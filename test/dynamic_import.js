@@ -0,0 +1,45 @@
+const FUNCTION_COUNT = 300000;
+
+function generateModule() {
+    const parts = [`export const token = ${Date.now()};\n`];
+    for (let i = 0; i < FUNCTION_COUNT; i++) {
+        parts.push(`export function f${i}(a, b) { return a * ${i} + b - ${i % 97}; }\n`);
+    }
+    parts.push(`export const count = ${FUNCTION_COUNT};\n`);
+    return parts.join('');
+}
+
+(async () => {
+    const url = await import.meta.resolve('./generated/large_module.js');
+    const path = url.slice('file://'.length);
+    const dir = path.slice(0, path.lastIndexOf('/'));
+    await Kun.fs.mkdir(dir).catch(() => {});
+    await Kun.fs.writeFile(path, generateModule());
+    let ticks = 0;
+    let maxGap = 0;
+    let last = Date.now();
+    const timer = setInterval(() => {
+        const now = Date.now();
+        maxGap = Math.max(maxGap, now - last);
+        last = now;
+        ticks++;
+    }, 1);
+    const start = Date.now();
+    let mod;
+    try {
+        mod = await import('./generated/large_module.js');
+    } finally {
+        clearInterval(timer);
+        await Kun.fs.remove(path);
+        await Kun.fs.remove(dir).catch(() => {});
+    }
+    const elapsed = Date.now() - start;
+    if (mod.count !== FUNCTION_COUNT || mod.f10(2, 3) !== 2 * 10 + 3 - 10) {
+        throw new Error('the generated module did not evaluate');
+    }
+    if (ticks < 2) {
+        throw new Error(`only ${ticks} timer callbacks ran during a ${elapsed}ms import`);
+    }
+    console.log(`import took ${elapsed}ms, ${ticks} timer callbacks, max gap ${maxGap}ms`);
+    console.log('PASS');
+})();
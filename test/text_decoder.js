@@ -0,0 +1,44 @@
+function assertEqual(actual, expected, label) {
+    if (actual !== expected) {
+        throw new Error(`${label}: expected ${JSON.stringify(expected)}, got ${JSON.stringify(actual)}`);
+    }
+}
+
+function bytes(...values) {
+    return new Uint8Array(values);
+}
+
+function decodeChunks(chunks) {
+    const decoder = new TextDecoder();
+    let result = '';
+    for (const chunk of chunks) {
+        result += decoder.decode(chunk, { stream: true });
+    }
+    return result + decoder.decode();
+}
+
+const decoder = new TextDecoder();
+assertEqual(decoder.decode(bytes(0x80, 0x61, 0x62, 0x63)), '\uFFFDabc', 'leading continuation byte');
+assertEqual(decoder.decode(bytes(0x78, 0xff, 0x79, 0x7a)), 'x\uFFFDyz', '0xff lead byte');
+assertEqual(decoder.decode(bytes(0xc0, 0xaf)), '\uFFFD\uFFFD', '0xc0 lead byte');
+assertEqual(decoder.decode(bytes(0xc1, 0x61)), '\uFFFDa', '0xc1 lead byte');
+assertEqual(decoder.decode(bytes(0xf5, 0x80, 0x80, 0x80)), '\uFFFD\uFFFD\uFFFD\uFFFD', '0xf5 lead byte');
+assertEqual(decoder.decode(bytes(0x61, 0xfe, 0xff)), 'a\uFFFD\uFFFD', 'trailing invalid lead bytes');
+assertEqual(decoder.decode(bytes(0x61, 0xe2, 0x82)), 'a\uFFFD', 'truncated sequence at the end');
+assertEqual(decoder.decode(bytes(0xe2, 0x82, 0xac)), '\u20AC', 'three byte sequence');
+
+assertEqual(decodeChunks([bytes(0x80), bytes(0x61, 0x62)]), '\uFFFDab', 'stream: leading continuation byte');
+assertEqual(decodeChunks([bytes(0x61, 0xff), bytes(0x62)]), 'a\uFFFDb', 'stream: invalid lead at chunk end');
+assertEqual(decodeChunks([bytes(0xff), bytes(0xff), bytes(0x63)]), '\uFFFD\uFFFDc', 'stream: invalid lead chunks');
+assertEqual(decodeChunks([bytes(0xe2), bytes(0x82), bytes(0xac, 0x80)]), '\u20AC\uFFFD', 'stream: split sequence');
+assertEqual(decodeChunks([bytes(0x61, 0xf0, 0x9f)]), 'a\uFFFD', 'stream: truncated sequence at the end');
+
+let thrown = false;
+try {
+    new TextDecoder('utf-8', { fatal: true }).decode(bytes(0x61, 0x80));
+} catch (e) {
+    thrown = e instanceof TypeError;
+}
+assertEqual(thrown, true, 'fatal mode rejects an invalid lead byte');
+
+console.log('PASS');
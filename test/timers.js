@@ -0,0 +1,45 @@
+function assertOrder(actual, expected, label) {
+    if (actual.join(',') !== expected.join(',')) {
+        throw new Error(`${label}: expected [${expected}], got [${actual}]`);
+    }
+}
+
+const zeroDelay = [];
+const sameDelay = [];
+const expected = [];
+for (let i = 0; i < 16; i++) {
+    setTimeout(() => zeroDelay.push(i), 0);
+    setTimeout(() => sameDelay.push(i), 5);
+    expected.push(i);
+}
+
+const nested = [];
+setTimeout(() => {
+    for (let i = 0; i < 16; i++) {
+        setTimeout(() => nested.push(i), 0);
+    }
+}, 1);
+
+const cleared = [];
+const handles = [];
+for (let i = 0; i < 8; i++) {
+    handles.push(setTimeout(() => cleared.push(i), 3));
+}
+clearTimeout(handles[0]);
+clearTimeout(handles[3]);
+clearTimeout(handles[7]);
+
+const later = [];
+setTimeout(() => later.push('a'), 300);
+setTimeout(() => {
+    setTimeout(() => later.push('b'), 100);
+}, 200);
+
+setTimeout(() => {
+    assertOrder(zeroDelay, expected, 'setTimeout(f, 0)');
+    assertOrder(sameDelay, expected, 'setTimeout(f, 5)');
+    assertOrder(nested, expected, 'nested setTimeout(f, 0)');
+    assertOrder(cleared, [1, 2, 4, 5, 6], 'clearTimeout');
+    assertOrder(later, ['a', 'b'], 'same deadline across wheel levels');
+    console.log('PASS');
+}, 500);
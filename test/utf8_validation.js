@@ -0,0 +1,67 @@
+function assertEqual(actual, expected, label) {
+    if (actual !== expected) {
+        throw new Error(`${label}: expected ${JSON.stringify(expected)}, got ${JSON.stringify(actual)}`);
+    }
+}
+
+function withPrefix(prefixLength, values) {
+    const arr = new Uint8Array(prefixLength + values.length);
+    arr.fill(0x61, 0, prefixLength);
+    arr.set(values, prefixLength);
+    return arr;
+}
+
+function throwsFatal(input) {
+    try {
+        new TextDecoder('utf-8', { fatal: true }).decode(input);
+    } catch (e) {
+        return e instanceof TypeError;
+    }
+    return false;
+}
+
+const valid = [
+    [[0x7f], '\u007F', 'U+007F'],
+    [[0xc2, 0x80], '\u0080', 'U+0080'],
+    [[0xdf, 0xbf], '\u07FF', 'U+07FF'],
+    [[0xe0, 0xa0, 0x80], '\u0800', 'U+0800'],
+    [[0xed, 0x9f, 0xbf], '\uD7FF', 'U+D7FF'],
+    [[0xee, 0x80, 0x80], '\uE000', 'U+E000'],
+    [[0xef, 0xbf, 0xbf], '\uFFFF', 'U+FFFF'],
+    [[0xf0, 0x90, 0x80, 0x80], '\u{10000}', 'U+10000'],
+    [[0xf4, 0x8f, 0xbf, 0xbf], '\u{10FFFF}', 'U+10FFFF']
+];
+
+const invalid = [
+    [[0xc0, 0x80], '\uFFFD\uFFFD', 'overlong U+0000 in two bytes'],
+    [[0xc1, 0xbf], '\uFFFD\uFFFD', 'overlong U+007F in two bytes'],
+    [[0xe0, 0x80, 0x80], '\uFFFD\uFFFD\uFFFD', 'overlong U+0000 in three bytes'],
+    [[0xe0, 0x9f, 0xbf], '\uFFFD\uFFFD\uFFFD', 'overlong U+07FF in three bytes'],
+    [[0xf0, 0x80, 0x80, 0x80], '\uFFFD\uFFFD\uFFFD\uFFFD', 'overlong U+0000 in four bytes'],
+    [[0xf0, 0x8f, 0xbf, 0xbf], '\uFFFD\uFFFD\uFFFD\uFFFD', 'overlong U+FFFF in four bytes'],
+    [[0xed, 0xa0, 0x80], '\uFFFD\uFFFD\uFFFD', 'high surrogate U+D800'],
+    [[0xed, 0xbf, 0xbf], '\uFFFD\uFFFD\uFFFD', 'low surrogate U+DFFF'],
+    [[0xed, 0xa0, 0xbd, 0xed, 0xb8, 0x80], '\uFFFD'.repeat(6), 'encoded surrogate pair'],
+    [[0xf4, 0x90, 0x80, 0x80], '\uFFFD\uFFFD\uFFFD\uFFFD', 'U+110000'],
+    [[0xf7, 0xbf, 0xbf, 0xbf], '\uFFFD\uFFFD\uFFFD\uFFFD', 'U+1FFFFF'],
+    [[0xf8, 0x88, 0x80, 0x80, 0x80], '\uFFFD'.repeat(5), 'five byte form']
+];
+
+const decoder = new TextDecoder();
+for (const prefixLength of [0, 15, 31, 64]) {
+    const prefix = 'a'.repeat(prefixLength);
+    for (const [values, expected, label] of valid) {
+        const input = withPrefix(prefixLength, values.concat([0x62]));
+        const name = `${label} after ${prefixLength} ASCII bytes`;
+        assertEqual(decoder.decode(input), `${prefix}${expected}b`, name);
+        assertEqual(throwsFatal(input), false, `fatal: ${name}`);
+    }
+    for (const [values, expected, label] of invalid) {
+        const input = withPrefix(prefixLength, values.concat([0x62]));
+        const name = `${label} after ${prefixLength} ASCII bytes`;
+        assertEqual(decoder.decode(input), `${prefix}${expected}b`, name);
+        assertEqual(throwsFatal(input), true, `fatal: ${name}`);
+    }
+}
+
+console.log('PASS');